@@ -0,0 +1,208 @@
+/**
+ * @file priority_inversion_benchmark.c
+ * @brief Low/medium/high tasks contending for one resource: worst-case blocking of the high task per primitive.
+ *
+ * The Day 5 examples use priorities without a shared resource. Here three
+ * tasks on BENCH_CORE share one guarded_resource_t:
+ *   low    (prio 2) : takes the resource, "works" HOLD_US inside it, releases,
+ *                     sleeps one tick, and repeats
+ *   high   (prio 5) : woken every RELEASE_PERIOD_US, takes the resource for
+ *                     a short HIGH_WORK_US
+ *   medium (prio 3) : woken together with high, busy for MEDIUM_BUSY_US and
+ *                     never touches the resource
+ * The wake-up comes from an esp_timer on the other core, which stamps the
+ * release time. The high task's blocking time is measured from that stamp
+ * to the moment it owns the resource.
+ *
+ * The scenario runs PHASE_MS for each primitive in turn:
+ *   binsem   : medium preempts low while high waits. Blocking reaches
+ *              about HOLD_US + MEDIUM_BUSY_US (priority inversion).
+ *   mutex    : low inherits high's priority, medium cannot preempt it.
+ *              Blocking stays below about HOLD_US.
+ *   spinlock : low cannot be preempted at all. Blocking stays below about
+ *              HOLD_US too, but interrupts on BENCH_CORE are masked for
+ *              the whole hold, and the advice line flags it.
+ * Output per phase, then a summary (figures illustrate the expected shape):
+ *   [PINV] binsem   high blocked avg 2710 max 6040 us (250 releases)
+ *   [GUARD] res(binsem) n=1905 contended=180 ... | long=0
+ *   [GUARD] res: binary semaphore used as a lock: no priority inheritance, use a mutex
+ *   ...
+ *   [PINV] worst-case blocking: binsem 6040 us, mutex 1030 us, spinlock 1012 us
+ *
+ * Files needed in your project's main/ folder:
+ *   - priority_inversion_benchmark.c (this file)
+ *   - components/guarded_resource/guarded_resource.c and guarded_resource.h
+ *
+ * Target Platform: dual-core ESP32 with ESP-IDF v5.x
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "esp_log.h"
+#include "guarded_resource.h"
+
+#define TAG "DAY13"
+
+#define BENCH_CORE          1
+#define LOW_PRIORITY        2
+#define MEDIUM_PRIORITY     3
+#define HIGH_PRIORITY       5
+#define HOLD_US             1000    // Low task's time inside the resource
+#define HIGH_WORK_US        50
+#define MEDIUM_BUSY_US      5000
+#define RELEASE_PERIOD_US   20000
+#define PHASE_MS            5000
+#define WARN_HOLD_US        500     // Holds above this are flagged as long
+
+static guarded_resource_t s_res;
+static volatile bool s_running;
+static int64_t s_release_us;       // 64 bits: read and written under s_release_mux
+static portMUX_TYPE s_release_mux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_controller, s_high, s_medium;
+
+static uint32_t s_high_runs;
+static uint64_t s_high_block_sum;
+static uint32_t s_high_block_max;
+
+// ------------------------ Tasks ------------------------
+
+/**
+ * @brief Low priority: holds the resource most of the time.
+ *
+ * @param pv Unused.
+ */
+static void low_task(void *pv)
+{
+    while (s_running) {
+        guarded_resource_lock(&s_res, portMAX_DELAY);
+        esp_rom_delay_us(HOLD_US);
+        guarded_resource_unlock(&s_res);
+        vTaskDelay(1);
+    }
+    xTaskNotifyGive(s_controller);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Medium priority: CPU hog that ignores the resource.
+ *
+ * @param pv Unused.
+ */
+static void medium_task(void *pv)
+{
+    while (s_running) {
+        if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100)) && s_running) {
+            esp_rom_delay_us(MEDIUM_BUSY_US);
+        }
+    }
+    xTaskNotifyGive(s_controller);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief High priority: measures release-to-ownership time.
+ *
+ * @param pv Unused.
+ */
+static void high_task(void *pv)
+{
+    while (s_running) {
+        if (!ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100)) || !s_running) {
+            continue;
+        }
+        portENTER_CRITICAL(&s_release_mux);
+        int64_t released = s_release_us;
+        portEXIT_CRITICAL(&s_release_mux);
+        guarded_resource_lock(&s_res, portMAX_DELAY);
+        uint32_t blocked = (uint32_t)(esp_timer_get_time() - released);
+        esp_rom_delay_us(HIGH_WORK_US);
+        guarded_resource_unlock(&s_res);
+
+        s_high_runs++;
+        s_high_block_sum += blocked;
+        if (blocked > s_high_block_max) {
+            s_high_block_max = blocked;
+        }
+    }
+    xTaskNotifyGive(s_controller);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief esp_timer callback: stamp the release and wake high, then medium.
+ */
+static void release_cb(void *arg)
+{
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_release_mux);
+    s_release_us = now;
+    portEXIT_CRITICAL(&s_release_mux);
+    xTaskNotifyGive(s_high);
+    xTaskNotifyGive(s_medium);
+}
+
+// ------------------------ Benchmark ------------------------
+
+/**
+ * @brief Run the three-task scenario for PHASE_MS with one primitive.
+ *
+ * @return Worst-case blocking of the high task, µs.
+ */
+static uint32_t run_phase(guarded_resource_kind_t kind, const char *label, esp_timer_handle_t timer)
+{
+    ESP_ERROR_CHECK(guarded_resource_init(&s_res, "res", kind, WARN_HOLD_US));
+    s_high_runs = 0;
+    s_high_block_sum = 0;
+    s_high_block_max = 0;
+    s_running = true;
+
+    xTaskCreatePinnedToCore(low_task, "low", 2048, NULL, LOW_PRIORITY, NULL, BENCH_CORE);
+    xTaskCreatePinnedToCore(medium_task, "medium", 2048, NULL, MEDIUM_PRIORITY, &s_medium, BENCH_CORE);
+    xTaskCreatePinnedToCore(high_task, "high", 2048, NULL, HIGH_PRIORITY, &s_high, BENCH_CORE);
+    ESP_ERROR_CHECK(esp_timer_start_periodic(timer, RELEASE_PERIOD_US));
+
+    vTaskDelay(pdMS_TO_TICKS(PHASE_MS));
+
+    ESP_ERROR_CHECK(esp_timer_stop(timer));
+    s_running = false;
+    for (int exited = 0; exited < 3; exited++) {
+        ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    }
+
+    printf("[PINV] %-8s high blocked avg %" PRIu32 " max %" PRIu32 " us (%" PRIu32 " releases)\n",
+           label, s_high_runs ? (uint32_t)(s_high_block_sum / s_high_runs) : 0,
+           s_high_block_max, s_high_runs);
+    guarded_resource_report(&s_res);
+    guarded_resource_deinit(&s_res);
+    return s_high_block_max;
+}
+
+/**
+ * @brief Runs the scenario with each primitive and prints the comparison.
+ */
+void app_main(void)
+{
+    s_controller = xTaskGetCurrentTaskHandle();
+
+    esp_timer_handle_t timer;
+    const esp_timer_create_args_t args = {
+        .callback = release_cb,
+        .name = "release",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&args, &timer));
+
+    ESP_LOGI(TAG, "low holds %d us, medium busy %d us, release every %d us, core %d",
+             HOLD_US, MEDIUM_BUSY_US, RELEASE_PERIOD_US, BENCH_CORE);
+
+    uint32_t binsem = run_phase(GUARDED_BINARY_SEM, "binsem", timer);
+    uint32_t mutex = run_phase(GUARDED_MUTEX, "mutex", timer);
+    uint32_t spin = run_phase(GUARDED_SPINLOCK, "spinlock", timer);
+
+    printf("[PINV] worst-case blocking: binsem %" PRIu32 " us, mutex %" PRIu32 " us, spinlock %" PRIu32 " us\n",
+           binsem, mutex, spin);
+}
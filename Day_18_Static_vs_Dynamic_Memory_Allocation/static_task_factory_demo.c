@@ -0,0 +1,253 @@
+/**
+ * @file static_task_factory_demo.c
+ * @brief Static vs dynamic task creation: boot time, free heap and stack headroom.
+ *
+ * The same five-task application is started in one of two ways:
+ *   USE_STATIC_TASKS = 1 : task_factory_start() on a table of
+ *                          xTaskCreateStaticPinnedToCore() entries. Stacks
+ *                          and TCBs are .bss arrays placed by the linker, and
+ *                          the logger stack goes to PSRAM when it is enabled.
+ *   USE_STATIC_TASKS = 0 : xTaskCreatePinnedToCore() with the same names,
+ *                          sizes, priorities and cores (heap allocation).
+ *
+ * app_main prints:
+ *   - time spent creating the tasks (esp_timer_get_time())
+ *   - free heap, minimum-ever free heap and the largest free internal block
+ *     before and after creation
+ * monitor_task then prints the same heap figures plus the stack report
+ * every MONITOR_PERIOD_MS. A churn task allocates and frees random-sized
+ * buffers the whole time, as a long-running application does. You can watch
+ * the largest free block shrink while the task stacks sit in the heap
+ * (dynamic) or outside it (static).
+ *
+ * Use the "Free%" column of the stack report to shrink each *_STACK value.
+ * Keep roughly 20% headroom over the measured worst case. With
+ * STACK_PROFILE = 1 the stack_profiler also runs and prints a ready-made
+ * stack_profile.h. Copy it into main/ and the next build picks up the
+ * STACK_PROFILE_<NAME> depths automatically.
+ *
+ * Files needed in your project's main/ folder:
+ *   - static_task_factory_demo.c (this file)
+ *   - components/task_factory/task_factory.c and task_factory.h
+ *   - components/stack_profiler/stack_profiler.c and stack_profiler.h (STACK_PROFILE = 1)
+ *   - stack_profile.h (optional, generated by stack_profiler)
+ *
+ * Target Platform: ESP32 (PSRAM optional) with ESP-IDF v5.x
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "task_factory.h"
+
+#ifndef STACK_PROFILE
+#define STACK_PROFILE       0       // 1: run stack_profiler alongside the tasks
+#endif
+
+#if STACK_PROFILE
+#include "stack_profiler.h"
+#endif
+
+#if __has_include("stack_profile.h")
+#include "stack_profile.h"              // Measured depths from a previous soak run
+#endif
+
+#define TAG                 "STATIC_DEMO"
+
+#ifndef USE_STATIC_TASKS
+#define USE_STATIC_TASKS    1       // 1: task_factory (static), 0: xTaskCreate (heap)
+#endif
+
+// Defaults until a stack_profile.h exists
+#ifndef STACK_PROFILE_SENSOR
+#define STACK_PROFILE_SENSOR    2048
+#endif
+#ifndef STACK_PROFILE_CONTROL
+#define STACK_PROFILE_CONTROL   2048
+#endif
+#ifndef STACK_PROFILE_LOGGER
+#define STACK_PROFILE_LOGGER    4096
+#endif
+#ifndef STACK_PROFILE_CHURN
+#define STACK_PROFILE_CHURN     2048
+#endif
+#ifndef STACK_PROFILE_MONITOR
+#define STACK_PROFILE_MONITOR   4096
+#endif
+
+#define SENSOR_STACK        STACK_PROFILE_SENSOR
+#define CONTROL_STACK       STACK_PROFILE_CONTROL
+#define LOGGER_STACK        STACK_PROFILE_LOGGER
+#define CHURN_STACK         STACK_PROFILE_CHURN
+#define MONITOR_STACK       STACK_PROFILE_MONITOR
+#define MONITOR_PERIOD_MS   10000
+#define CHURN_SLOTS         8
+
+// ------------------------ Application Tasks ------------------------
+
+static volatile int32_t s_sensor_value;
+
+/**
+ * @brief 100 Hz simulated sensor.
+ *
+ * @param arg Unused.
+ */
+static void sensor_task(void *arg)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    while (1) {
+        s_sensor_value = (int32_t)(esp_timer_get_time() / 1000 % 1000);
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(10));
+    }
+}
+
+/**
+ * @brief 50 Hz control loop on the sensor value.
+ *
+ * @param arg Unused.
+ */
+static void control_task(void *arg)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    float y = 0.0f;
+    while (1) {
+        y += 0.2f * ((float)s_sensor_value - y);
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(20));
+    }
+}
+
+/**
+ * @brief Slow logger; printf with floats is the stack-hungry path.
+ *
+ * @param arg Unused.
+ */
+static void logger_task(void *arg)
+{
+    while (1) {
+        printf("[logger] sensor=%" PRId32 " (%.1f%%)\n", s_sensor_value, s_sensor_value / 10.0);
+        vTaskDelay(pdMS_TO_TICKS(2000));
+    }
+}
+
+/**
+ * @brief Allocates and frees random-sized blocks to age the heap.
+ *
+ * @param arg Unused.
+ */
+static void churn_task(void *arg)
+{
+    void *slots[CHURN_SLOTS] = { 0 };
+    while (1) {
+        int i = rand() % CHURN_SLOTS;
+        free(slots[i]);
+        slots[i] = malloc(64 + rand() % 2048);
+        vTaskDelay(pdMS_TO_TICKS(50));
+    }
+}
+
+static void monitor_task(void *arg);
+
+// ------------------------ Task Table ------------------------
+
+static TaskHandle_t s_sensor_h, s_control_h, s_logger_h, s_churn_h, s_monitor_h;
+
+#if USE_STATIC_TASKS
+TASK_FACTORY_STACK(sensor, SENSOR_STACK);
+TASK_FACTORY_STACK(control, CONTROL_STACK);
+TASK_FACTORY_STACK_EXT(logger, LOGGER_STACK);      // PSRAM if enabled; never touches flash
+TASK_FACTORY_STACK(churn, CHURN_STACK);
+TASK_FACTORY_STACK(monitor, MONITOR_STACK);
+
+static const task_factory_entry_t s_tasks[] = {
+    TASK_FACTORY_ENTRY(sensor,  sensor_task,  "sensor",  NULL, 6, 1, &s_sensor_h),
+    TASK_FACTORY_ENTRY(control, control_task, "control", NULL, 5, 1, &s_control_h),
+    TASK_FACTORY_ENTRY(logger,  logger_task,  "logger",  NULL, 2, 0, &s_logger_h),
+    TASK_FACTORY_ENTRY(churn,   churn_task,   "churn",   NULL, 3, 0, &s_churn_h),
+    TASK_FACTORY_ENTRY(monitor, monitor_task, "monitor", NULL, 1, 0, &s_monitor_h),
+};
+#else
+// Same rows without storage: only fn/name/prio/core/size/handle are used
+static const task_factory_entry_t s_tasks[] = {
+    { .fn = sensor_task,  .name = "sensor",  .priority = 6, .core = 1, .stack_size = SENSOR_STACK,  .handle = &s_sensor_h },
+    { .fn = control_task, .name = "control", .priority = 5, .core = 1, .stack_size = CONTROL_STACK, .handle = &s_control_h },
+    { .fn = logger_task,  .name = "logger",  .priority = 2, .core = 0, .stack_size = LOGGER_STACK,  .handle = &s_logger_h },
+    { .fn = churn_task,   .name = "churn",   .priority = 3, .core = 0, .stack_size = CHURN_STACK,   .handle = &s_churn_h },
+    { .fn = monitor_task, .name = "monitor", .priority = 1, .core = 0, .stack_size = MONITOR_STACK, .handle = &s_monitor_h },
+};
+#endif
+
+// ------------------------ Reporting ------------------------
+
+/**
+ * @brief Print free heap, minimum-ever free heap and largest free internal block.
+ */
+static void print_heap(const char *label)
+{
+    printf("[heap] %-14s free=%" PRIu32 " min_free=%" PRIu32 " largest_internal=%u\n",
+           label, esp_get_free_heap_size(), esp_get_minimum_free_heap_size(),
+           (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL));
+}
+
+/**
+ * @brief Periodic heap + stack headroom report.
+ *
+ * @param arg Unused.
+ */
+static void monitor_task(void *arg)
+{
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(MONITOR_PERIOD_MS));
+        print_heap("running");
+        task_factory_report(s_tasks, TASK_FACTORY_COUNT(s_tasks));
+    }
+}
+
+// ------------------------ Entry Point ------------------------
+
+/**
+ * @brief Application entry point: create the table in the selected mode and time it.
+ */
+void app_main(void)
+{
+    print_heap("before tasks");
+
+    // Run above every new task so their first iterations are not timed as creation cost
+    UBaseType_t prio = uxTaskPriorityGet(NULL);
+    vTaskPrioritySet(NULL, configMAX_PRIORITIES - 1);
+
+    int64_t t0 = esp_timer_get_time();
+#if USE_STATIC_TASKS
+    esp_err_t err = task_factory_start(s_tasks, TASK_FACTORY_COUNT(s_tasks));
+#else
+    esp_err_t err = ESP_OK;
+    for (size_t i = 0; i < TASK_FACTORY_COUNT(s_tasks); i++) {
+        const task_factory_entry_t *e = &s_tasks[i];
+        if (xTaskCreatePinnedToCore(e->fn, e->name, e->stack_size, e->arg,
+                                    e->priority, e->handle, e->core) != pdPASS) {
+            err = ESP_ERR_NO_MEM;
+            break;
+        }
+    }
+#endif
+    int64_t t1 = esp_timer_get_time();
+    vTaskPrioritySet(NULL, prio);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Task creation failed: %s", esp_err_to_name(err));
+        return;
+    }
+    ESP_LOGI(TAG, "%s creation of %u tasks took %" PRId64 " us",
+             USE_STATIC_TASKS ? "Static" : "Dynamic", (unsigned)TASK_FACTORY_COUNT(s_tasks), t1 - t0);
+    print_heap("after tasks");
+
+#if STACK_PROFILE
+    stack_profiler_add_table(s_tasks, TASK_FACTORY_COUNT(s_tasks));
+    stack_profiler_start(NULL);
+#endif
+}
@@ -0,0 +1,200 @@
+/**
+ * @file periodic_jobs_vs_tasks.c
+ * @brief The course's tiny periodic tasks as dedicated tasks vs static software timers.
+ *
+ * three_tasks_priority.c, task_priority_example.c, delay_vs_delayuntil.c and
+ * blink_two_leds.c each spend a task with a 2048-byte stack on a loop that
+ * wakes, does a few microseconds of work and sleeps. This demo runs the same
+ * seven bodies (two LED blinks, counters standing in for the prints) twice,
+ * for RUN_MS each:
+ *   tasks  : one xTaskCreate() task per body, vTaskDelay() loop
+ *   timers : one periodic_job_t per body (components/periodic_jobs), all
+ *            on the timer service task, no heap
+ * For each mode it prints the heap taken, the static RAM, and the number of
+ * wakeups. Each wakeup costs a switch in and a switch out, so wakeups are
+ * used as the count of context switches:
+ *   [CMP] tasks : heap 16800 B (7 stacks of 2048 B + TCBs), static 0 B | 85 wakeups ~170 switches
+ *   [CMP] timers: heap 0 B, static 7 x 88 B + shared service stack 2048 B | 20 wakeups ~40 switches
+ *   [PJOB] 7 jobs, 10 s: 85 runs in 20 service wakeups (65 shared)
+ *   (illustrative)
+ * Each timer wakeup serves every job whose period ends on that tick. The
+ * task count keeps one wakeup per job run.
+ *
+ * Set SLOW_JOB_US to e.g. 800 to add a job that busy-waits that long.
+ * The report then flags it as over budget: work like that belongs in a task
+ * (see the guidance in periodic_jobs.h).
+ *
+ * Wiring:
+ *   - LED1 (GPIO2 by default) -> resistor -> GND
+ *   - LED2 (GPIO4 by default) -> resistor -> GND
+ *
+ * Files needed in your project's main/ folder:
+ *   - periodic_jobs_vs_tasks.c (this file)
+ *   - components/periodic_jobs/periodic_jobs.c and periodic_jobs.h
+ *
+ * Target Platform: ESP32 with ESP-IDF v5.x
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_heap_caps.h"
+#include "esp_rom_sys.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+#include "periodic_jobs.h"
+
+#define TAG         "DAY19"
+#define RUN_MS      10000
+
+#ifndef LED1_GPIO
+#define LED1_GPIO   GPIO_NUM_2
+#endif
+
+#ifndef LED2_GPIO
+#define LED2_GPIO   GPIO_NUM_4
+#endif
+
+// Busy time of an extra job, in µs (0 = no extra job)
+#ifndef SLOW_JOB_US
+#define SLOW_JOB_US 0
+#endif
+
+typedef struct {
+    const char *name;
+    uint32_t period_ms;
+    periodic_job_cb_t body;
+    void *arg;
+} job_desc_t;
+
+static volatile uint32_t s_counts[5];
+static volatile uint32_t s_task_wakeups;
+
+// ------------------------ Job bodies ------------------------
+
+static void blink_body(void *arg)
+{
+    gpio_num_t pin = (gpio_num_t)(uintptr_t)arg;
+    gpio_set_level(pin, !gpio_get_level(pin));
+}
+
+static void count_body(void *arg)
+{
+    s_counts[(uintptr_t)arg]++;
+}
+
+#if SLOW_JOB_US
+static void slow_body(void *arg)
+{
+    esp_rom_delay_us(SLOW_JOB_US);
+}
+#endif
+
+static const job_desc_t s_descs[] = {
+    { "low",     1000, count_body, (void *)0 },             // three_tasks_priority / task_priority_example
+    { "medium",   500, count_body, (void *)1 },
+    { "delay",   1000, count_body, (void *)2 },             // delay_vs_delayuntil
+    { "until",   1000, count_body, (void *)3 },
+    { "blink1",   500, blink_body, (void *)LED1_GPIO },     // blink_two_leds
+    { "blink2",  1000, blink_body, (void *)LED2_GPIO },
+    { "status",  2000, count_body, (void *)4 },
+#if SLOW_JOB_US
+    { "slowlog", 1000, slow_body, NULL },
+#endif
+};
+#define NJOBS (sizeof(s_descs) / sizeof(s_descs[0]))
+
+// ------------------------ Mode 1: tasks ------------------------
+
+/**
+ * @brief The course pattern: one task per body, sleeping with vTaskDelay().
+ */
+static void job_task(void *arg)
+{
+    const job_desc_t *d = (const job_desc_t *)arg;
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(d->period_ms));
+        s_task_wakeups++;
+        d->body(d->arg);
+    }
+}
+
+static void run_tasks(void)
+{
+    TaskHandle_t handles[NJOBS];
+    size_t before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    for (size_t i = 0; i < NJOBS; i++) {
+        if (xTaskCreate(job_task, s_descs[i].name, 2048, (void *)&s_descs[i], 5, &handles[i]) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create task %s", s_descs[i].name);
+            handles[i] = NULL;
+        }
+    }
+    size_t used = before - heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    s_task_wakeups = 0;
+    vTaskDelay(pdMS_TO_TICKS(RUN_MS));
+    uint32_t wakeups = s_task_wakeups;
+
+    for (size_t i = 0; i < NJOBS; i++) {
+        if (handles[i] != NULL) {
+            vTaskDelete(handles[i]);
+        }
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));     // Idle task frees the stacks and TCBs
+
+    printf("[CMP] tasks : heap %u B (%u stacks of 2048 B + TCBs), static 0 B | %" PRIu32 " wakeups ~%" PRIu32 " switches\n",
+           (unsigned)used, (unsigned)NJOBS, wakeups, wakeups * 2);
+}
+
+// ------------------------ Mode 2: software timers ------------------------
+
+static periodic_job_t s_jobs[NJOBS];
+
+static void run_timers(void)
+{
+    size_t before = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    for (size_t i = 0; i < NJOBS; i++) {
+        const periodic_job_config_t cfg = {
+            .name = s_descs[i].name,
+            .period_ms = s_descs[i].period_ms,
+            .cb = s_descs[i].body,
+            .arg = s_descs[i].arg,
+        };
+        esp_err_t err = periodic_job_start(&s_jobs[i], &cfg, pdMS_TO_TICKS(10));
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to start job %s: %s", cfg.name, esp_err_to_name(err));
+        }
+    }
+    size_t used = before - heap_caps_get_free_size(MALLOC_CAP_8BIT);
+
+    periodic_jobs_stats_t st;
+    periodic_jobs_get_stats(&st, true);
+    vTaskDelay(pdMS_TO_TICKS(RUN_MS));
+    periodic_jobs_get_stats(&st, false);
+
+    printf("[CMP] timers: heap %u B, static %u x %u B + shared service stack %u B | %" PRIu32 " wakeups ~%" PRIu32 " switches\n",
+           (unsigned)used, (unsigned)NJOBS, (unsigned)sizeof(periodic_job_t),
+           (unsigned)CONFIG_FREERTOS_TIMER_TASK_STACK_DEPTH, st.wakeups, st.wakeups * 2);
+    periodic_jobs_report();
+
+    for (size_t i = 0; i < NJOBS; i++) {
+        periodic_job_stop(&s_jobs[i], pdMS_TO_TICKS(10));
+    }
+}
+
+void app_main(void)
+{
+    gpio_config_t io = {
+        .pin_bit_mask = (1ULL << LED1_GPIO) | (1ULL << LED2_GPIO),
+        .mode = GPIO_MODE_INPUT_OUTPUT,     // Input enabled so gpio_get_level() reads the output back
+    };
+    gpio_config(&io);
+
+    ESP_LOGI(TAG, "%u periodic bodies, %d ms per mode", (unsigned)NJOBS, RUN_MS);
+    run_tasks();
+    run_timers();
+}
@@ -0,0 +1,207 @@
+/**
+ * @file core_balancer_demo.c
+ * @brief Starts four compute workers on core 0 and lets core_balancer spread them.
+ *
+ * Each worker runs one step of about STEP_US of arithmetic and then waits
+ * one tick. STEP_US is 40% of a tick period (400 us at 1000 Hz, 4 ms at
+ * 100 Hz), so each worker wants ~40% of a core. Four of them on core 0
+ * would need ~160% of that core. They get only 100%, while
+ * core 1 sits idle. This is the deliberately bad placement.
+ *
+ * Phases:
+ *   1. BAD_PHASE_MS  : core_balancer in CORE_BALANCER_SUGGEST mode. It
+ *                      prints which worker it would move but changes nothing.
+ *   2. after that    : CORE_BALANCER_APPLY. Workers move one at a time, each
+ *                      at the end of a step, until the imbalance is below
+ *                      imbalance_pct. The cooldown keeps them from bouncing.
+ *
+ * Every second monitor_task prints the total throughput (steps/s) and the
+ * core of each worker. At the end of each phase it prints the phase
+ * average, so the two placements are compared on the same numbers:
+ *   [DEMO] 2500 steps/s | w0@0 w1@0 w2@0 w3@0
+ *   [BAL] core0 100.0% vs core1 3.1%: moving w0 (25.0%) core 0 -> 1, expected diff 46.9%
+ *   ...
+ *   [DEMO] 4000 steps/s | w0@1 w1@0 w2@1 w3@0
+ *   [DEMO] bad placement 2480 steps/s avg, balanced 3990 steps/s avg (x1.61)
+ *   (illustrative, 1000 Hz tick; at 100 Hz the step counts are a tenth)
+ *
+ * While core 0 is saturated its idle task never runs. With the default
+ * CONFIG_ESP_TASK_WDT_CHECK_IDLE_TASK_CPU0=y the task watchdog may print a
+ * warning during phase 1. That warning is the saturation being shown here.
+ *
+ * Files needed in your project's main/ folder:
+ *   - core_balancer_demo.c (this file)
+ *   - components/core_balancer/core_balancer.c and core_balancer.h
+ *   - components/cpu_load/cpu_load.c and cpu_load.h
+ *
+ * Requires CONFIG_FREERTOS_USE_TRACE_FACILITY=y,
+ * CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS=y and
+ * CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID=y (for cpu_load).
+ *
+ * Target Platform: dual-core ESP32 with ESP-IDF v5.x
+ */
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "cpu_load.h"
+#include "core_balancer.h"
+
+#define TAG "DAY22"
+
+#define NUM_WORKERS         4
+#define STEP_US             (400 * portTICK_PERIOD_MS)     // 40% of a tick per worker step
+#define WORKER_PRIORITY     4
+#define WORKER_STACK        2048
+#define BAD_PHASE_MS        10000   // Suggest-only phase
+#define BALANCED_PHASE_MS   20000   // Apply phase, then print the comparison
+#define MONITOR_PERIOD_MS   1000
+
+/** @brief All state of one worker; survives migration because it is not on the stack. */
+typedef struct {
+    uint32_t seed;
+    atomic_uint_fast32_t steps;
+} worker_state_t;
+
+static worker_state_t s_state[NUM_WORKERS];
+static core_balancer_task_t s_workers[NUM_WORKERS];
+static const char *s_names[NUM_WORKERS] = { "w0", "w1", "w2", "w3" };
+static uint32_t s_iters_per_step;
+static volatile uint32_t s_sink;
+
+/**
+ * @brief Fixed amount of integer arithmetic (xorshift rounds).
+ */
+static uint32_t compute(uint32_t x, uint32_t iters)
+{
+    for (uint32_t i = 0; i < iters; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+    }
+    return x;
+}
+
+/**
+ * @brief One worker step: STEP_US of work, then one tick off the CPU.
+ *
+ * @param arg worker_state_t of this worker.
+ */
+static void worker_step(void *arg)
+{
+    worker_state_t *st = (worker_state_t *)arg;
+
+    st->seed = compute(st->seed, s_iters_per_step);
+    s_sink = st->seed;
+    atomic_fetch_add(&st->steps, 1);
+    vTaskDelay(1);
+}
+
+/**
+ * @brief Total steps completed by all workers so far.
+ */
+static uint32_t total_steps(void)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < NUM_WORKERS; i++) {
+        sum += (uint32_t)atomic_load(&s_state[i].steps);
+    }
+    return sum;
+}
+
+/**
+ * @brief Prints throughput and placement every second; switches phases.
+ *
+ * @param pvParameters Unused.
+ */
+static void monitor_task(void *pvParameters)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    TickType_t phase_start = last_wake;
+    uint32_t last = total_steps();
+    uint32_t phase_base = last;
+    float bad_avg = 0.0f;
+    int phase = 1;
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(MONITOR_PERIOD_MS));
+
+        uint32_t now = total_steps();
+        char line[96];
+        int pos = snprintf(line, sizeof(line), "[DEMO] %" PRIu32 " steps/s |",
+                           (now - last) * 1000 / MONITOR_PERIOD_MS);
+        for (int i = 0; i < NUM_WORKERS && pos < (int)sizeof(line); i++) {
+            pos += snprintf(line + pos, sizeof(line) - pos, " %s@%d",
+                            s_names[i], (int)core_balancer_get_core(&s_workers[i]));
+        }
+        printf("%s\n", line);
+        last = now;
+
+        TickType_t elapsed = xTaskGetTickCount() - phase_start;
+        float avg = (float)(now - phase_base) * 1000.0f / (float)(elapsed * portTICK_PERIOD_MS);
+        if (phase == 1 && elapsed >= pdMS_TO_TICKS(BAD_PHASE_MS)) {
+            bad_avg = avg;
+            printf("[DEMO] bad placement %.0f steps/s avg, switching balancer to APPLY\n", (double)bad_avg);
+            core_balancer_set_mode(CORE_BALANCER_APPLY);
+            phase = 2;
+            phase_start = xTaskGetTickCount();
+            phase_base = now;
+        } else if (phase == 2 && elapsed >= pdMS_TO_TICKS(BALANCED_PHASE_MS)) {
+            // The average includes the few seconds the moves take
+            printf("[DEMO] bad placement %.0f steps/s avg, balanced %.0f steps/s avg (x%.2f)\n",
+                   (double)bad_avg, (double)avg, bad_avg > 0.0f ? (double)(avg / bad_avg) : 0.0);
+            phase = 3;
+        }
+    }
+}
+
+/**
+ * @brief Calibrates the step, starts cpu_load, the workers on core 0 and the balancer.
+ */
+void app_main(void)
+{
+    // Size one step to STEP_US on this chip and clock
+    int64_t t0 = esp_timer_get_time();
+    s_sink = compute(1, 10000);
+    int64_t dt = esp_timer_get_time() - t0;
+    s_iters_per_step = (uint32_t)(10000LL * STEP_US / (dt > 0 ? dt : 1));
+    ESP_LOGI(TAG, "%" PRIu32 " iterations per %d us step", s_iters_per_step, (int)STEP_US);
+
+    cpu_load_config_t load_cfg = {
+        .period_ms = 1000,
+        .report_every = 5,
+        .priority = 6,              // Above the workers so it samples on time
+        .core = 1,
+    };
+    ESP_ERROR_CHECK(cpu_load_start(&load_cfg));
+
+    // Deliberately bad placement: everything on core 0
+    for (int i = 0; i < NUM_WORKERS; i++) {
+        s_state[i].seed = 0x12345u + (uint32_t)i;
+        core_balancer_task_config_t cfg = {
+            .name = s_names[i],
+            .step = worker_step,
+            .arg = &s_state[i],
+            .priority = WORKER_PRIORITY,
+            .stack_size = WORKER_STACK,
+            .core = 0,
+        };
+        ESP_ERROR_CHECK(core_balancer_add_task(&s_workers[i], &cfg));
+    }
+
+    xTaskCreatePinnedToCore(monitor_task, "monitor", 3072, NULL, 7, NULL, 1);
+
+    core_balancer_config_t bal_cfg = {
+        .mode = CORE_BALANCER_SUGGEST,
+        .period_ms = 1000,
+        .imbalance_pct = 20,
+        .confirm_windows = 2,
+        .cooldown_ms = 5000,
+        .priority = 6,
+    };
+    ESP_ERROR_CHECK(core_balancer_start(&bal_cfg));
+}
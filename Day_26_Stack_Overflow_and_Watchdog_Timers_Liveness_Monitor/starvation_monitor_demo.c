@@ -0,0 +1,169 @@
+/**
+ * @file starvation_monitor_demo.c
+ * @brief The Day 5 priority pair with a spinning high task, caught by a liveness monitor before the TWDT.
+ *
+ * As in task_priority_example.c, task_low (priority 3) prints once per
+ * second and task_high (priority 8) twice per second. Both are pinned to
+ * DEMO_CORE here: unpinned, task_low would simply move to the other core.
+ * Every SPIN_EVERY_MS task_high "hangs" for SPIN_MS without blocking, like
+ * a polling loop waiting on a peripheral that never answers. task_low and
+ * the idle task of DEMO_CORE get no CPU for that long.
+ *
+ * A third task, task_wait (priority 5, the other core), waits for a
+ * semaphore that task_high gives each iteration. During a spin it is
+ * blocked, not starved, and the monitor says so.
+ *
+ * The tasks register with components/liveness_monitor and check in once
+ * per loop. The monitor (top priority, unpinned) reports each episode
+ * as it starts and REPORT_PERIOD_MS prints the totals (illustrative):
+ *   [LIVE] STARVED LowPriority p3@0: no check-in for 1520 ms (interval 1000) | core0 held by HighPriority p8 99.8%
+ *   [LIVE] LATE WaitTask p5@1: no check-in for 760 ms (interval 500) | blocked, not starved
+ *   [LIVE] core0 IDLE starved 1250 ms (TWDT 5000) | core0 held by HighPriority p8 99.8%
+ *   [LIVE] LowPriority  ok      checkins=18 late=0 starved=1 worst gap 2010 ms (interval 1000) | last culprit HighPriority p8 99.8%
+ * With SPIN_MS at 2000 the TWDT (5 s default) never fires. Set it to 6000
+ * and the board resets; the monitor's lines are on the console first. With
+ * TWDT_USERS = 1 the check-ins also feed TWDT users, so the panic names
+ * LowPriority as well as the idle task.
+ *
+ * sdkconfig: CONFIG_FREERTOS_USE_TRACE_FACILITY=y,
+ * CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS=y and
+ * CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID=y.
+ *
+ * Files needed in your project's main/ folder:
+ *   - starvation_monitor_demo.c (this file)
+ *   - components/liveness_monitor/liveness_monitor.c and liveness_monitor.h
+ *
+ * Target Platform: ESP32 with ESP-IDF v5.x
+ */
+
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_rom_sys.h"
+#include "esp_log.h"
+#include "liveness_monitor.h"
+
+#define TAG "DAY26"
+
+#ifndef SPIN_MS
+#define SPIN_MS             2000    // Above the TWDT timeout (5 s default) the board resets
+#endif
+
+#ifndef TWDT_USERS
+#define TWDT_USERS          1       // Check-ins also feed TWDT users
+#endif
+
+#define DEMO_CORE           0
+#define SPIN_EVERY_MS       10000
+#define REPORT_PERIOD_MS    10000
+
+static liveness_task_t s_low_live, s_high_live, s_wait_live;
+static SemaphoreHandle_t s_tick;
+
+/**
+ * @brief Register the calling task; without a TWDT fall back to monitor-only.
+ */
+static void watch_me(liveness_task_t *t, const char *name, uint32_t interval_ms)
+{
+    liveness_task_config_t cfg = {
+        .name = name,
+        .interval_ms = interval_ms,
+        .twdt = TWDT_USERS,
+    };
+    esp_err_t err = liveness_register(t, NULL, &cfg);
+    if (err != ESP_OK && cfg.twdt) {
+        ESP_LOGW(TAG, "%s: no TWDT user (%s), monitor only", name, esp_err_to_name(err));
+        cfg.twdt = false;
+        err = liveness_register(t, NULL, &cfg);
+    }
+    ESP_ERROR_CHECK(err);
+}
+
+/**
+ * @brief Low-priority task that runs every second.
+ *
+ * @param pvParameter Not used.
+ */
+static void task_low(void *pvParameter)
+{
+    watch_me(&s_low_live, "LowPriority", 1000);
+    while (1) {
+        liveness_checkin(&s_low_live);
+        printf("Low priority task running on Core %d\n", xPortGetCoreID());
+        vTaskDelay(pdMS_TO_TICKS(1000));
+    }
+}
+
+/**
+ * @brief High-priority task that runs every 0.5 seconds and spins for SPIN_MS every SPIN_EVERY_MS.
+ *
+ * @param pvParameter Not used.
+ */
+static void task_high(void *pvParameter)
+{
+    TickType_t next_spin = xTaskGetTickCount() + pdMS_TO_TICKS(SPIN_EVERY_MS);
+
+    watch_me(&s_high_live, "HighPriority", 500);
+    while (1) {
+        liveness_checkin(&s_high_live);
+        printf("High priority task running on Core %d\n", xPortGetCoreID());
+        xSemaphoreGive(s_tick);
+
+        if ((int32_t)(xTaskGetTickCount() - next_spin) >= 0) {
+            printf("High priority task spinning for %d ms...\n", SPIN_MS);
+            // Feeds itself: the hog is healthy by its own measure
+            for (int ms = 0; ms < SPIN_MS; ms++) {
+                esp_rom_delay_us(1000);
+                if (ms % 100 == 0) {
+                    liveness_checkin(&s_high_live);
+                }
+            }
+            next_spin = xTaskGetTickCount() + pdMS_TO_TICKS(SPIN_EVERY_MS);
+        }
+        vTaskDelay(pdMS_TO_TICKS(500));
+    }
+}
+
+/**
+ * @brief Waits for task_high's give; blocked, not starved, while task_high spins.
+ *
+ * @param pvParameter Not used.
+ */
+static void task_wait(void *pvParameter)
+{
+    watch_me(&s_wait_live, "WaitTask", 500);
+    while (1) {
+        xSemaphoreTake(s_tick, portMAX_DELAY);
+        liveness_checkin(&s_wait_live);
+    }
+}
+
+/**
+ * @brief Prints the liveness totals every REPORT_PERIOD_MS.
+ *
+ * @param pvParameter Not used.
+ */
+static void report_task(void *pvParameter)
+{
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(REPORT_PERIOD_MS));
+        liveness_monitor_report();
+    }
+}
+
+/**
+ * @brief Starts the monitor, the Day 5 pair on DEMO_CORE, the waiter and the reporter.
+ */
+void app_main(void)
+{
+    s_tick = xSemaphoreCreateBinary();
+    ESP_ERROR_CHECK(liveness_monitor_start(NULL));
+
+    xTaskCreatePinnedToCore(task_low, "LowPriority", 3072, NULL, 3, NULL, DEMO_CORE);
+    xTaskCreatePinnedToCore(task_high, "HighPriority", 3072, NULL, 8, NULL, DEMO_CORE);
+    xTaskCreatePinnedToCore(task_wait, "WaitTask", 3072, NULL, 5, NULL, !DEMO_CORE);
+    xTaskCreatePinnedToCore(report_task, "report", 3072, NULL, 4, NULL, !DEMO_CORE);
+
+    ESP_LOGI(TAG, "spin %d ms every %d ms on core %d", SPIN_MS, SPIN_EVERY_MS, DEMO_CORE);
+}
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+"""Convert a trace_recorder console dump into a Chrome/Perfetto trace and a summary.
+
+Usage:
+    python trace_convert.py console.log [-o trace.json] [--window-us 1000]
+
+The log may contain anything else; only the TRACE-BEGIN ... TRACE-END
+block is read (the last one if there are several). Output:
+    - trace.json: one track per core with a slice for each task run,
+      instant events for queue/notify/user events and a counter per queue
+    - stdout: switches per core, the busiest window (context-switch storms),
+      run time and switch count per task
+"""
+
+import argparse
+import json
+import struct
+import sys
+from collections import defaultdict
+
+# Must match the enum in components/trace_recorder/trace_hooks.h
+EVENTS = {
+    1: "switch_in", 2: "switch_out", 3: "task_create", 4: "task_delete",
+    5: "queue_send", 6: "queue_send_failed", 7: "queue_send_block", 8: "queue_send_isr",
+    9: "queue_receive", 10: "queue_receive_failed", 11: "queue_receive_block", 12: "queue_receive_isr",
+    13: "notify_give", 14: "notify_give_isr", 15: "notify_take", 16: "user",
+}
+QUEUE_EVENTS = {5, 6, 7, 8, 9, 10, 11, 12}
+RECORD = struct.Struct("<IIIBBH")
+
+
+def parse(lines):
+    """Return (header dict, names dict, records per core) of the last dump."""
+    block = None
+    for line in lines:
+        line = line.strip()
+        # Console lines may carry a prefix (timestamps from a terminal program)
+        pos = line.find("TRACE-BEGIN")
+        if pos >= 0:
+            block = {"header": line[pos:], "names": {}, "recs": defaultdict(list)}
+            continue
+        if block is None:
+            continue
+        if line.endswith("TRACE-END"):
+            done = block
+            block = None
+            yield done
+            continue
+        if line.startswith("NAME "):
+            _, kind, addr, *name = line.split(" ")
+            block["names"][int(addr, 16)] = (" ".join(name), kind)
+        elif line.startswith("REC "):
+            _, core, data = line.split(" ", 2)
+            raw = bytes.fromhex(data.strip())
+            for off in range(0, len(raw) - RECORD.size + 1, RECORD.size):
+                block["recs"][int(core)].append(RECORD.unpack_from(raw, off))
+
+
+def header_fields(header):
+    fields = {}
+    for part in header.split()[2:]:
+        key, _, value = part.partition("=")
+        fields[key] = value
+    return fields
+
+
+def unwrap(records, hz):
+    """Turn wrapping 32-bit timestamps into monotonic microseconds."""
+    out, base, prev = [], 0, None
+    for ts, obj, arg, typ, core, _ in records:
+        if prev is not None and ts < prev:
+            base += 1 << 32
+        prev = ts
+        out.append(((base + ts) * 1e6 / hz, obj, arg, typ, core))
+    return out
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("log")
+    ap.add_argument("-o", "--output", default="trace.json")
+    ap.add_argument("--window-us", type=float, default=1000.0, help="storm detection window")
+    args = ap.parse_args()
+
+    with open(args.log, errors="replace") as f:
+        dumps = list(parse(f))
+    if not dumps:
+        sys.exit("no TRACE-BEGIN ... TRACE-END block found")
+    dump = dumps[-1]
+    hdr = header_fields(dump["header"])
+    hz = float(hdr.get("hz", 1000000))
+    names = dump["names"]
+
+    def name_of(obj):
+        return names.get(obj, ("0x%08x" % obj, "?"))[0]
+
+    per_core = {c: unwrap(r, hz) for c, r in dump["recs"].items()}
+    t0 = min((r[0][0] for r in per_core.values() if r), default=0.0)
+
+    events = []
+    run_us = defaultdict(float)
+    switches = defaultdict(int)
+    for core, recs in sorted(per_core.items()):
+        events.append({"ph": "M", "pid": 1, "tid": core, "name": "thread_name", "args": {"name": "core%d" % core}})
+        current, since, switch_times = None, None, []
+        for ts, obj, arg, typ, _ in recs:
+            t = ts - t0
+            ev = EVENTS.get(typ, "type%d" % typ)
+            if typ == 1:
+                if current is not None:
+                    # Switched out without a record (ring started mid-run): close the slice
+                    events.append({"ph": "X", "pid": 1, "tid": core, "name": name_of(current), "ts": since, "dur": t - since})
+                    run_us[(name_of(current), core)] += t - since
+                current, since = obj, t
+                switches[(name_of(obj), core)] += 1
+                switch_times.append(t)
+            elif typ == 2:
+                if current is not None:
+                    events.append({"ph": "X", "pid": 1, "tid": core, "name": name_of(current), "ts": since, "dur": t - since})
+                    run_us[(name_of(current), core)] += t - since
+                current = None
+            elif typ in QUEUE_EVENTS:
+                events.append({"ph": "i", "s": "t", "pid": 1, "tid": core, "ts": t, "name": "%s %s" % (ev, name_of(obj))})
+                events.append({"ph": "C", "pid": 1, "ts": t, "name": name_of(obj), "args": {"depth": arg}})
+            elif typ == 16:
+                events.append({"ph": "i", "s": "t", "pid": 1, "tid": core, "ts": t, "name": "user %d = %d" % (obj, arg)})
+            else:
+                events.append({"ph": "i", "s": "t", "pid": 1, "tid": core, "ts": t, "name": "%s %s" % (ev, name_of(obj))})
+        print("core%d: %d records, %d switches" % (core, len(recs), len(switch_times)), end="")
+        best, best_at, lo = 0, 0.0, 0
+        for hi, t in enumerate(switch_times):
+            while t - switch_times[lo] > args.window_us:
+                lo += 1
+            if hi - lo + 1 > best:
+                best, best_at = hi - lo + 1, switch_times[lo]
+        print(", busiest %.0f us window %d switches at t=%.3f ms" % (args.window_us, best, best_at / 1000.0))
+
+    for (task, core), n in sorted(switches.items(), key=lambda kv: -kv[1]):
+        print("  %-16s core%d run %9.1f ms  switches %d" % (task, core, run_us[(task, core)] / 1000.0, n))
+
+    with open(args.output, "w") as f:
+        json.dump({"traceEvents": events, "displayTimeUnit": "ms"}, f)
+    print("wrote %s (%d events)" % (args.output, len(events)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Compare two bench_suite console logs and flag regressions.
+
+Usage:
+    python bench_compare.py base.log new.log [--threshold 10]
+
+Only lines containing "BENCH {" are read; anything else in the logs is
+ignored. Results are matched by benchmark name plus parameters. For every
+metric the change from base to new is printed in percent. A metric is a
+regression when it gets worse by more than the threshold: higher for
+latencies, errors, depths and counts, lower for rates (*_per_s).
+Exit status: 0 clean, 1 regression found, 2 unusable input.
+"""
+
+import argparse
+import json
+import sys
+
+
+def parse(path):
+    """Return (meta dict, {key: metrics}) of one log; key is (bench, params)."""
+    meta, results = {}, {}
+    with open(path, errors="replace") as f:
+        for line in f:
+            # Console lines may carry a prefix (timestamps from a terminal program)
+            pos = line.find("BENCH {")
+            if pos < 0:
+                continue
+            try:
+                obj = json.loads(line[pos + len("BENCH "):])
+            except ValueError:
+                continue    # Line cut by a reset or interleaved output
+            if obj.get("type") == "meta":
+                meta = obj
+            elif obj.get("type") == "result":
+                key = (obj["bench"], json.dumps(obj.get("params", {}), sort_keys=True))
+                results[key] = obj.get("metrics", {})
+    return meta, results
+
+
+def higher_is_better(metric):
+    return metric.endswith("_per_s")
+
+
+def label(key):
+    bench, params = key
+    p = json.loads(params)
+    return bench + " " + ",".join("%s=%s" % (k, p[k]) for k in sorted(p) if k != "n")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    ap.add_argument("base")
+    ap.add_argument("new")
+    ap.add_argument("--threshold", type=float, default=10.0, help="allowed worsening in percent")
+    args = ap.parse_args()
+
+    base_meta, base = parse(args.base)
+    new_meta, new = parse(args.new)
+    if not base or not new:
+        print("no BENCH result lines in %s" % (args.base if not base else args.new))
+        return 2
+
+    # Differences in build or chip explain most large changes: show them first
+    for field in ("idf", "target", "chip_rev", "cores", "cpu_mhz"):
+        if base_meta.get(field) != new_meta.get(field):
+            print("meta %s: %s -> %s" % (field, base_meta.get(field), new_meta.get(field)))
+    base_cfg, new_cfg = base_meta.get("config", {}), new_meta.get("config", {})
+    for field in sorted(set(base_cfg) | set(new_cfg)):
+        if base_cfg.get(field) != new_cfg.get(field):
+            print("config %s: %s -> %s" % (field, base_cfg.get(field), new_cfg.get(field)))
+
+    regressions = 0
+    for key in sorted(base):
+        if key not in new:
+            print("%-44s missing in new log" % label(key))
+            continue
+        for metric, old in sorted(base[key].items()):
+            if metric not in new[key]:
+                continue
+            cur = new[key][metric]
+            if old == 0:
+                change = 0.0 if cur == 0 else 100.0
+            else:
+                change = (cur - old) * 100.0 / abs(old)
+            worse = -change if higher_is_better(metric) else change
+            flag = ""
+            if worse > args.threshold:
+                flag = "  REGRESSION"
+                regressions += 1
+            elif worse < -args.threshold:
+                flag = "  improved"
+            print("%-44s %-16s %12d -> %12d  %+7.1f%%%s" % (label(key), metric, old, cur, change, flag))
+    for key in sorted(set(new) - set(base)):
+        print("%-44s new in this log" % label(key))
+
+    print("%d regression(s) over %.1f%%" % (regressions, args.threshold))
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
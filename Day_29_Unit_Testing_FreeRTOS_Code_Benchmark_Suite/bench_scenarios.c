@@ -0,0 +1,369 @@
+/**
+ * @file bench_scenarios.c
+ * @brief The Day 3-8 scenarios as parameterised benchmarks (table at the end; see bench_suite.c).
+ *
+ * Every scenario runs its tasks at priority 10 or above, above the runner
+ * (app_main, priority 1). Each task gives s_done when it finishes. The run
+ * function waits for those gives and only then prints, so console output
+ * never lands inside a timed section. Cycle counts are only compared on
+ * the core that read them, because the two cores' counters are not
+ * synchronised.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_cpu.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "bench_suite.h"
+
+#define BENCH_PRIO          10
+#define BENCH_STACK         3072
+#define JITTER_BODY_US      1500    // Loop body vTaskDelay() adds to each period, like delay_vs_delayuntil's printing
+#define QUEUE_MAX_ITEM      64
+
+static SemaphoreHandle_t s_done;
+static volatile bool s_stop;
+static const bench_def_t *s_def;
+static uint32_t *s_v;               // Samples of the running benchmark
+static uint32_t s_n;
+static volatile uint32_t s_idx;
+
+// ------------------------ Helpers ------------------------
+
+static void bench_prepare(const bench_def_t *def)
+{
+    if (s_done == NULL) {
+        s_done = xSemaphoreCreateCounting(4, 0);
+    }
+    s_def = def;
+    s_stop = false;
+    s_idx = 0;
+    s_n = def->p.n;
+    s_v = bench_samples(&s_n);
+}
+
+static TaskHandle_t spawn(TaskFunction_t fn, const char *name, UBaseType_t prio, int core)
+{
+    TaskHandle_t h = NULL;
+    xTaskCreatePinnedToCore(fn, name, BENCH_STACK, NULL, prio, &h, core);
+    return h;
+}
+
+static void wait_done(int count)
+{
+    for (int i = 0; i < count; i++) {
+        xSemaphoreTake(s_done, portMAX_DELAY);
+    }
+}
+
+static void finish(void)
+{
+    xSemaphoreGive(s_done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Busy task for the load variants; yields a tick every 50 ms so the idle task still runs.
+ */
+static void load_task(void *arg)
+{
+    int64_t next = esp_timer_get_time() + 50000;
+    while (!s_stop) {
+        esp_rom_delay_us(100);
+        if (esp_timer_get_time() >= next) {
+            vTaskDelay(1);
+            next += 50000;
+        }
+    }
+    finish();
+}
+
+// ------------------------ ctx_switch (Day 3 / Day 5) ------------------------
+
+static TaskHandle_t s_ping, s_pong;
+
+static void pong_task(void *arg)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (s_stop) {
+            break;
+        }
+        xTaskNotifyGive(s_ping);
+    }
+    finish();
+}
+
+static void ping_task(void *arg)
+{
+    s_ping = xTaskGetCurrentTaskHandle();   // Before the first give, so pong never sees NULL
+    for (uint32_t i = 0; i < s_n; i++) {
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        xTaskNotifyGive(s_pong);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        s_v[i] = bench_cycles_to_ns((esp_cpu_get_cycle_count() - t0) / 2);  // Two switches per round
+    }
+    s_stop = true;
+    xTaskNotifyGive(s_pong);
+    finish();
+}
+
+static bool run_ctx_switch(const bench_def_t *def)
+{
+    bench_prepare(def);
+    s_pong = spawn(pong_task, "b_pong", BENCH_PRIO, def->p.core_b);
+    spawn(ping_task, "b_ping", BENCH_PRIO, def->p.core_a);
+    wait_done(2);
+
+    bench_result_begin(def);
+    bench_dist_metrics("ns", s_v, s_n);
+    bench_result_end(s_n);
+    return true;
+}
+
+// ------------------------ preempt (Day 5) ------------------------
+
+static TaskHandle_t s_high;
+static volatile uint32_t s_t0;
+
+static void high_task(void *arg)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        uint32_t t1 = esp_cpu_get_cycle_count();
+        if (s_stop) {
+            break;
+        }
+        s_v[s_idx++] = bench_cycles_to_ns(t1 - s_t0);
+    }
+    finish();
+}
+
+static void low_task(void *arg)
+{
+    for (uint32_t i = 0; i < s_n; i++) {
+        vTaskDelay(1);              // Start each sample fresh after a tick
+        s_t0 = esp_cpu_get_cycle_count();
+        xTaskNotifyGive(s_high);    // Preempted here by high_task
+    }
+    s_stop = true;
+    xTaskNotifyGive(s_high);
+    finish();
+}
+
+static bool run_preempt(const bench_def_t *def)
+{
+    bench_prepare(def);
+    s_high = spawn(high_task, "b_high", BENCH_PRIO + 2, def->p.core_a);
+    spawn(low_task, "b_low", BENCH_PRIO, def->p.core_a);
+    wait_done(2);
+
+    bench_result_begin(def);
+    bench_dist_metrics("ns", s_v, s_idx);
+    bench_result_end(s_idx);
+    return true;
+}
+
+// ------------------------ period_jitter (Day 6) ------------------------
+
+static int64_t s_first_us, s_last_us;
+
+static void jitter_task(void *arg)
+{
+    const int64_t period_us = (int64_t)s_def->p.period_ms * 1000;
+    const TickType_t period = pdMS_TO_TICKS(s_def->p.period_ms);
+    TickType_t last_wake = xTaskGetTickCount();
+    int64_t prev = 0;
+
+    for (uint32_t i = 0; i <= s_n; i++) {
+        int64_t now = esp_timer_get_time();
+        if (i == 0) {
+            s_first_us = now;
+        } else {
+            int64_t err = (now - prev) - period_us;
+            s_v[i - 1] = (uint32_t)(err < 0 ? -err : err);
+        }
+        prev = now;
+
+        esp_rom_delay_us(JITTER_BODY_US);
+        if (s_def->p.delay_until) {
+            vTaskDelayUntil(&last_wake, period);
+        } else {
+            vTaskDelay(period);
+        }
+    }
+    s_last_us = prev;
+    s_stop = true;
+    finish();
+}
+
+static bool run_period_jitter(const bench_def_t *def)
+{
+    bench_prepare(def);
+    if (def->p.load) {
+        spawn(load_task, "b_load", BENCH_PRIO, def->p.core_a);
+    }
+    spawn(jitter_task, "b_jitter", BENCH_PRIO, def->p.core_a);
+    wait_done(def->p.load ? 2 : 1);
+
+    int64_t span = s_last_us - s_first_us;
+    bench_result_begin(def);
+    bench_dist_metrics("us", s_v, s_n);
+    bench_metric("mean_period_us", span / s_n);
+    bench_metric("drift_us", span - (int64_t)s_n * def->p.period_ms * 1000);
+    bench_result_end(s_n);
+    return true;
+}
+
+// ------------------------ queue_rtt (Day 8) ------------------------
+
+static QueueHandle_t s_req, s_rep;
+
+static void echo_task(void *arg)
+{
+    uint8_t buf[QUEUE_MAX_ITEM];
+    while (1) {
+        xQueueReceive(s_req, buf, portMAX_DELAY);
+        if (s_stop) {
+            break;
+        }
+        xQueueSend(s_rep, buf, portMAX_DELAY);
+    }
+    finish();
+}
+
+static void rtt_task(void *arg)
+{
+    uint8_t buf[QUEUE_MAX_ITEM] = { 0 };
+    for (uint32_t i = 0; i < s_n; i++) {
+        uint32_t t0 = esp_cpu_get_cycle_count();
+        xQueueSend(s_req, buf, portMAX_DELAY);
+        xQueueReceive(s_rep, buf, portMAX_DELAY);
+        s_v[i] = bench_cycles_to_ns(esp_cpu_get_cycle_count() - t0);
+    }
+    s_stop = true;
+    xQueueSend(s_req, buf, portMAX_DELAY);
+    finish();
+}
+
+static bool run_queue_rtt(const bench_def_t *def)
+{
+    bench_prepare(def);
+    s_req = xQueueCreate(1, def->p.item_size);
+    s_rep = xQueueCreate(1, def->p.item_size);
+    if (s_req == NULL || s_rep == NULL) {
+        if (s_req != NULL) {
+            vQueueDelete(s_req);
+        }
+        if (s_rep != NULL) {
+            vQueueDelete(s_rep);
+        }
+        bench_skip(def, "queue create failed");
+        return false;
+    }
+    spawn(echo_task, "b_echo", BENCH_PRIO, def->p.core_b);
+    spawn(rtt_task, "b_rtt", BENCH_PRIO, def->p.core_a);
+    wait_done(2);
+    vQueueDelete(s_req);
+    vQueueDelete(s_rep);
+
+    bench_result_begin(def);
+    bench_dist_metrics("ns", s_v, s_n);
+    bench_result_end(s_n);
+    return true;
+}
+
+// ------------------------ queue_throughput (Day 8) ------------------------
+
+static QueueHandle_t s_q;
+static int64_t s_tp_start_us, s_tp_end_us;
+static uint32_t s_full_events, s_max_depth;
+
+static void producer_task(void *arg)
+{
+    uint8_t buf[QUEUE_MAX_ITEM] = { 0 };
+    uint32_t n = s_def->p.n;
+
+    s_tp_start_us = esp_timer_get_time();
+    for (uint32_t i = 0; i < n; i++) {
+        buf[0] = (uint8_t)i;
+        if (xQueueSend(s_q, buf, 0) != pdTRUE) {
+            s_full_events++;        // Day 8 monitoring: producer found the queue full
+            xQueueSend(s_q, buf, portMAX_DELAY);
+        }
+    }
+    finish();
+}
+
+static void consumer_task(void *arg)
+{
+    uint8_t buf[QUEUE_MAX_ITEM];
+    uint32_t n = s_def->p.n;
+
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t depth = (uint32_t)uxQueueMessagesWaiting(s_q);
+        if (depth > s_max_depth) {
+            s_max_depth = depth;
+        }
+        xQueueReceive(s_q, buf, portMAX_DELAY);
+    }
+    s_tp_end_us = esp_timer_get_time();
+    finish();
+}
+
+static bool run_queue_throughput(const bench_def_t *def)
+{
+    bench_prepare(def);
+    s_full_events = 0;
+    s_max_depth = 0;
+    s_q = xQueueCreate(10, def->p.item_size);   // Queue length of queue_producer_consumer.c
+    if (s_q == NULL) {
+        bench_skip(def, "queue create failed");
+        return false;
+    }
+    spawn(consumer_task, "b_cons", BENCH_PRIO, def->p.core_b);
+    spawn(producer_task, "b_prod", BENCH_PRIO, def->p.core_a);
+    wait_done(2);
+    vQueueDelete(s_q);
+
+    int64_t us = s_tp_end_us - s_tp_start_us;
+    uint64_t items_per_s = us > 0 ? (uint64_t)def->p.n * 1000000 / (uint64_t)us : 0;
+    bench_result_begin(def);
+    bench_metric("items_per_s", (int64_t)items_per_s);
+    bench_metric("bytes_per_s", (int64_t)(items_per_s * def->p.item_size));
+    bench_metric("max_depth", s_max_depth);
+    bench_metric("full_events", s_full_events);
+    bench_result_end(def->p.n);
+    return true;
+}
+
+// ------------------------ Table ------------------------
+
+#define P_PAIR(a, b, item, n_)      { .core_a = (a), .core_b = (b), .item_size = (item), .n = (n_) }
+#define P_JITTER(until, load_)      { .core_a = 0, .core_b = BENCH_NA, .period_ms = 10, \
+                                      .delay_until = (until), .load = (load_), .n = 200 }
+
+const bench_def_t bench_table[] = {
+    { "ctx_switch",       run_ctx_switch,       P_PAIR(0, 0, 0, 2000) },
+    { "ctx_switch",       run_ctx_switch,       P_PAIR(0, 1, 0, 2000) },
+    { "preempt",          run_preempt,          P_PAIR(0, BENCH_NA, 0, 1000) },
+    { "preempt",          run_preempt,          P_PAIR(1, BENCH_NA, 0, 1000) },
+    { "period_jitter",    run_period_jitter,    P_JITTER(false, false) },
+    { "period_jitter",    run_period_jitter,    P_JITTER(true, false) },
+    { "period_jitter",    run_period_jitter,    P_JITTER(false, true) },
+    { "period_jitter",    run_period_jitter,    P_JITTER(true, true) },
+    { "queue_rtt",        run_queue_rtt,        P_PAIR(0, 0, 4, 2000) },
+    { "queue_rtt",        run_queue_rtt,        P_PAIR(0, 1, 4, 2000) },
+    { "queue_rtt",        run_queue_rtt,        P_PAIR(0, 1, 64, 2000) },
+    { "queue_throughput", run_queue_throughput, P_PAIR(0, 1, 4, 20000) },
+    { "queue_throughput", run_queue_throughput, P_PAIR(0, 1, 64, 20000) },
+    { "queue_throughput", run_queue_throughput, P_PAIR(0, 0, 4, 20000) },
+    { "queue_throughput", run_queue_throughput, P_PAIR(0, 0, 64, 20000) },
+};
+
+const uint32_t bench_table_len = sizeof(bench_table) / sizeof(bench_table[0]);
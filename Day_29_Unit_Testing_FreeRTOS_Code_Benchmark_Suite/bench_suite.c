@@ -0,0 +1,232 @@
+/**
+ * @file bench_suite.c
+ * @brief Regression benchmark firmware: Day 3-8 scenarios as measured tests with JSON-lines output.
+ *
+ * The course examples only print free-form console text, so a hot-path
+ * regression after an IDF upgrade, an sdkconfig change or a move to
+ * another chip goes unnoticed. This firmware runs the Day 3 to Day 8
+ * scenarios as parameterised benchmarks (bench_scenarios.c):
+ *   ctx_switch       Day 3/5  notify ping-pong, same core and cross-core: switch latency
+ *   preempt          Day 5    low-priority task wakes a higher one: preemption latency
+ *   period_jitter    Day 6    vTaskDelay vs vTaskDelayUntil, optional load: period error, drift
+ *   queue_rtt        Day 8    request/reply over two queues: round-trip time
+ *   queue_throughput Day 8    producer/consumer plus the monitoring view: items/s, depth, full events
+ * Output is one JSON object per line, prefixed with "BENCH ":
+ *   BENCH {"type":"meta","schema":1,"idf":"v5.1.2","target":"esp32","chip_model":1,"chip_rev":301,"cores":2,"cpu_mhz":240,"config":{"tick_hz":1000,"opt":"perf","unicore":0,...}}
+ *   BENCH {"type":"result","bench":"ctx_switch","params":{"core_a":0,"core_b":1,"n":2000},"metrics":{"p50_ns":5120,"p99_ns":6410,"max_ns":14250,"mean_ns":5230},"n":2000}
+ *   BENCH {"type":"end","results":15,"skipped":0,"elapsed_ms":13120}
+ *   (illustrative)
+ * Save two runs' logs and compare them on the host:
+ *   python bench_compare.py base.log new.log --threshold 10
+ * That prints every metric's change and exits non-zero if any got worse by
+ * more than the threshold.
+ *
+ * Build options: -DBENCH_FILTER="\"queue\"" runs only rows whose name
+ * contains the string. Cross-core rows are skipped on single-core builds.
+ *
+ * Files needed in your project's main/ folder:
+ *   - bench_suite.c (this file), bench_scenarios.c, bench_suite.h
+ *
+ * Target Platform: ESP32 / ESP32-S3 / single-core targets with ESP-IDF v5.x
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_chip_info.h"
+#include "esp_system.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "sdkconfig.h"
+#include "bench_suite.h"
+
+#ifndef BENCH_FILTER
+#define BENCH_FILTER ""
+#endif
+
+#define BENCH_SCHEMA 1
+
+// sdkconfig options that move the numbers, as 0/1 for the meta line
+#ifdef CONFIG_FREERTOS_UNICORE
+#define CFG_UNICORE 1
+#else
+#define CFG_UNICORE 0
+#endif
+#ifdef CONFIG_FREERTOS_PLACE_FUNCTIONS_INTO_FLASH
+#define CFG_FREERTOS_FLASH 1
+#else
+#define CFG_FREERTOS_FLASH 0
+#endif
+#ifdef CONFIG_FREERTOS_USE_TRACE_FACILITY
+#define CFG_TRACE_FACILITY 1
+#else
+#define CFG_TRACE_FACILITY 0
+#endif
+#ifdef CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+#define CFG_RUNTIME_STATS 1
+#else
+#define CFG_RUNTIME_STATS 0
+#endif
+#ifdef CONFIG_FREERTOS_USE_TICKLESS_IDLE
+#define CFG_TICKLESS 1
+#else
+#define CFG_TICKLESS 0
+#endif
+#ifdef CONFIG_SPIRAM
+#define CFG_SPIRAM 1
+#else
+#define CFG_SPIRAM 0
+#endif
+
+#if defined(CONFIG_COMPILER_OPTIMIZATION_PERF)
+#define CFG_OPT "perf"
+#elif defined(CONFIG_COMPILER_OPTIMIZATION_SIZE)
+#define CFG_OPT "size"
+#elif defined(CONFIG_COMPILER_OPTIMIZATION_NONE)
+#define CFG_OPT "none"
+#else
+#define CFG_OPT "debug"
+#endif
+
+static uint32_t s_samples[BENCH_MAX_SAMPLES];
+static bool s_first_metric;
+
+// ------------------------ Output helpers ------------------------
+
+uint32_t *bench_samples(uint32_t *n)
+{
+    if (*n > BENCH_MAX_SAMPLES) {
+        *n = BENCH_MAX_SAMPLES;
+    }
+    return s_samples;
+}
+
+uint32_t bench_cycles_to_ns(uint32_t cycles)
+{
+    return (uint32_t)((uint64_t)cycles * 1000 / esp_rom_get_cpu_ticks_per_us());
+}
+
+static void print_params(const bench_params_t *p)
+{
+    printf("\"params\":{\"core_a\":%d", p->core_a);
+    if (p->core_b != BENCH_NA) {
+        printf(",\"core_b\":%d", p->core_b);
+    }
+    if (p->item_size) {
+        printf(",\"item\":%u", (unsigned)p->item_size);
+    }
+    if (p->period_ms) {
+        printf(",\"period_ms\":%u,\"mode\":\"%s\"", (unsigned)p->period_ms,
+               p->delay_until ? "delay_until" : "delay");
+    }
+    if (p->load) {
+        printf(",\"load\":1");
+    }
+    printf(",\"n\":%" PRIu32 "}", p->n);
+}
+
+void bench_result_begin(const bench_def_t *def)
+{
+    printf("BENCH {\"type\":\"result\",\"bench\":\"%s\",", def->name);
+    print_params(&def->p);
+    printf(",\"metrics\":{");
+    s_first_metric = true;
+}
+
+void bench_metric(const char *key, int64_t value)
+{
+    printf("%s\"%s\":%lld", s_first_metric ? "" : ",", key, (long long)value);
+    s_first_metric = false;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+void bench_dist_metrics(const char *unit, uint32_t *values, uint32_t n)
+{
+    char key[24];
+    uint64_t sum = 0;
+
+    if (n == 0) {
+        return;
+    }
+    qsort(values, n, sizeof(values[0]), cmp_u32);
+    for (uint32_t i = 0; i < n; i++) {
+        sum += values[i];
+    }
+    uint32_t i99 = n * 99 / 100;
+
+    snprintf(key, sizeof(key), "p50_%s", unit);
+    bench_metric(key, values[n / 2]);
+    snprintf(key, sizeof(key), "p99_%s", unit);
+    bench_metric(key, values[i99]);
+    snprintf(key, sizeof(key), "max_%s", unit);
+    bench_metric(key, values[n - 1]);
+    snprintf(key, sizeof(key), "mean_%s", unit);
+    bench_metric(key, (int64_t)(sum / n));
+}
+
+void bench_result_end(uint32_t n)
+{
+    printf("},\"n\":%" PRIu32 "}\n", n);
+}
+
+void bench_skip(const bench_def_t *def, const char *reason)
+{
+    printf("BENCH {\"type\":\"skip\",\"bench\":\"%s\",", def->name);
+    print_params(&def->p);
+    printf(",\"reason\":\"%s\"}\n", reason);
+}
+
+// ------------------------ Runner ------------------------
+
+static void print_meta(void)
+{
+    esp_chip_info_t chip;
+    esp_chip_info(&chip);
+
+    printf("BENCH {\"type\":\"meta\",\"schema\":%d,\"idf\":\"%s\",\"target\":\"%s\",\"chip_model\":%d,"
+           "\"chip_rev\":%u,\"cores\":%u,\"cpu_mhz\":%" PRIu32 ",",
+           BENCH_SCHEMA, esp_get_idf_version(), CONFIG_IDF_TARGET, (int)chip.model,
+           (unsigned)chip.revision, (unsigned)chip.cores, (uint32_t)esp_rom_get_cpu_ticks_per_us());
+    printf("\"config\":{\"tick_hz\":%d,\"opt\":\"%s\",\"unicore\":%d,\"freertos_flash\":%d,"
+           "\"trace_facility\":%d,\"runtime_stats\":%d,\"tickless\":%d,\"spiram\":%d}}\n",
+           CONFIG_FREERTOS_HZ, CFG_OPT, CFG_UNICORE, CFG_FREERTOS_FLASH,
+           CFG_TRACE_FACILITY, CFG_RUNTIME_STATS, CFG_TICKLESS, CFG_SPIRAM);
+}
+
+void app_main(void)
+{
+    uint32_t results = 0, skipped = 0;
+    int64_t t0 = esp_timer_get_time();
+
+    vTaskDelay(pdMS_TO_TICKS(500));     // Let the boot log finish first
+    print_meta();
+
+    for (uint32_t i = 0; i < bench_table_len; i++) {
+        const bench_def_t *def = &bench_table[i];
+        if (strstr(def->name, BENCH_FILTER) == NULL) {
+            continue;
+        }
+        if (def->p.core_a >= portNUM_PROCESSORS || def->p.core_b >= portNUM_PROCESSORS) {
+            bench_skip(def, "core not available");
+            skipped++;
+            continue;
+        }
+        if (def->run(def)) {
+            results++;
+        } else {
+            skipped++;
+        }
+        vTaskDelay(pdMS_TO_TICKS(50));  // Idle task frees the benchmark's deleted tasks
+    }
+
+    printf("BENCH {\"type\":\"end\",\"results\":%" PRIu32 ",\"skipped\":%" PRIu32 ",\"elapsed_ms\":%" PRIu32 "}\n",
+           results, skipped, (uint32_t)((esp_timer_get_time() - t0) / 1000));
+}
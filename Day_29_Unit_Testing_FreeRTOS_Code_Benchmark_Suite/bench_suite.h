@@ -0,0 +1,95 @@
+/**
+ * @file bench_suite.h
+ * @brief Shared types and JSON-lines output helpers of the regression benchmark firmware.
+ *
+ * Each benchmark is one bench_def_t row in bench_scenarios.c: a name, a
+ * run function and its parameters. The runner in bench_suite.c prints one
+ * "meta" line describing the build and the chip, then runs every row and
+ * prints one "result" (or "skip") line per row, then one "end" line. Every
+ * line starts with "BENCH " and carries one JSON object, so a log can be
+ * filtered with grep and compared with bench_compare.py.
+ *
+ * A run function measures, then reports through the helpers:
+ *   bench_result_begin(def);
+ *   bench_dist_metrics("ns", samples, n);     // p50/p99/max/mean
+ *   bench_metric("items_per_s", rate);
+ *   bench_result_end(n);
+ * and returns true. When it cannot run (e.g. out of memory) it calls
+ * bench_skip() and returns false.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_NA            (-1)    //!< Parameter not used by the benchmark
+
+#ifndef BENCH_MAX_SAMPLES
+#define BENCH_MAX_SAMPLES   4000
+#endif
+
+/** @brief Benchmark parameters; unused fields are BENCH_NA or 0 and are not printed. */
+typedef struct {
+    int8_t core_a;                  //!< Core of the measuring task
+    int8_t core_b;                  //!< Core of the peer task (BENCH_NA if none)
+    uint16_t item_size;             //!< Queue item bytes
+    uint16_t period_ms;
+    bool delay_until;               //!< period_jitter: vTaskDelayUntil instead of vTaskDelay
+    bool load;                      //!< Busy task at the measuring task's priority on core_a
+    uint32_t n;                     //!< Iterations
+} bench_params_t;
+
+typedef struct bench_def bench_def_t;
+
+struct bench_def {
+    const char *name;
+    bool (*run)(const bench_def_t *def);    //!< false if it printed a skip line instead
+    bench_params_t p;
+};
+
+extern const bench_def_t bench_table[];
+extern const uint32_t bench_table_len;
+
+/**
+ * @brief Shared sample buffer of BENCH_MAX_SAMPLES entries; clamps *n to its size.
+ */
+uint32_t *bench_samples(uint32_t *n);
+
+/**
+ * @brief CPU cycles to nanoseconds at the current CPU frequency.
+ */
+uint32_t bench_cycles_to_ns(uint32_t cycles);
+
+/**
+ * @brief Start a result line for def (prints name and parameters).
+ */
+void bench_result_begin(const bench_def_t *def);
+
+/**
+ * @brief Add one integer metric to the open result line.
+ */
+void bench_metric(const char *key, int64_t value);
+
+/**
+ * @brief Sort values and add p50_<unit>, p99_<unit>, max_<unit> and mean_<unit>.
+ */
+void bench_dist_metrics(const char *unit, uint32_t *values, uint32_t n);
+
+/**
+ * @brief Close the open result line with the sample count.
+ */
+void bench_result_end(uint32_t n);
+
+/**
+ * @brief Print a skip line for def with a reason instead of a result.
+ */
+void bench_skip(const bench_def_t *def, const char *reason);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,219 @@
+/**
+ * @file arena_latency_benchmark.c
+ * @brief Allocation latency under two-core contention: heap_caps_malloc vs per-core arenas (components/core_arena).
+ *
+ * Two tasks, pinned to core 0 and core 1 as in task_core_affinity.c, each
+ * perform N_OPS allocations of 16..512 bytes. Each task keeps LIVE blocks
+ * alive in a ring. Every 4th block goes to the other core through a queue
+ * and is freed there, so cross-core frees are part of the mix. The same
+ * run is done twice:
+ *   heap  : heap_caps_malloc() / heap_caps_free() on the shared heap lock
+ *   arena : core_arena_alloc() / core_arena_free()
+ * Every alloc and free is timed in CPU cycles and put into a histogram of
+ * 16-cycle buckets. Output per task (illustrative, 240 MHz):
+ *   [LAT] heap  core0 alloc p50 672 p99 2896 max 9410 cyc | free p50 528 p99 2304 max 7990 cyc
+ *   [LAT] heap  core1 alloc p50 688 p99 3040 max 10212 cyc | free p50 544 p99 2416 max 8120 cyc
+ *   [LAT] arena core0 alloc p50 112 p99 144 max 1840 cyc | free p50 96 p99 128 max 1320 cyc
+ *   [LAT] arena core1 alloc p50 112 p99 144 max 1712 cyc | free p50 96 p99 144 max 1402 cyc
+ *   [ARENA] core0 alloc=20000 free local=15000 remote=5000 | ...
+ * The arena max still includes interrupts that land inside the timed
+ * window. The heap p99 also includes waiting for the other core's heap
+ * lock.
+ *
+ * Files needed in your project's main/ folder:
+ *   - arena_latency_benchmark.c (this file)
+ *   - components/core_arena/core_arena.c and core_arena.h
+ *
+ * Target Platform: ESP32 (dual core) with ESP-IDF v5.x
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#include "esp_random.h"
+#include "esp_log.h"
+#include "core_arena.h"
+
+#define TAG             "DAY3_ARENA"
+#define N_OPS           20000
+#define LIVE            16
+#define REMOTE_EVERY    4
+#define HIST_BUCKETS    256         // 16 cycles each, plus one overflow bucket
+#define HIST_SHIFT      4
+
+typedef void *(*alloc_fn_t)(size_t size);
+typedef void (*free_fn_t)(void *p);
+
+typedef struct {
+    uint32_t hist[HIST_BUCKETS + 1];
+    uint32_t n;
+    uint32_t max;
+} lat_hist_t;
+
+typedef struct {
+    const char *label;
+    alloc_fn_t alloc;
+    free_fn_t free;
+} variant_t;
+
+static const variant_t *s_variant;
+static QueueHandle_t s_to_core[portNUM_PROCESSORS];    // Blocks for that core to free
+static SemaphoreHandle_t s_done;
+static TaskHandle_t s_workers[portNUM_PROCESSORS];
+static lat_hist_t s_alloc_lat[portNUM_PROCESSORS];
+static lat_hist_t s_free_lat[portNUM_PROCESSORS];
+
+// ------------------------ Variants ------------------------
+
+static void *heap_alloc(size_t size)
+{
+    return heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+static const variant_t s_heap = { "heap", heap_alloc, heap_caps_free };
+static const variant_t s_arena = { "arena", core_arena_alloc, core_arena_free };
+
+// ------------------------ Measurement ------------------------
+
+static void hist_add(lat_hist_t *h, uint32_t cycles)
+{
+    uint32_t b = cycles >> HIST_SHIFT;
+    h->hist[b < HIST_BUCKETS ? b : HIST_BUCKETS]++;
+    h->n++;
+    if (cycles > h->max) {
+        h->max = cycles;
+    }
+}
+
+/**
+ * @brief Upper bound in cycles of the bucket holding percentile pct (max if it overflowed).
+ */
+static uint32_t hist_pct(const lat_hist_t *h, uint32_t pct)
+{
+    uint32_t want = (uint32_t)(((uint64_t)h->n * pct + 99) / 100), seen = 0;
+    for (uint32_t b = 0; b < HIST_BUCKETS; b++) {
+        seen += h->hist[b];
+        if (seen >= want) {
+            return (b + 1) << HIST_SHIFT;
+        }
+    }
+    return h->max;
+}
+
+static void timed_free(lat_hist_t *h, void *p)
+{
+    uint32_t t0 = esp_cpu_get_cycle_count();
+    s_variant->free(p);
+    hist_add(h, esp_cpu_get_cycle_count() - t0);
+}
+
+/**
+ * @brief Frees whatever the other core sent us.
+ */
+static void free_incoming(int core)
+{
+    void *p;
+    while (xQueueReceive(s_to_core[core], &p, 0) == pdTRUE) {
+        timed_free(&s_free_lat[core], p);
+    }
+}
+
+/**
+ * @brief N_OPS timed allocations per run; releases one run per notification.
+ *
+ * @param arg Unused.
+ */
+static void bench_task(void *arg)
+{
+    int core = xPortGetCoreID();
+    int other = (core + 1) % portNUM_PROCESSORS;
+
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        void *ring[LIVE] = { 0 };
+
+        for (uint32_t i = 0; i < N_OPS; i++) {
+            size_t size = 16 + esp_random() % 497;
+            uint32_t t0 = esp_cpu_get_cycle_count();
+            void *p = s_variant->alloc(size);
+            hist_add(&s_alloc_lat[core], esp_cpu_get_cycle_count() - t0);
+            if (p == NULL) {
+                continue;
+            }
+            memset(p, (int)i, size);
+
+            if (i % REMOTE_EVERY == 0 && xQueueSend(s_to_core[other], &p, 0) == pdTRUE) {
+                p = NULL;
+            }
+            if (ring[i % LIVE] != NULL) {
+                timed_free(&s_free_lat[core], ring[i % LIVE]);
+            }
+            ring[i % LIVE] = p;
+            free_incoming(core);
+        }
+
+        for (int k = 0; k < LIVE; k++) {
+            if (ring[k] != NULL) {
+                timed_free(&s_free_lat[core], ring[k]);
+            }
+        }
+        core_arena_flush();         // Hand partial batches back (no-op for the heap run)
+        xSemaphoreGive(s_done);
+    }
+}
+
+static void run_variant(const variant_t *v)
+{
+    s_variant = v;
+    memset(s_alloc_lat, 0, sizeof(s_alloc_lat));
+    memset(s_free_lat, 0, sizeof(s_free_lat));
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        xTaskNotifyGive(s_workers[c]);
+    }
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        xSemaphoreTake(s_done, portMAX_DELAY);
+    }
+    // Both finished sending: collect the last blocks in flight
+    vTaskDelay(pdMS_TO_TICKS(10));
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        void *p;
+        while (xQueueReceive(s_to_core[c], &p, 0) == pdTRUE) {
+            v->free(p);
+        }
+    }
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        const lat_hist_t *a = &s_alloc_lat[c], *f = &s_free_lat[c];
+        printf("[LAT] %-5s core%d alloc p50 %" PRIu32 " p99 %" PRIu32 " max %" PRIu32 " cyc | free p50 %" PRIu32
+               " p99 %" PRIu32 " max %" PRIu32 " cyc\n",
+               v->label, c, hist_pct(a, 50), hist_pct(a, 99), a->max, hist_pct(f, 50), hist_pct(f, 99), f->max);
+    }
+}
+
+void app_main(void)
+{
+    s_done = xSemaphoreCreateCounting(portNUM_PROCESSORS, 0);
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        s_to_core[c] = xQueueCreate(32, sizeof(void *));
+    }
+    ESP_ERROR_CHECK(core_arena_init(NULL));
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        if (xTaskCreatePinnedToCore(bench_task, c ? "bench1" : "bench0", 3072, NULL, 5,
+                                    &s_workers[c], c) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to create bench task");
+            return;
+        }
+    }
+
+    run_variant(&s_heap);
+    run_variant(&s_arena);
+    core_arena_report();
+}
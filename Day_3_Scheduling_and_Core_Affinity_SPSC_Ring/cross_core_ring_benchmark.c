@@ -0,0 +1,240 @@
+/**
+ * @file cross_core_ring_benchmark.c
+ * @brief Cross-core transfer benchmark: lock-free SPSC ring vs xQueueSend/xQueueReceive.
+ *
+ * The Day 3 example shows how to pin tasks with xTaskCreatePinnedToCore().
+ * This example moves data between a producer pinned to Core 0 and a consumer
+ * pinned to Core 1. It uses two transports with the same pinned setup:
+ *   1) FreeRTOS queue : xQueueSend() / xQueueReceive() (shared spinlock)
+ *   2) spsc_ring_t    : atomic head/tail, notification only when empty->non-empty
+ *
+ * Two measurements per transport:
+ *   - Throughput: the producer sends BENCH_ITEMS as fast as it can.
+ *   - Latency   : the producer sends one timestamped item every
+ *                 BENCH_LAT_GAP_US, so the consumer is asleep each time and
+ *                 the number includes the wakeup path. esp_timer_get_time()
+ *                 is used because it is synchronized between the cores.
+ *
+ * Files needed in your project's main/ folder:
+ *   - cross_core_ring_benchmark.c (this file)
+ *   - components/spsc_ring/spsc_ring.c and spsc_ring.h
+ *
+ * Target Platform: dual-core ESP32 / ESP32-S3 with ESP-IDF
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "esp_log.h"
+#include "spsc_ring.h"
+
+#define TAG                 "RING_BENCH"
+#define BENCH_ITEMS         100000      // Items per throughput run
+#define BENCH_LAT_SAMPLES   2000        // Items per latency run
+#define BENCH_LAT_GAP_US    200         // Spacing between latency samples
+#define BENCH_DEPTH         256         // Ring slots / queue length
+#define BENCH_PRIORITY      10
+#define PRODUCER_CORE       0
+#define CONSUMER_CORE       1
+
+#if portNUM_PROCESSORS < 2
+#error "This benchmark needs a dual-core target"
+#endif
+
+/** @brief Item carried by both transports. */
+typedef struct {
+    uint32_t seq;
+    uint32_t t_us;          // Low 32 bits of esp_timer_get_time() at send
+} ring_msg_t;
+
+/** @brief One transport under test. */
+typedef struct {
+    const char *name;
+    void (*reset)(TaskHandle_t consumer);
+    void (*send)(const ring_msg_t *msg);
+    void (*receive)(ring_msg_t *msg);
+} transport_t;
+
+/** @brief Shared state of one run. */
+typedef struct {
+    const transport_t *tp;
+    bool latency_mode;
+    uint32_t count;         // Items to transfer
+    TaskHandle_t controller;
+    uint32_t errors;
+    int64_t t_start_us;
+    int64_t t_end_us;
+} bench_run_t;
+
+SPSC_RING_DEFINE(s_ring, BENCH_DEPTH, sizeof(ring_msg_t));
+
+static uint8_t s_queue_storage[BENCH_DEPTH * sizeof(ring_msg_t)];
+static StaticQueue_t s_queue_buf;
+static QueueHandle_t s_queue;
+
+static uint32_t s_lat_us[BENCH_LAT_SAMPLES];
+
+// ------------------------ Transports ------------------------
+
+static void queue_reset(TaskHandle_t consumer)
+{
+    (void)consumer;
+    if (s_queue == NULL) {
+        s_queue = xQueueCreateStatic(BENCH_DEPTH, sizeof(ring_msg_t), s_queue_storage, &s_queue_buf);
+    }
+    xQueueReset(s_queue);
+}
+
+static void queue_send(const ring_msg_t *msg)
+{
+    xQueueSend(s_queue, msg, portMAX_DELAY);
+}
+
+static void queue_receive(ring_msg_t *msg)
+{
+    xQueueReceive(s_queue, msg, portMAX_DELAY);
+}
+
+static void ring_reset(TaskHandle_t consumer)
+{
+    ESP_ERROR_CHECK(spsc_ring_init(&s_ring, consumer));
+}
+
+static void ring_send(const ring_msg_t *msg)
+{
+    // The producer owns Core 0 for the run, so spin instead of blocking.
+    while (!spsc_ring_push(&s_ring, msg)) {
+    }
+}
+
+static void ring_receive(ring_msg_t *msg)
+{
+    spsc_ring_receive(&s_ring, msg, portMAX_DELAY);
+}
+
+static const transport_t s_transports[] = {
+    { "xQueue",    queue_reset, queue_send, queue_receive },
+    { "spsc_ring", ring_reset,  ring_send,  ring_receive  },
+};
+
+// ------------------------ Tasks ------------------------
+
+/**
+ * @brief Producer pinned to PRODUCER_CORE.
+ *
+ * @param arg bench_run_t describing the run.
+ */
+static void producer_task(void *arg)
+{
+    bench_run_t *run = (bench_run_t *)arg;
+    ring_msg_t msg;
+
+    run->t_start_us = esp_timer_get_time();
+    for (uint32_t seq = 0; seq < run->count; seq++) {
+        if (run->latency_mode) {
+            esp_rom_delay_us(BENCH_LAT_GAP_US);
+        }
+        msg.seq = seq;
+        msg.t_us = (uint32_t)esp_timer_get_time();
+        run->tp->send(&msg);
+    }
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Consumer pinned to CONSUMER_CORE; binds itself to the transport first.
+ *
+ * @param arg bench_run_t describing the run.
+ */
+static void consumer_task(void *arg)
+{
+    bench_run_t *run = (bench_run_t *)arg;
+    ring_msg_t msg;
+
+    run->tp->reset(xTaskGetCurrentTaskHandle());
+    xTaskNotifyGive(run->controller);           // Ready: start the producer
+
+    for (uint32_t seq = 0; seq < run->count; seq++) {
+        run->tp->receive(&msg);
+        if (run->latency_mode) {
+            s_lat_us[seq] = (uint32_t)esp_timer_get_time() - msg.t_us;
+        }
+        if (msg.seq != seq) {
+            run->errors++;
+        }
+    }
+    run->t_end_us = esp_timer_get_time();
+    xTaskNotifyGive(run->controller);
+    vTaskDelete(NULL);
+}
+
+// ------------------------ Runner ------------------------
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Run one producer/consumer pair with the given transport and mode.
+ */
+static void run_once(bench_run_t *run)
+{
+    run->controller = xTaskGetCurrentTaskHandle();
+    run->errors = 0;
+
+    xTaskCreatePinnedToCore(consumer_task, "ring_cons", 3072, run, BENCH_PRIORITY, NULL, CONSUMER_CORE);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);    // Consumer bound and waiting
+    xTaskCreatePinnedToCore(producer_task, "ring_prod", 3072, run, BENCH_PRIORITY, NULL, PRODUCER_CORE);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);    // Consumer finished
+    vTaskDelay(pdMS_TO_TICKS(20));              // Let the idle tasks clean up
+}
+
+/**
+ * @brief Application entry point: run both measurements for both transports.
+ */
+void app_main(void)
+{
+    ESP_LOGI(TAG, "Producer on Core %d -> consumer on Core %d, depth %d",
+             PRODUCER_CORE, CONSUMER_CORE, BENCH_DEPTH);
+
+    printf("\ntransport | items/s    | lat p50 us | lat p99 us | lat max us | wakeups | errors\n");
+    printf("----------+------------+------------+------------+------------+---------+-------\n");
+
+    for (size_t i = 0; i < sizeof(s_transports) / sizeof(s_transports[0]); i++) {
+        bench_run_t run = { .tp = &s_transports[i] };
+
+        run.latency_mode = false;
+        run.count = BENCH_ITEMS;
+        run_once(&run);
+        double rate = run.count * 1e6 / (double)(run.t_end_us - run.t_start_us);
+        uint32_t errors = run.errors;
+
+        run.latency_mode = true;
+        run.count = BENCH_LAT_SAMPLES;
+        run_once(&run);
+        errors += run.errors;
+        qsort(s_lat_us, BENCH_LAT_SAMPLES, sizeof(s_lat_us[0]), cmp_u32);
+
+        // Ring wakeups show how often the producer had to notify at all.
+        char wakeups[12] = "n/a";
+        if (run.tp->reset == ring_reset) {
+            snprintf(wakeups, sizeof(wakeups), "%" PRIu32, s_ring.wakeups);
+        }
+
+        printf("%-9s | %10.0f | %10" PRIu32 " | %10" PRIu32 " | %10" PRIu32 " | %7s | %" PRIu32 "\n",
+               run.tp->name, rate,
+               s_lat_us[BENCH_LAT_SAMPLES / 2],
+               s_lat_us[(BENCH_LAT_SAMPLES * 99) / 100],
+               s_lat_us[BENCH_LAT_SAMPLES - 1],
+               wakeups, errors);
+    }
+}
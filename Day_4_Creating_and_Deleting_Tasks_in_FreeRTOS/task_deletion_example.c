@@ -4,52 +4,87 @@
  *
  * This example creates two tasks:
  *  1. hello_task – prints a counter every second and deletes itself after 5 iterations.
- *  2. control_task – waits 3 seconds, deletes hello_task if still running, then deletes itself.
+ *  2. control_task – waits 3 seconds, asks hello_task to stop if still running,
+ *     waits until it has exited, then deletes itself.
  *
- * It illustrates both self-deletion and deleting another task by its handle.
+ * It illustrates self-deletion and stopping another task. hello_task owns a
+ * heap buffer. Calling vTaskDelete(task_handle_hello) from control_task
+ * would leak it, and anything else the task held at that moment, because
+ * the task never gets to clean up. Instead control_task sends a stop
+ * request through task_signal (direct-to-task notifications). hello_task
+ * sees it at its next safe point (task_signal_sleep()), frees the buffer
+ * and deletes itself with task_signal_exit().
+ *
+ * Files needed in your project's main/ folder:
+ *   - task_deletion_example.c (this file)
+ *   - components/task_signal/task_signal.c and task_signal.h
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "task_signal.h"
+
+#define HELLO_BUFFER_SIZE 256
 
 // Handle to the Hello Task
 TaskHandle_t task_handle_hello = NULL;
 
+// Stop channel to the Hello Task
+static task_signal_t hello_signal;
+
 /**
  * @brief Task that prints a counter and self-deletes after 5 iterations.
  *
  * Prints a message every second, increments a counter, and deletes itself
- * when the counter reaches 5.
+ * when the counter reaches 5. If a stop request arrives first, it leaves
+ * the loop early. Either way the work buffer is freed before the task exits.
  *
  * @param pvParameters Pointer to optional task parameters (unused here).
  */
 void hello_task(void *pvParameters) {
     int counter = 0;
-    while (1) {
-        printf("Hello Task running, counter = %d\n", counter++);
-        vTaskDelay(pdMS_TO_TICKS(1000));
+    char *buffer = malloc(HELLO_BUFFER_SIZE);   // Resource that must not leak
+
+    while (buffer != NULL) {
+        snprintf(buffer, HELLO_BUFFER_SIZE, "Hello Task running, counter = %d", counter++);
+        printf("%s\n", buffer);
+
+        // Sleeps 1 s, but wakes immediately on a stop request
+        if (task_signal_sleep(&hello_signal, pdMS_TO_TICKS(1000))) {
+            printf("Hello Task: stop requested, cleaning up...\n");
+            break;
+        }
         if (counter >= 5) {
             printf("Hello Task deleting itself...\n");
-            vTaskDelete(NULL); // Delete self
+            break;
         }
     }
+
+    free(buffer);
+    task_signal_exit(&hello_signal); // Delete self
 }
 
 /**
- * @brief Task that deletes the hello_task after 3 seconds if still running.
+ * @brief Task that stops the hello_task after 3 seconds if still running.
  *
- * Waits for 3 seconds, checks if hello_task handle is valid,
- * deletes it if found, then deletes itself.
+ * Waits for 3 seconds, checks if hello_task is still running, requests a
+ * stop and waits until hello_task has exited, then deletes itself.
  *
  * @param pvParameters Pointer to optional task parameters (unused here).
  */
 void control_task(void *pvParameters) {
     printf("Control Task running...\n");
     vTaskDelay(pdMS_TO_TICKS(3000));
-    if (task_handle_hello != NULL) {
-        printf("Control Task deleting Hello Task...\n");
-        vTaskDelete(task_handle_hello); // Delete other task
+    if (task_signal_get_state(&hello_signal) != TASK_SIGNAL_STATE_STOPPED) {
+        printf("Control Task stopping Hello Task...\n");
+        task_signal_request_stop(&hello_signal); // Cooperative stop
+        if (task_signal_wait_state(&hello_signal, TASK_SIGNAL_STATE_STOPPED, pdMS_TO_TICKS(2000))) {
+            printf("Control Task: Hello Task exited cleanly\n");
+        } else {
+            printf("Control Task: Hello Task did not stop in time\n");
+        }
     }
     vTaskDelete(NULL);
 }
@@ -58,10 +93,13 @@ void control_task(void *pvParameters) {
  * @brief Main application entry point.
  *
  * Creates hello_task with priority 5 and control_task with priority 4.
- * The hello_task runs periodically and may be deleted either by itself
- * or by the control_task.
+ * The hello_task runs periodically and exits either by itself or when
+ * the control_task asks it to stop.
  */
 void app_main() {
+    // Reset the signal before its receiver can run; bound once the handle exists
+    task_signal_init(&hello_signal, NULL);
+
     // Create Hello Task
     xTaskCreate(
         hello_task,         // Task function
@@ -71,6 +109,7 @@ void app_main() {
         5,                  // Priority
         &task_handle_hello  // Handle
     );
+    task_signal_bind(&hello_signal, task_handle_hello);
 
     // Create Control Task
     xTaskCreate(
@@ -81,4 +120,4 @@ void app_main() {
         4,                  // Priority
         NULL                // Handle
     );
-}
\ No newline at end of file
+}
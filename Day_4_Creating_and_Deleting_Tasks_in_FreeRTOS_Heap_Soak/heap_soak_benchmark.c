@@ -0,0 +1,162 @@
+/**
+ * @file heap_soak_benchmark.c
+ * @brief Day 4 create/delete pattern in a soak loop, with heap fragmentation tracked by components/heap_track.
+ *
+ * task_deletion_example.c creates a task that mallocs a work buffer, runs
+ * briefly, frees it and deletes itself. This benchmark runs that pattern
+ * SOAK_ITERATIONS times, with up to 4 tasks in flight. Each soak task:
+ *   - gets a random stack depth (2048..4095 bytes) plus a TCB
+ *   - mallocs a 64..1536-byte work buffer and creates a small queue
+ *   - every 8th task hands a 256..1279-byte block to the keeper task,
+ *     which holds the last KEEP_SLOTS blocks. These model caches and
+ *     sessions that outlive the task that made them.
+ *   - frees the rest and calls vTaskDelete(NULL)
+ * The long-lived blocks land between short-lived stacks. Free heap stays
+ * roughly flat, but the largest free block shrinks.
+ *
+ * Unlike the examples, every xTaskCreate()/xQueueCreate() result is
+ * checked on every iteration. Every REPORT_EVERY iterations it prints:
+ *   [SOAK] iter 20000 | internal free 182340 largest 61440 frag 66% min 170112 | create fails 0 queue fails 0
+ * and heap_track_report() at the end (see heap_track.h for its format).
+ * (illustrative)
+ *
+ * Enable CONFIG_HEAP_TASK_TRACKING and CONFIG_FREERTOS_USE_TRACE_FACILITY
+ * for the per-task table. Blocks are counted under the task that allocated
+ * them. The kept blocks therefore show in the "(deleted)" row, because the
+ * soak tasks that made them are gone. That row should stay at KEEP_SLOTS
+ * blocks or fewer; anything that grows beyond that is a leak.
+ *
+ * Files needed in your project's main/ folder:
+ *   - heap_soak_benchmark.c (this file)
+ *   - components/heap_track/heap_track.c and heap_track.h
+ *
+ * Target Platform: ESP32 with ESP-IDF v5.x
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_random.h"
+#include "esp_log.h"
+#include "heap_track.h"
+
+#define TAG             "DAY4_SOAK"
+#define IN_FLIGHT       4
+#define KEEP_SLOTS      24
+#define KEEP_EVERY      8
+
+#ifndef SOAK_ITERATIONS
+#define SOAK_ITERATIONS 20000
+#endif
+
+#ifndef REPORT_EVERY
+#define REPORT_EVERY    2000
+#endif
+
+static SemaphoreHandle_t s_slots;   // Counting: soak tasks still allowed in flight
+static QueueHandle_t s_keep_q;      // Blocks handed to the keeper
+static volatile uint32_t s_queue_fails;
+
+// ------------------------ Tasks ------------------------
+
+/**
+ * @brief Holds the last KEEP_SLOTS handed-over blocks, freeing the oldest as new ones arrive.
+ */
+static void keeper_task(void *arg)
+{
+    void *kept[KEEP_SLOTS] = { 0 };
+    uint32_t next = 0;
+    void *blk;
+
+    while (1) {
+        if (xQueueReceive(s_keep_q, &blk, portMAX_DELAY) == pdTRUE) {
+            free(kept[next]);
+            kept[next] = blk;
+            next = (next + 1) % KEEP_SLOTS;
+        }
+    }
+}
+
+/**
+ * @brief The Day 4 hello_task pattern: own a buffer, work briefly, clean up, delete self.
+ *
+ * @param arg Iteration number.
+ */
+static void soak_task(void *arg)
+{
+    uint32_t iter = (uint32_t)(uintptr_t)arg;
+    char *buf = malloc(64 + esp_random() % 1473);
+    QueueHandle_t q = xQueueCreate(4, 8 + esp_random() % 57);
+
+    if (q == NULL) {
+        s_queue_fails++;
+    }
+    if (buf != NULL) {
+        buf[0] = (char)iter;
+    }
+    vTaskDelay(1 + esp_random() % 3);
+
+    if (iter % KEEP_EVERY == 0) {
+        void *blk = malloc(256 + esp_random() % 1024);
+        if (blk != NULL && xQueueSend(s_keep_q, &blk, 0) != pdTRUE) {
+            free(blk);
+        }
+    }
+
+    if (q != NULL) {
+        vQueueDelete(q);
+    }
+    free(buf);
+    xSemaphoreGive(s_slots);
+    vTaskDelete(NULL);
+}
+
+static void print_progress(uint32_t iter, uint32_t create_fails)
+{
+    heap_track_snapshot_t snap;
+    heap_track_snapshot(&snap);
+    const heap_track_region_t *in = &snap.region[HEAP_TRACK_INTERNAL];
+
+    printf("[SOAK] iter %" PRIu32 " | internal free %u largest %u frag %" PRIu32 "%% min %u | create fails %" PRIu32
+           " queue fails %" PRIu32 "\n",
+           iter, (unsigned)in->free, (unsigned)in->largest, in->frag_pct, (unsigned)in->min_free,
+           create_fails, s_queue_fails);
+}
+
+void app_main(void)
+{
+    uint32_t create_fails = 0;
+
+    ESP_ERROR_CHECK(heap_track_init());
+    s_slots = xSemaphoreCreateCounting(IN_FLIGHT, IN_FLIGHT);
+    s_keep_q = xQueueCreate(8, sizeof(void *));
+    if (s_slots == NULL || s_keep_q == NULL ||
+        xTaskCreate(keeper_task, "keeper", 2048, NULL, 6, NULL) != pdPASS) {
+        ESP_LOGE(TAG, "Setup failed");
+        return;
+    }
+
+    print_progress(0, 0);
+    for (uint32_t i = 1; i <= SOAK_ITERATIONS; i++) {
+        xSemaphoreTake(s_slots, portMAX_DELAY);
+        uint32_t stack = 2048 + esp_random() % 2048;
+        if (xTaskCreate(soak_task, "soak", stack, (void *)(uintptr_t)i, 5, NULL) != pdPASS) {
+            create_fails++;
+            xSemaphoreGive(s_slots);
+            vTaskDelay(pdMS_TO_TICKS(10));  // Let the idle task free deleted tasks
+        }
+        if (i % REPORT_EVERY == 0) {
+            print_progress(i, create_fails);
+        }
+    }
+
+    for (int i = 0; i < IN_FLIGHT; i++) {
+        xSemaphoreTake(s_slots, portMAX_DELAY);
+    }
+    vTaskDelay(pdMS_TO_TICKS(50));
+    heap_track_report();
+}
@@ -7,12 +7,44 @@
  *  2. task_high – High-priority task that runs every 0.5 seconds.
  *
  * The output shows how FreeRTOS schedules tasks based on priority.
+ *
+ * Stack profiling (STACK_PROFILE = 1):
+ *  Runs components/stack_profiler next to the tasks (add stack_profiler.c/.h
+ *  and task_factory.h to main/, and enable CONFIG_FREERTOS_USE_TRACE_FACILITY).
+ *  Every minute it prints the worst-case stack use of every task and a
+ *  stack_profile.h block with recommended depths in place of the copied 2048.
+ *
+ * CPU load report (CPU_LOAD_REPORT = 1):
+ *  Runs components/cpu_load (add cpu_load.c/.h to main/, and enable
+ *  CONFIG_FREERTOS_USE_TRACE_FACILITY, CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+ *  and CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID).
+ *  Once per second it prints the load of each core and the busiest tasks
+ *  with their core affinity, e.g.
+ *    [CPU] core0   1.2%  core1   0.8% | HighPriority:0.4%@* LowPriority:0.2%@*
  */
 
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+// Set to 1 to profile the worst-case stack use of every task.
+#ifndef STACK_PROFILE
+#define STACK_PROFILE 0
+#endif
+
+#if STACK_PROFILE
+#include "stack_profiler.h"
+#endif
+
+// Set to 1 to print per-core and per-task CPU load once per second.
+#ifndef CPU_LOAD_REPORT
+#define CPU_LOAD_REPORT 0
+#endif
+
+#if CPU_LOAD_REPORT
+#include "cpu_load.h"
+#endif
+
 /**
  * @brief Low-priority task that runs every second.
  *
@@ -48,6 +80,13 @@ void task_high(void *pvParameter) {
  * FreeRTOS scheduling behavior.
  */
 void app_main() {
+#if STACK_PROFILE
+    stack_profiler_start(NULL);
+#endif
+#if CPU_LOAD_REPORT
+    cpu_load_start(NULL);
+#endif
+
     // Low priority task (priority 3)
     xTaskCreate(task_low, "LowPriority", 2048, NULL, 3, NULL);
 
@@ -15,12 +15,27 @@
  *  - Using vTaskDelay for non-blocking delays.
  *  - Changing a task's own priority at runtime with vTaskPrioritySet.
  *
+ * Stack profiling (STACK_PROFILE = 1):
+ *  Runs components/stack_profiler next to the tasks (add stack_profiler.c/.h
+ *  and task_factory.h to main/, and enable CONFIG_FREERTOS_USE_TRACE_FACILITY).
+ *  Every minute it prints the worst-case stack use of every task and a
+ *  stack_profile.h block with recommended depths in place of the copied 2048.
+ *
  * Target Platform: ESP32 with ESP-IDF
  */
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
+// Set to 1 to profile the worst-case stack use of every task.
+#ifndef STACK_PROFILE
+#define STACK_PROFILE 0
+#endif
+
+#if STACK_PROFILE
+#include "stack_profiler.h"
+#endif
+
 // Task handles so we can reference or modify tasks later
 TaskHandle_t low_task_handle = NULL;
 TaskHandle_t med_task_handle = NULL;
@@ -103,6 +118,10 @@ void high_priority_task(void *pvParameter)
  */
 void app_main(void)
 {
+#if STACK_PROFILE
+    stack_profiler_start(NULL);
+#endif
+
     // Create Low Priority Task (priority 1)
     xTaskCreate(low_priority_task, "LowPriorityTask", 2048, NULL, 1, &low_task_handle);
 
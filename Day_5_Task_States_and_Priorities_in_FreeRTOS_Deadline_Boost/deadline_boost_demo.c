@@ -0,0 +1,179 @@
+/**
+ * @file deadline_boost_demo.c
+ * @brief The Day 5 three-task case under overload, with deadline-aware priority boosting.
+ *
+ * Like three_tasks_priority.c, the high task starts at priority 3 and then
+ * drops itself to priority 1. Here it keeps a 100 ms deadline on a 200 ms
+ * period. The medium task (priority 2) has an overload burst of
+ * MEDIUM_BURST_MS every MEDIUM_BURST_EVERY jobs. At priority 1 the
+ * high task cannot run during a burst and misses. All three tasks share
+ * DEMO_CORE so they really compete.
+ *
+ * All three register with components/deadline_boost and bracket each job
+ * with deadline_boost_release()/deadline_boost_complete(). The priority
+ * drop goes through deadline_boost_set_base_priority() in place of
+ * vTaskPrioritySet(NULL, 1), so the supervisor knows which priority to
+ * restore. When a high job has used HIGH_GUARD_PCT of its deadline, the
+ * supervisor raises it back to 3 for the rest of that job only.
+ *
+ * Every REPORT_PERIOD_MS the reporter prints the per-task counters and the
+ * boost log. Build once with BOOST_ENABLE = 0 (the supervisor only
+ * measures) and once with 1, then compare the "miss" counts of the high
+ * task (illustrative output):
+ *   [DLB] high     jobs=25 boosts=9 rescued=9 miss=0 | resp avg 36 max 72 ms (deadline 100)
+ *   [DLB]  t=14.040s high     BOOST 1->3 at 40 ms
+ *   [DLB]  t=14.070s high     MET  after 70 ms (boosted)
+ *
+ * Files needed in your project's main/ folder:
+ *   - deadline_boost_demo.c (this file)
+ *   - components/deadline_boost/deadline_boost.c and deadline_boost.h
+ *
+ * Target Platform: ESP32 with ESP-IDF v5.x
+ */
+
+#include <stdio.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_rom_sys.h"
+#include "esp_log.h"
+#include "deadline_boost.h"
+
+#define TAG "DAY5"
+
+#ifndef BOOST_ENABLE
+#define BOOST_ENABLE        1       // 0: measure misses without boosting
+#endif
+
+#define DEMO_CORE           1
+#define LOW_PERIOD_MS       1000
+#define LOW_WORK_MS         50
+#define MEDIUM_PERIOD_MS    500
+#define MEDIUM_WORK_MS      100
+#define MEDIUM_BURST_MS     400     // Overload: every MEDIUM_BURST_EVERY-th job
+#define MEDIUM_BURST_EVERY  4
+#define HIGH_PERIOD_MS      200
+#define HIGH_DEADLINE_MS    100
+#define HIGH_WORK_MS        30
+#define HIGH_GUARD_PCT      40
+#define REPORT_PERIOD_MS    5000
+
+static deadline_task_t s_low, s_medium, s_high;
+
+/**
+ * @brief Busy "work" that can be preempted (unlike a critical section).
+ */
+static void work_ms(uint32_t ms)
+{
+    for (uint32_t i = 0; i < ms; i++) {
+        esp_rom_delay_us(1000);
+    }
+}
+
+/**
+ * @brief Low priority task: 50 ms of work every second.
+ *
+ * @param pvParameter Not used.
+ */
+static void low_priority_task(void *pvParameter)
+{
+    const deadline_task_config_t cfg = {
+        .name = "low", .period_ms = LOW_PERIOD_MS, .deadline_ms = LOW_PERIOD_MS,
+        .guard_pct = 80, .boost_priority = 2,
+    };
+    TickType_t last_wake = xTaskGetTickCount();
+
+    ESP_ERROR_CHECK(deadline_boost_register(&s_low, NULL, &cfg));
+    while (1) {
+        deadline_boost_release(&s_low);
+        work_ms(LOW_WORK_MS);
+        deadline_boost_complete(&s_low);
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(LOW_PERIOD_MS));
+    }
+}
+
+/**
+ * @brief Medium priority task: 100 ms of work per 500 ms, with a 400 ms burst every fourth job.
+ *
+ * @param pvParameter Not used.
+ */
+static void medium_priority_task(void *pvParameter)
+{
+    const deadline_task_config_t cfg = {
+        .name = "medium", .period_ms = MEDIUM_PERIOD_MS, .deadline_ms = MEDIUM_PERIOD_MS,
+        .guard_pct = 100, .boost_priority = 2,     // Already the top user priority here
+    };
+    TickType_t last_wake = xTaskGetTickCount();
+    uint32_t job = 0;
+
+    ESP_ERROR_CHECK(deadline_boost_register(&s_medium, NULL, &cfg));
+    while (1) {
+        deadline_boost_release(&s_medium);
+        work_ms(++job % MEDIUM_BURST_EVERY == 0 ? MEDIUM_BURST_MS : MEDIUM_WORK_MS);
+        deadline_boost_complete(&s_medium);
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(MEDIUM_PERIOD_MS));
+    }
+}
+
+/**
+ * @brief High priority task: starts at 3, lowers its base priority to 1 after five jobs.
+ *
+ * @param pvParameter Not used.
+ */
+static void high_priority_task(void *pvParameter)
+{
+    const deadline_task_config_t cfg = {
+        .name = "high", .period_ms = HIGH_PERIOD_MS, .deadline_ms = HIGH_DEADLINE_MS,
+        .guard_pct = HIGH_GUARD_PCT, .boost_priority = 3,
+    };
+    TickType_t last_wake = xTaskGetTickCount();
+    uint32_t job = 0;
+
+    ESP_ERROR_CHECK(deadline_boost_register(&s_high, NULL, &cfg));
+    while (1) {
+        deadline_boost_release(&s_high);
+        work_ms(HIGH_WORK_MS);
+        if (!deadline_boost_complete(&s_high)) {
+            ESP_LOGW(TAG, "high missed its %d ms deadline", HIGH_DEADLINE_MS);
+        }
+
+        if (++job == 5) {
+            printf("High Priority Task lowering its priority to lowest...\n");
+            deadline_boost_set_base_priority(&s_high, 1);
+        }
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(HIGH_PERIOD_MS));
+    }
+}
+
+/**
+ * @brief Prints the deadline statistics and boost log every REPORT_PERIOD_MS.
+ *
+ * @param pvParameter Not used.
+ */
+static void report_task(void *pvParameter)
+{
+    while (1) {
+        vTaskDelay(pdMS_TO_TICKS(REPORT_PERIOD_MS));
+        deadline_boost_report();
+    }
+}
+
+/**
+ * @brief Starts the supervisor, the three tasks on DEMO_CORE and the reporter.
+ */
+void app_main(void)
+{
+    const deadline_boost_config_t cfg = {
+        .check_period_ms = 1,
+        .priority = 10,
+        .core = DEMO_CORE,
+        .enabled = BOOST_ENABLE,
+    };
+    ESP_ERROR_CHECK(deadline_boost_start(&cfg));
+
+    xTaskCreatePinnedToCore(low_priority_task, "LowPriorityTask", 3072, NULL, 1, NULL, DEMO_CORE);
+    xTaskCreatePinnedToCore(medium_priority_task, "MediumPriorityTask", 3072, NULL, 2, NULL, DEMO_CORE);
+    xTaskCreatePinnedToCore(high_priority_task, "HighPriorityTask", 3072, NULL, 3, NULL, DEMO_CORE);
+    xTaskCreatePinnedToCore(report_task, "report", 3072, NULL, 4, NULL, 0);
+
+    ESP_LOGI(TAG, "deadline boosting %s", BOOST_ENABLE ? "enabled" : "disabled (measure only)");
+}
@@ -1,32 +1,46 @@
 /**
  * @file task_priority_suspend_example.c
- * @brief Demonstrates FreeRTOS task priorities and suspension on ESP32.
+ * @brief Demonstrates FreeRTOS task priorities and cooperative pausing on ESP32.
  *
  * This example creates two tasks with different priorities:
  *  - task_low  (priority 3): prints once per second.
  *  - task_high (priority 8): prints twice per second and, periodically,
- *    suspends task_low for 3 seconds to highlight preemption and control.
+ *    pauses task_low for 3 seconds to highlight preemption and control.
  *
- * Observe the console: when task_low is suspended, only task_high prints.
+ * Observe the console: when task_low is paused, only task_high prints.
  * 
  * Notes:
- *   vTaskSuspend()/vTaskResume() act immediately; the suspended task won’t be scheduled until resumed.
+ *   vTaskSuspend()/vTaskResume() act immediately, wherever the target happens
+ *   to be: halfway through a printf holding the stdout lock, holding a mutex
+ *   or in the middle of a peripheral transaction. That cannot be raced safely
+ *   with work in flight. Here task_high sends pause/resume requests through
+ *   task_signal (direct-to-task notifications). task_low only pauses at its
+ *   own safe point, task_signal_sleep() between iterations, and task_high
+ *   waits until task_low reports TASK_SIGNAL_STATE_PAUSED.
  *   Keep configUSE_PREEMPTION = 1 (default in ESP-IDF) to clearly observe priority preemption.
- *   Avoid suspending critical system tasks (Idle/Timer). Here we only suspend our own task_low
+ *
+ * Files needed in your project's main/ folder:
+ *   - task_priority_suspend_example.c (this file)
+ *   - components/task_signal/task_signal.c and task_signal.h
  * 
  */
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "task_signal.h"
 
 // Handle for the low-priority task so the high-priority task can control it.
 static TaskHandle_t g_low_task_handle = NULL;
 
+// Pause/resume channel to the low-priority task.
+static task_signal_t g_low_signal;
+
 /**
  * @brief Low-priority task that prints every second.
  *
  * Prints which CPU core it is running on, then delays for 1000 ms.
- * This task may be suspended/resumed by the high-priority task.
+ * The delay is also its safe point: pause requests from the high-priority
+ * task take effect there, never in the middle of an iteration.
  *
  * @param pvParameter Optional parameter (unused).
  */
@@ -34,15 +48,18 @@ void task_low(void *pvParameter) {
     (void)pvParameter;
     while (1) {
         printf("[LOW ] Core %d: running\n", xPortGetCoreID());
-        vTaskDelay(pdMS_TO_TICKS(1000));
+        if (task_signal_sleep(&g_low_signal, pdMS_TO_TICKS(1000))) {
+            break;  // Stop requested (not used in this demo)
+        }
     }
+    task_signal_exit(&g_low_signal);
 }
 
 /**
- * @brief High-priority task that periodically suspends the low-priority task.
+ * @brief High-priority task that periodically pauses the low-priority task.
  *
  * Prints every 500 ms. Every ~3 seconds (after several iterations),
- * it suspends task_low for 3 seconds to demonstrate task control,
+ * it pauses task_low for 3 seconds to demonstrate task control,
  * then resumes it.
  *
  * @param pvParameter Optional parameter (unused).
@@ -56,20 +73,23 @@ void task_high(void *pvParameter) {
     while (1) {
         printf("[HIGH] Core %d: running (iter=%d)\n", xPortGetCoreID(), iter);
 
-        // Every 6 iterations (~3 seconds at 500 ms period), suspend low task for 3 seconds.
+        // Every 6 iterations (~3 seconds at 500 ms period), pause low task for 3 seconds.
         if ((iter % 6) == 0 && g_low_task_handle != NULL) {
-            printf("[HIGH] Suspending LOW task for 3 seconds...\n");
-            vTaskSuspend(g_low_task_handle);
+            printf("[HIGH] Pausing LOW task for 3 seconds...\n");
+            task_signal_request_pause(&g_low_signal);
+            if (!task_signal_wait_state(&g_low_signal, TASK_SIGNAL_STATE_PAUSED, pdMS_TO_TICKS(100))) {
+                printf("[HIGH] LOW task has not reached its safe point yet\n");
+            }
 
-            // Keep printing while LOW is suspended to show it is paused.
+            // Keep printing while LOW is paused to show it is not running.
             TickType_t start = xTaskGetTickCount();
             while ((xTaskGetTickCount() - start) < suspend_time) {
-                printf("[HIGH] LOW task is suspended...\n");
+                printf("[HIGH] LOW task is paused...\n");
                 vTaskDelay(pdMS_TO_TICKS(500));
             }
 
             printf("[HIGH] Resuming LOW task now.\n");
-            vTaskResume(g_low_task_handle);
+            task_signal_request_resume(&g_low_signal);
         }
 
         vTaskDelay(pdMS_TO_TICKS(500));
@@ -81,10 +101,13 @@ void task_high(void *pvParameter) {
  * @brief Main application entry point.
  *
  * Creates two tasks with different priorities. The high-priority task
- * periodically suspends and resumes the low-priority task to make
+ * periodically pauses and resumes the low-priority task to make
  * scheduling effects obvious in the console output.
  */
 void app_main() {
+    // Reset the signal before its receiver can run; bound once the handle exists
+    task_signal_init(&g_low_signal, NULL);
+
     // Low priority task (priority 3)
     xTaskCreate(
         task_low,           // Task function
@@ -92,8 +115,9 @@ void app_main() {
         2048,               // Stack size (words)
         NULL,               // Parameter
         3,                  // Priority
-        &g_low_task_handle  // Handle to control suspension/resumption
+        &g_low_task_handle  // Handle to control pause/resume
     );
+    task_signal_bind(&g_low_signal, g_low_task_handle);
 
     // High priority task (priority 8)
     xTaskCreate(
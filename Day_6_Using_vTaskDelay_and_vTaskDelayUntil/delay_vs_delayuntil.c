@@ -5,11 +5,24 @@
  * The program starts two tasks. One uses vTaskDelay() which may drift over time,
  * and the other uses vTaskDelayUntil() to keep a fixed 1 s cadence. Both print
  * timestamps in milliseconds derived from the RTOS tick count.
+ *
+ * Each task also marks its activations in a period_stats object
+ * (components/period_stats, add period_stats.c/.h to main/). Every 10 s a
+ * low-priority reporter prints the period error statistics and the
+ * accumulated drift, so the difference shows up as numbers: vTaskDelay()
+ * drifts by the loop body (printf) every period, vTaskDelayUntil() does not.
  */
 
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "period_stats.h"
+
+#define PERIOD_MS        1000
+#define STATS_REPORT_MS  10000
+
+static period_stats_t s_delay_stats;
+static period_stats_t s_delay_until_stats;
 
 /**
  * @brief Task that delays relatively using vTaskDelay().
@@ -21,8 +34,9 @@
  */
 void task_delay(void *pvParameter) {
     while (1) {
+        period_stats_mark(&s_delay_stats);
         printf("vTaskDelay: %lu ms\n", (unsigned long)(xTaskGetTickCount() * portTICK_PERIOD_MS));
-        vTaskDelay(pdMS_TO_TICKS(1000)); // Delay 1s
+        vTaskDelay(pdMS_TO_TICKS(PERIOD_MS)); // Delay 1s
     }
 }
 
@@ -37,8 +51,9 @@ void task_delay(void *pvParameter) {
 void task_delay_until(void *pvParameter) {
     TickType_t last_wake = xTaskGetTickCount();
     while (1) {
+        period_stats_mark(&s_delay_until_stats);
         printf("vTaskDelayUntil: %lu ms\n", (unsigned long)(xTaskGetTickCount() * portTICK_PERIOD_MS));
-        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(1000)); // Delay until next second
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(PERIOD_MS)); // Delay until next second
     }
 }
 
@@ -46,9 +61,14 @@ void task_delay_until(void *pvParameter) {
  * @brief Application entry point.
  *
  * Creates two tasks at priority 5: one using vTaskDelay() and one using
- * vTaskDelayUntil() to illustrate the difference in timing behavior.
+ * vTaskDelayUntil() to illustrate the difference in timing behavior, plus
+ * the period_stats reporter at priority 1.
  */
 void app_main() {
+    period_stats_init(&s_delay_stats, "vTaskDelay", PERIOD_STATS_TICKS_TO_US(pdMS_TO_TICKS(PERIOD_MS)), 0, 0);
+    period_stats_init(&s_delay_until_stats, "DelayUntil", PERIOD_STATS_TICKS_TO_US(pdMS_TO_TICKS(PERIOD_MS)), 0, 0);
+    period_stats_start_reporter(STATS_REPORT_MS, 1);
+
     xTaskCreate(task_delay, "TaskDelay", 2048, NULL, 5, NULL);
     xTaskCreate(task_delay_until, "TaskDelayUntil", 2048, NULL, 5, NULL);
 }
\ No newline at end of file
@@ -12,6 +12,19 @@
  * Use the console logs to observe the measured period jitter for each task.
  * Change LED_GPIO below to match your board's LED (e.g., 2 on many ESP32 dev boards).
  *
+ * Logging mode (USE_DEFERRED_LOG):
+ *   1 - tasks log through the deferred logger (components/deferred_log, add
+ *       deferred_log.c/.h to main/). The hot task only stores a binary
+ *       record; a priority-1 drain task does the formatting and UART write.
+ *   0 - tasks call ESP_LOGI() directly, so the UART write lands in the
+ *       measured period.
+ *
+ * Jitter statistics (components/period_stats, add period_stats.c/.h to main/):
+ * both tasks mark every activation, and a priority-1 reporter prints mean/stddev,
+ * min/max period error, a histogram, accumulated drift and missed deadlines
+ * every STATS_REPORT_MS. Compare USE_DEFERRED_LOG = 0 vs 1, and the sensor
+ * (vTaskDelayUntil) drift against the blink (vTaskDelay) drift.
+ *
  * Build: idf.py build
  * Flash: idf.py flash monitor
  */
@@ -23,11 +36,24 @@
 #include "esp_timer.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
+#include "period_stats.h"
 
 #define TAG                 "TIMING_DEMO"
 #define LED_GPIO            GPIO_NUM_2     // Change to your board's LED pin
 #define SAMPLING_PERIOD_MS  200            // Fixed-rate period for sensor task
 #define BLINK_PERIOD_MS     1000           // Target blink "period" using relative delay
+#define STATS_REPORT_MS     5000           // Interval of the period_stats report
+
+#ifndef USE_DEFERRED_LOG
+#define USE_DEFERRED_LOG    1              // 1: deferred logger, 0: ESP_LOGI in the task
+#endif
+
+#if USE_DEFERRED_LOG
+#include "deferred_log.h"
+#define TIMING_LOGI(tag, fmt, ...) DLOGI(tag, fmt, ##__VA_ARGS__)
+#else
+#define TIMING_LOGI(tag, fmt, ...) ESP_LOGI(tag, fmt, ##__VA_ARGS__)
+#endif
 
 // ------------------------ Forward Declarations ------------------------
 
@@ -36,6 +62,9 @@ static int  read_fake_sensor(void);
 static void sensor_sampling_task(void *arg);
 static void led_blink_task(void *arg);
 
+static period_stats_t s_sensor_stats;
+static period_stats_t s_blink_stats;
+
 // ------------------------ Helpers ------------------------
 
 /**
@@ -99,16 +128,17 @@ static void sensor_sampling_task(void *arg)
         int64_t now_us = esp_timer_get_time();
         int64_t dt_us  = now_us - t_prev_us;
         t_prev_us = now_us;
+        period_stats_mark_at(&s_sensor_stats, now_us);
 
         // Do (fast) work after the wakeup to keep schedule tight
         int sample = read_fake_sensor();
 
         // Log timing — expect dt ~= 200 ms with small jitter
-        ESP_LOGI(TAG,
-                 "[sensor] sample=%d  period=%.2f ms  (ticks=%" PRIu32 ")",
-                 sample,
-                 (double)dt_us / 1000.0,
-                 (uint32_t)period_ticks);
+        TIMING_LOGI(TAG,
+                    "[sensor] sample=%d  period=%.2f ms  (ticks=%" PRIu32 ")",
+                    sample,
+                    (double)dt_us / 1000.0,
+                    (uint32_t)period_ticks);
     }
 }
 
@@ -137,12 +167,13 @@ static void led_blink_task(void *arg)
         int64_t now_us = esp_timer_get_time();
         int64_t dt_us  = now_us - t_prev_us;
         t_prev_us = now_us;
+        period_stats_mark_at(&s_blink_stats, now_us);
 
         // Log timing — expect more variation than the sensor task
-        ESP_LOGI(TAG,
-                 "[blink] LED=%d  period=%.2f ms",
-                 level ? 1 : 0,
-                 (double)dt_us / 1000.0);
+        TIMING_LOGI(TAG,
+                    "[blink] LED=%d  period=%.2f ms",
+                    level ? 1 : 0,
+                    (double)dt_us / 1000.0);
 
         // Relative delay (accumulates drift if work varies)
         vTaskDelay(pdMS_TO_TICKS(BLINK_PERIOD_MS));
@@ -165,6 +196,20 @@ void app_main(void)
     ESP_LOGI(TAG, "Initializing...");
     init_led_gpio();
 
+    // Nominal periods; deadline slack defaults to 10% of the period
+    period_stats_init(&s_sensor_stats, "sensor", PERIOD_STATS_TICKS_TO_US(pdMS_TO_TICKS(SAMPLING_PERIOD_MS)), 0, 0);
+    period_stats_init(&s_blink_stats, "blink", PERIOD_STATS_TICKS_TO_US(pdMS_TO_TICKS(BLINK_PERIOD_MS)), 0, 0);
+    if (period_stats_start_reporter(STATS_REPORT_MS, 1) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start period_stats reporter");
+    }
+
+#if USE_DEFERRED_LOG
+    // Drain task below both timed tasks so formatting never preempts them
+    if (dlog_init(1, tskNO_AFFINITY) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start deferred logger");
+    }
+#endif
+
     // Create the fixed-rate sensor task (higher priority to reduce preemption jitter)
     BaseType_t ok1 = xTaskCreate(
         sensor_sampling_task,
@@ -188,6 +233,6 @@ void app_main(void)
     if (ok1 != pdPASS || ok2 != pdPASS) {
         ESP_LOGE(TAG, "Failed to create tasks (sensor=%ld, blink=%ld)", (long)ok1, (long)ok2);
     } else {
-        ESP_LOGI(TAG, "Tasks started. Watch the periods in the log.");
+        ESP_LOGI(TAG, "Tasks started. Watch the [PSTAT] reports for jitter and drift.");
     }
 }
\ No newline at end of file
@@ -13,6 +13,10 @@
  * Notes:
  *   - Adjust LED1_GPIO / LED2_GPIO to match your hardware.
  *   - Console output includes timestamps to visualize drift behavior.
+ *   - With USE_DEFERRED_LOG = 1 (default) the tasks log through the deferred
+ *     logger (components/deferred_log, add deferred_log.c/.h to main/), so the
+ *     UART write does not run inside the blink loops. Set it to 0 to use
+ *     ESP_LOGI() directly.
  */
 
 #include <stdio.h>
@@ -24,6 +28,17 @@
 
 #define TAG "DAY7"
 
+#ifndef USE_DEFERRED_LOG
+#define USE_DEFERRED_LOG 1
+#endif
+
+#if USE_DEFERRED_LOG
+#include "deferred_log.h"
+#define TIMING_LOGI(tag, fmt, ...) DLOGI(tag, fmt, ##__VA_ARGS__)
+#else
+#define TIMING_LOGI(tag, fmt, ...) ESP_LOGI(tag, fmt, ##__VA_ARGS__)
+#endif
+
 // === Adjust these for your board if necessary ===
 #ifndef LED1_GPIO
 #define LED1_GPIO GPIO_NUM_2   // Often has onboard LED on many DevKit boards
@@ -93,7 +108,7 @@ static void taskA_delay(void *pv)
         // Print a timestamp (ms) to visualize drift
         TickType_t now_ticks = xTaskGetTickCount();
         uint32_t now_ms = now_ticks * portTICK_PERIOD_MS;
-        ESP_LOGI(TAG, "[A] t=%" PRIu32 " ms, iter=%" PRIu32, now_ms, iteration);
+        TIMING_LOGI(TAG, "[A] t=%" PRIu32 " ms, iter=%" PRIu32, now_ms, iteration);
 
         // Relative delay: next wake-up occurs 'period_ticks' after this call
         vTaskDelay(period_ticks);
@@ -122,7 +137,7 @@ static void taskB_delay_until(void *pv)
 
         TickType_t now_ticks = xTaskGetTickCount();
         uint32_t now_ms = now_ticks * portTICK_PERIOD_MS;
-        ESP_LOGI(TAG, "[B] t=%" PRIu32 " ms, iter=%" PRIu32, now_ms, iteration);
+        TIMING_LOGI(TAG, "[B] t=%" PRIu32 " ms, iter=%" PRIu32, now_ms, iteration);
 
         // Absolute delay: wake exactly every 'period_ticks' since last_wake
         vTaskDelayUntil(&last_wake, period_ticks);
@@ -152,7 +167,7 @@ static void task_status(void *pv)
         // Report uptime and tick count
         TickType_t ticks = xTaskGetTickCount();
         uint32_t ms = ticks * portTICK_PERIOD_MS;
-        ESP_LOGI(TAG, "[STATUS] uptime ~%" PRIu32 " ms (%" PRIu32 "s)", ms, seconds);
+        TIMING_LOGI(TAG, "[STATUS] uptime ~%" PRIu32 " ms (%" PRIu32 "s)", ms, seconds);
     }
 }
 
@@ -168,6 +183,13 @@ void app_main(void)
     configure_led(LED1_GPIO);
     configure_led(LED2_GPIO);
 
+#if USE_DEFERRED_LOG
+    // Drain task below every blink task so formatting never delays a toggle
+    if (dlog_init(1, tskNO_AFFINITY) != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start deferred logger");
+    }
+#endif
+
     // Create tasks
     // Priorities kept the same to let the scheduler time-slice fairly
     BaseType_t okA = xTaskCreate(taskA_delay, "TaskA_Delay", 2048, NULL, 5, NULL);
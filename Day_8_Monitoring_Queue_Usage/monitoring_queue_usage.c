@@ -7,16 +7,24 @@
  * using FreeRTOS API in ESP-IDF. A producer task writes integers into a queue,
  * while a consumer task reads them. A monitor task periodically checks the
  * number of items waiting in the queue using uxQueueMessagesWaiting().
+ *
+ * The queue is wrapped by queue_telemetry (components/queue_telemetry, add
+ * queue_telemetry.c/.h to main/), which measures on every send/receive
+ * rather than once per poll. Each second the monitor also prints the
+ * high watermark, full/empty timeouts and the p50/p99/max
+ * enqueue-to-dequeue latency, so bursts between polls are not lost.
  */
 #include <stdio.h>
+#include <inttypes.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
+#include "queue_telemetry.h"
 
 #define QUEUE_LENGTH 10
 #define QUEUE_ITEM_SIZE sizeof(int)
 
-static QueueHandle_t queue;
+QUEUE_TELEMETRY_DEFINE(queue, QUEUE_LENGTH, QUEUE_ITEM_SIZE);
 
 /**
  * @brief Producer task that generates numbers and pushes them into the queue.
@@ -24,7 +32,7 @@ static QueueHandle_t queue;
 void producer_task(void *pvParameters) {
     int count = 0;
     while (1) {
-        if (xQueueSend(queue, &count, pdMS_TO_TICKS(100)) == pdPASS) {
+        if (queue_telemetry_send(&queue, &count, pdMS_TO_TICKS(100)) == pdPASS) {
             printf("Producer: Sent %d\n", count);
             count++;
         } else {
@@ -40,7 +48,7 @@ void producer_task(void *pvParameters) {
 void consumer_task(void *pvParameters) {
     int value;
     while (1) {
-        if (xQueueReceive(queue, &value, pdMS_TO_TICKS(500)) == pdPASS) {
+        if (queue_telemetry_receive(&queue, &value, pdMS_TO_TICKS(500)) == pdPASS) {
             printf("Consumer: Received %d\n", value);
         } else {
             printf("Consumer: Queue empty!\n");
@@ -50,12 +58,20 @@ void consumer_task(void *pvParameters) {
 }
 
 /**
- * @brief Monitor task that checks how many messages are waiting in the queue.
+ * @brief Monitor task that reports queue occupancy and latency once per second.
+ *
+ * Prints the current number of waiting messages plus the telemetry recorded
+ * since the previous report (each report starts a new window).
  */
 void monitor_task(void *pvParameters) {
+    queue_telemetry_report_t r;
     while (1) {
-        UBaseType_t waiting = uxQueueMessagesWaiting(queue);
-        printf("Monitor: Queue has %lu messages waiting\n", (unsigned long)waiting);
+        queue_telemetry_snapshot(&queue, &r, true);
+        printf("Monitor: Queue has %lu messages waiting (hwm %lu/%lu, full %" PRIu32 ", empty %" PRIu32 ")\n",
+               (unsigned long)r.waiting, (unsigned long)r.high_watermark, (unsigned long)r.length,
+               r.full_timeouts, r.empty_timeouts);
+        printf("Monitor: latency p50<=%" PRIu32 " us p99<=%" PRIu32 " us max=%" PRIu32 " us (n=%" PRIu32 ")\n",
+               r.p50_us, r.p99_us, r.max_us, r.received);
         vTaskDelay(pdMS_TO_TICKS(1000));
     }
 }
@@ -64,10 +80,8 @@ void monitor_task(void *pvParameters) {
  * @brief Main entry point – initializes queue and tasks.
  */
 void app_main(void) {
-    // Create a queue to hold integers
-    queue = xQueueCreate(QUEUE_LENGTH, QUEUE_ITEM_SIZE);
-
-    if (queue == NULL) {
+    // Create the instrumented queue that holds integers
+    if (queue_telemetry_init(&queue) != ESP_OK) {
         printf("Failed to create queue!\n");
         return;
     }
@@ -6,6 +6,19 @@
  *  - producer_task: enqueues incrementing integers every 500 ms (100 ms send timeout).
  *  - consumer_task: dequeues and prints integers (1000 ms receive timeout).
  * It illustrates basic inter-task communication and back-pressure when the queue is full/empty.
+ *
+ * Batch benchmark mode (QUEUE_BATCH_BENCHMARK = 1):
+ *  Replaces the demo with a benchmark of the batched queue layer in
+ *  components/queue_batch (add queue_batch.c/.h to main/). A 10 kHz event
+ *  source feeds a consumer that drains batches of 1, 8 and 32 items, and the
+ *  table reports delivered items/s, consumer wakeups (context switches) per
+ *  item, and flat-out throughput when the producer also sends in batches.
+ *
+ * Stack profiling (STACK_PROFILE = 1):
+ *  Runs components/stack_profiler next to the tasks (add stack_profiler.c/.h
+ *  and task_factory.h to main/, and enable CONFIG_FREERTOS_USE_TRACE_FACILITY).
+ *  Every minute it prints the worst-case stack use of every task and a
+ *  stack_profile.h block with recommended depths in place of the copied 2048.
  */
 
 #include <stdio.h>
@@ -15,6 +28,20 @@
 
 #define QUEUE_LENGTH 5
 
+// Set to 1 to run the batched-queue benchmark instead of the demo.
+#ifndef QUEUE_BATCH_BENCHMARK
+#define QUEUE_BATCH_BENCHMARK 0
+#endif
+
+// Set to 1 to profile the worst-case stack use of every task.
+#ifndef STACK_PROFILE
+#define STACK_PROFILE 0
+#endif
+
+#if STACK_PROFILE
+#include "stack_profiler.h"
+#endif
+
 /** @brief Global queue handle shared by producer and consumer tasks. */
 QueueHandle_t queue;
 
@@ -62,14 +89,152 @@ void consumer_task(void *pvParameters) {
     }
 }
 
+#if QUEUE_BATCH_BENCHMARK
+// ------------------------ Batch benchmark mode ------------------------
+
+#include <stdbool.h>
+#include "esp_timer.h"
+#include "queue_batch.h"
+
+#define BENCH_EVENT_PERIOD_US   100         // 10 kHz event source
+#define BENCH_RUN_MS            2000        // Duration of each paced run
+#define BENCH_FLOOD_ITEMS       51200       // Items per flat-out run (multiple of 32)
+#define BENCH_QUEUE_LENGTH      64
+#define BENCH_MAX_BATCH         32
+
+QUEUE_BATCH_DEFINE(s_event_queue, BENCH_QUEUE_LENGTH, sizeof(int));
+
+static const UBaseType_t s_batch_sizes[] = { 1, 8, 32 };
+static volatile UBaseType_t s_batch_size = 1;
+
+/**
+ * @brief esp_timer callback: posts one event per period, like an event source.
+ *
+ * @param arg Unused.
+ */
+static void bench_event_cb(void *arg)
+{
+    static int seq = 0;
+    if (queue_send_batch(&s_event_queue, &seq, 1, 0) == 1) {
+        seq++;
+    }
+}
+
+/**
+ * @brief Consumer that drains up to s_batch_size items per wakeup.
+ *
+ * @param pvParameters Optional task parameter (unused).
+ */
+static void batch_consumer_task(void *pvParameters)
+{
+    (void)pvParameters;
+    int items[BENCH_MAX_BATCH];
+    while (1) {
+        queue_receive_batch(&s_event_queue, items, s_batch_size, pdMS_TO_TICKS(10));
+    }
+}
+
+/**
+ * @brief Flat-out producer: sends BENCH_FLOOD_ITEMS in chunks of s_batch_size.
+ *
+ * @param pvParameters Task to notify when all items were sent.
+ */
+static void batch_flood_task(void *pvParameters)
+{
+    TaskHandle_t controller = (TaskHandle_t)pvParameters;
+    int items[BENCH_MAX_BATCH];
+    int seq = 0;
+
+    while (seq < BENCH_FLOOD_ITEMS) {
+        UBaseType_t n = s_batch_size;
+        for (UBaseType_t i = 0; i < n; i++) {
+            items[i] = seq + (int)i;
+        }
+        seq += (int)queue_send_batch(&s_event_queue, items, n, portMAX_DELAY);
+    }
+    xTaskNotifyGive(controller);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Wait until the consumer has drained the queue.
+ */
+static void bench_wait_drained(void)
+{
+    while (queue_batch_waiting(&s_event_queue) > 0) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    vTaskDelay(pdMS_TO_TICKS(20));  // Let a partial batch time out
+}
+
+/**
+ * @brief Run the paced and flat-out measurements for every batch size.
+ */
+static void batch_benchmark_run(void)
+{
+    queue_batch_init(&s_event_queue);
+    xTaskCreate(batch_consumer_task, "BatchConsumer", 2048, NULL, 5, NULL);
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = bench_event_cb,
+        .name = "bench_events",
+    };
+    esp_timer_handle_t timer;
+    ESP_ERROR_CHECK(esp_timer_create(&timer_args, &timer));
+
+    printf("\nbatch | paced items/s | switches/item | flat-out items/s\n");
+    printf("------+---------------+---------------+-----------------\n");
+
+    for (size_t i = 0; i < sizeof(s_batch_sizes) / sizeof(s_batch_sizes[0]); i++) {
+        queue_batch_stats_t st;
+        s_batch_size = s_batch_sizes[i];
+        queue_batch_set_trigger_level(&s_event_queue, s_batch_size);
+
+        // 1) Paced: 10 kHz events, count consumer wakeups per item.
+        queue_batch_get_stats(&s_event_queue, &st, true);
+        int64_t t0 = esp_timer_get_time();
+        esp_timer_start_periodic(timer, BENCH_EVENT_PERIOD_US);
+        vTaskDelay(pdMS_TO_TICKS(BENCH_RUN_MS));
+        esp_timer_stop(timer);
+        bench_wait_drained();
+        int64_t paced_us = esp_timer_get_time() - t0;
+        queue_batch_get_stats(&s_event_queue, &st, true);
+
+        double paced_rate = st.items_received * 1e6 / (double)paced_us;
+        double switches = st.items_received ? (double)st.rx_wakeups / st.items_received : 0.0;
+
+        // 2) Flat-out: a producer task sends batches as fast as it can.
+        t0 = esp_timer_get_time();
+        xTaskCreate(batch_flood_task, "BatchFlood", 2048, xTaskGetCurrentTaskHandle(), 5, NULL);
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        while (queue_batch_waiting(&s_event_queue) > 0) {
+            taskYIELD();
+        }
+        int64_t flood_us = esp_timer_get_time() - t0;
+        bench_wait_drained();
+
+        printf("%5u | %13.0f | %13.3f | %16.0f\n",
+               (unsigned)s_batch_size, paced_rate, switches,
+               BENCH_FLOOD_ITEMS * 1e6 / (double)flood_us);
+    }
+    printf("(switches/item counts consumer block/wake cycles per delivered item)\n");
+}
+#endif  // QUEUE_BATCH_BENCHMARK
+
 /**
  * @brief Application entry point: creates the queue and both tasks.
  *
  * Allocates a queue of length QUEUE_LENGTH to carry int items. If creation
  * succeeds, it spawns the producer and consumer tasks at priority 5; otherwise,
- * it logs a failure and returns.
+ * it logs a failure and returns. With QUEUE_BATCH_BENCHMARK set it runs the
+ * batch benchmark instead.
  */
 void app_main(void) {
+#if QUEUE_BATCH_BENCHMARK
+    batch_benchmark_run();
+    return;
+#endif
+
     queue = xQueueCreate(QUEUE_LENGTH, sizeof(int));
     if (queue == NULL) {
         printf("Failed to create queue\n");
@@ -78,4 +243,8 @@ void app_main(void) {
 
     xTaskCreate(producer_task, "Producer", 2048, NULL, 5, NULL);
     xTaskCreate(consumer_task, "Consumer", 2048, NULL, 5, NULL);
+
+#if STACK_PROFILE
+    stack_profiler_start(NULL);
+#endif
 }
\ No newline at end of file
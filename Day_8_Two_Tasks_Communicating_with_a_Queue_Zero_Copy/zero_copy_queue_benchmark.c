@@ -0,0 +1,252 @@
+/**
+ * @file zero_copy_queue_benchmark.c
+ * @brief Throughput benchmark: by-value queue vs zero-copy pooled-buffer queue.
+ *
+ * The Day 8 producer/consumer example copies every item into the queue with
+ * xQueueSend() and out again with xQueueReceive(). For an int that is free,
+ * for a 1500-byte frame it is two memcpy() calls per hop. This benchmark runs
+ * the same producer/consumer pair twice for each payload size:
+ *   1) by-value : queue item size == payload size (two copies per frame)
+ *   2) zero-copy: frames live in a buffer_pool_t, only pointers are queued
+ *
+ * Both variants write the same frame header in the producer and check it in
+ * the consumer, so the difference in the table is the cost of moving data.
+ *
+ * Files needed in your project's main/ folder:
+ *   - zero_copy_queue_benchmark.c (this file)
+ *   - components/buffer_pool/buffer_pool.c and buffer_pool.h
+ *
+ * Build: idf.py build
+ * Flash: idf.py flash monitor
+ */
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "esp_log.h"
+#include "buffer_pool.h"
+
+#define TAG                 "ZC_BENCH"
+#define BENCH_ITEMS         20000           // Frames transferred per run
+#define BENCH_QUEUE_LENGTH  8               // Same depth for both variants
+#define BENCH_MAX_PAYLOAD   1500            // Largest payload in the table
+#define BENCH_POOL_BLOCKS   (BENCH_QUEUE_LENGTH + 2)   // Queue + one held at each end
+#define BENCH_PRIORITY      5
+
+#define BENCH_PRODUCER_CORE 0
+#if portNUM_PROCESSORS > 1
+#define BENCH_CONSUMER_CORE 1               // Cross-core hop, as in a real pipeline
+#else
+#define BENCH_CONSUMER_CORE 0
+#endif
+
+static const size_t s_payload_sizes[] = { 16, 256, 512, 1024, 1500 };
+
+/** @brief Header written by the producer at the start of every frame. */
+typedef struct {
+    uint32_t seq;
+    uint32_t len;
+} frame_hdr_t;
+
+/** @brief Parameters and result of one benchmark run. */
+typedef struct {
+    size_t payload;             // Bytes per frame
+    TaskHandle_t controller;    // Notified when the consumer is done
+    uint32_t errors;            // Out-of-order or corrupt frames seen
+    int64_t t_start_us;
+    int64_t t_end_us;
+} bench_run_t;
+
+// ------------------------ Static storage ------------------------
+
+// By-value variant: the queue ring must hold full payloads.
+static uint8_t s_value_storage[BENCH_QUEUE_LENGTH * BENCH_MAX_PAYLOAD];
+static StaticQueue_t s_value_queue_buf;
+static QueueHandle_t s_value_queue;
+
+// Zero-copy variant: payloads live in the pool, the queue moves pointers.
+BUFFER_POOL_DEFINE(s_frame_pool, BENCH_MAX_PAYLOAD, BENCH_POOL_BLOCKS);
+BUFFER_QUEUE_DEFINE(s_frame_queue, BENCH_QUEUE_LENGTH);
+
+// ------------------------ Helpers ------------------------
+
+/**
+ * @brief Write the frame header the consumer will check.
+ */
+static inline void write_frame(uint8_t *dst, uint32_t seq, size_t len)
+{
+    frame_hdr_t hdr = { .seq = seq, .len = (uint32_t)len };
+    memcpy(dst, &hdr, sizeof(hdr));
+}
+
+/**
+ * @brief Check a received frame against the expected sequence number.
+ *
+ * @return true if the header matches.
+ */
+static inline bool check_frame(const uint8_t *src, uint32_t expected_seq, size_t len)
+{
+    frame_hdr_t hdr;
+    memcpy(&hdr, src, sizeof(hdr));
+    return hdr.seq == expected_seq && hdr.len == (uint32_t)len;
+}
+
+// ------------------------ By-value tasks ------------------------
+
+/**
+ * @brief Producer: builds each frame in a local buffer and copies it into the queue.
+ *
+ * @param arg bench_run_t describing the run.
+ */
+static void value_producer_task(void *arg)
+{
+    bench_run_t *run = (bench_run_t *)arg;
+    static uint8_t frame[BENCH_MAX_PAYLOAD];
+
+    run->t_start_us = esp_timer_get_time();
+    for (uint32_t seq = 0; seq < BENCH_ITEMS; seq++) {
+        write_frame(frame, seq, run->payload);
+        xQueueSend(s_value_queue, frame, portMAX_DELAY);     // copy #1
+    }
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Consumer: copies each frame out of the queue and checks it.
+ *
+ * @param arg bench_run_t describing the run.
+ */
+static void value_consumer_task(void *arg)
+{
+    bench_run_t *run = (bench_run_t *)arg;
+    static uint8_t frame[BENCH_MAX_PAYLOAD];
+
+    for (uint32_t seq = 0; seq < BENCH_ITEMS; seq++) {
+        xQueueReceive(s_value_queue, frame, portMAX_DELAY);  // copy #2
+        if (!check_frame(frame, seq, run->payload)) {
+            run->errors++;
+        }
+    }
+    run->t_end_us = esp_timer_get_time();
+    xTaskNotifyGive(run->controller);
+    vTaskDelete(NULL);
+}
+
+// ------------------------ Zero-copy tasks ------------------------
+
+/**
+ * @brief Producer: writes each frame in place in a pool block and sends the pointer.
+ *
+ * @param arg bench_run_t describing the run.
+ */
+static void zc_producer_task(void *arg)
+{
+    bench_run_t *run = (bench_run_t *)arg;
+
+    run->t_start_us = esp_timer_get_time();
+    for (uint32_t seq = 0; seq < BENCH_ITEMS; seq++) {
+        pool_buf_t *buf = buffer_pool_acquire(&s_frame_pool, portMAX_DELAY);
+        write_frame(buf->data, seq, run->payload);
+        buf->len = run->payload;
+        buffer_queue_send(&s_frame_queue, buf, portMAX_DELAY);  // ownership -> consumer
+    }
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Consumer: reads each frame in place and returns the block to the pool.
+ *
+ * @param arg bench_run_t describing the run.
+ */
+static void zc_consumer_task(void *arg)
+{
+    bench_run_t *run = (bench_run_t *)arg;
+
+    for (uint32_t seq = 0; seq < BENCH_ITEMS; seq++) {
+        pool_buf_t *buf = buffer_queue_receive(&s_frame_queue, portMAX_DELAY);
+        if (buf->len != run->payload || !check_frame(buf->data, seq, buf->len)) {
+            run->errors++;
+        }
+        buffer_pool_release(buf);                               // ownership -> pool
+    }
+    run->t_end_us = esp_timer_get_time();
+    xTaskNotifyGive(run->controller);
+    vTaskDelete(NULL);
+}
+
+// ------------------------ Runner ------------------------
+
+/**
+ * @brief Start a producer/consumer pair and wait for the consumer to finish.
+ *
+ * @return Elapsed time of the run in microseconds.
+ */
+static int64_t run_pair(TaskFunction_t producer, TaskFunction_t consumer, bench_run_t *run)
+{
+    run->controller = xTaskGetCurrentTaskHandle();
+    run->errors = 0;
+
+    // Consumer first so it is already blocked when the first frame arrives.
+    xTaskCreatePinnedToCore(consumer, "bench_cons", 3072, run, BENCH_PRIORITY, NULL, BENCH_CONSUMER_CORE);
+    xTaskCreatePinnedToCore(producer, "bench_prod", 3072, run, BENCH_PRIORITY, NULL, BENCH_PRODUCER_CORE);
+
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    vTaskDelay(pdMS_TO_TICKS(10));      // Let the idle task reclaim both TCBs
+    return run->t_end_us - run->t_start_us;
+}
+
+/**
+ * @brief Measure one payload size with both variants and print a table row.
+ */
+static void bench_payload(size_t payload)
+{
+    bench_run_t run = { .payload = payload };
+
+    // By-value: re-create the queue in the static ring with this item size.
+    s_value_queue = xQueueCreateStatic(BENCH_QUEUE_LENGTH, payload, s_value_storage, &s_value_queue_buf);
+    int64_t value_us = run_pair(value_producer_task, value_consumer_task, &run);
+    uint32_t value_err = run.errors;
+    vQueueDelete(s_value_queue);
+
+    int64_t zc_us = run_pair(zc_producer_task, zc_consumer_task, &run);
+    uint32_t zc_err = run.errors;
+
+    double value_per = (double)value_us / BENCH_ITEMS;
+    double zc_per = (double)zc_us / BENCH_ITEMS;
+
+    printf("%7u | %9.2f %10.0f | %9.2f %10.0f | %6.2fx | %" PRIu32 "/%" PRIu32 "\n",
+           (unsigned)payload,
+           value_per, 1e6 / value_per,
+           zc_per, 1e6 / zc_per,
+           value_per / zc_per,
+           value_err, zc_err);
+}
+
+// ------------------------ Entry Point ------------------------
+
+/**
+ * @brief Application entry point: set up static objects and run every payload size.
+ */
+void app_main(void)
+{
+    ESP_ERROR_CHECK(buffer_pool_init(&s_frame_pool));
+    ESP_ERROR_CHECK(buffer_queue_init(&s_frame_queue));
+
+    ESP_LOGI(TAG, "%d frames per run, queue depth %d, producer core %d -> consumer core %d",
+             BENCH_ITEMS, BENCH_QUEUE_LENGTH, BENCH_PRODUCER_CORE, BENCH_CONSUMER_CORE);
+
+    printf("\n        |       by-value       |       zero-copy      |\n");
+    printf("payload |   us/item    items/s |   us/item    items/s | speedup | errors\n");
+    printf("--------+----------------------+----------------------+---------+-------\n");
+    for (size_t i = 0; i < sizeof(s_payload_sizes) / sizeof(s_payload_sizes[0]); i++) {
+        bench_payload(s_payload_sizes[i]);
+    }
+
+    ESP_LOGI(TAG, "Done. Pool blocks free after runs: %u/%u",
+             (unsigned)buffer_pool_available(&s_frame_pool), (unsigned)BENCH_POOL_BLOCKS);
+}
@@ -0,0 +1,207 @@
+/**
+ * @file deferred_isr_gptimer_demo.c
+ * @brief Deferred interrupt handling: a gptimer "sensor" ISR and a button ISR feed one pinned handler task.
+ *
+ * The Day 8 examples pass data between tasks. Here the producer is an
+ * interrupt. Each ISR only timestamps, hands off and returns. The work
+ * runs in the components/deferred_isr handler task on HANDLER_CORE:
+ *   - "sensor": a gptimer alarm every SAMPLE_PERIOD_US posts a sequence
+ *     number into the ISR-safe ring. Its bottom half spends SENSOR_WORK_US
+ *     "processing" the sample.
+ *   - "button": the BOOT button (GPIO0, falling edge) only signals.
+ *     Contact bounce arrives as a burst of edges that is coalesced into one
+ *     handler call, which reports how many edges it covered.
+ *
+ * Every REPORT_PERIOD_MS deferred_isr_report() prints, in µs, where the
+ * time from ISR entry to the end of the bottom half goes:
+ *   [DISR] sensor n=2000 drop=0 | isr 1/1/4 wake 8/10/31 run 40/41/52 | total 50/52/84 us
+ *
+ * The load task busy-waits LOAD_BUSY_MS out of every LOAD_PERIOD_MS on
+ * HANDLER_CORE. With LOAD_ABOVE_HANDLER = 0 it sits below the handler and
+ * hardly shows up in "wake". With LOAD_ABOVE_HANDLER = 1 it preempts the
+ * handler. "wake" max then grows to about LOAD_BUSY_MS. This is a common
+ * reason bottom halves take several hundred µs: the ISR is short, but the
+ * handler task waits behind other work.
+ *
+ * The ring absorbs that wait. A 3 ms burst leaves about 3 samples queued,
+ * far below DEFERRED_ISR_RING_SIZE (64), so nothing is lost. To see the
+ * ring overflow, build with LOAD_ABOVE_HANDLER=1, LOAD_BUSY_MS=100 and
+ * LOAD_PERIOD_MS=200: each burst holds back about 100 samples, the ring
+ * keeps 64 and drops the rest, about 360 per report ("drop=" and
+ * "[DEMO] samples lost").
+ *
+ * Files needed in your project's main/ folder:
+ *   - deferred_isr_gptimer_demo.c (this file)
+ *   - components/deferred_isr/deferred_isr.c and deferred_isr.h
+ *
+ * Target Platform: ESP32 with ESP-IDF v5.x
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gptimer.h"
+#include "driver/gpio.h"
+#include "esp_rom_sys.h"
+#include "esp_log.h"
+#include "deferred_isr.h"
+
+#define TAG "DAY9"
+
+#define SAMPLE_PERIOD_US    1000    // gptimer alarm period
+#define SENSOR_WORK_US      40      // Simulated bottom-half processing
+#define BUTTON_GPIO         GPIO_NUM_0
+#define HANDLER_PRIORITY    10
+#define HANDLER_CORE        1
+#define REPORT_PERIOD_MS    2000
+
+#ifndef LOAD_ABOVE_HANDLER
+#define LOAD_ABOVE_HANDLER  0       // 1: competing task preempts the handler
+#endif
+#ifndef LOAD_BUSY_MS
+#define LOAD_BUSY_MS        3       // Over 64 ms (ring size at 1 kHz) above the handler drops samples
+#endif
+#ifndef LOAD_PERIOD_MS
+#define LOAD_PERIOD_MS      10
+#endif
+
+_Static_assert(LOAD_BUSY_MS < LOAD_PERIOD_MS, "the load task must leave the handler's core some time");
+
+static deferred_isr_source_t s_sensor_src;
+static deferred_isr_source_t s_button_src;
+static uint32_t s_seq;              // Written by the timer ISR only
+static uint32_t s_last_seq;         // Written by the handler only
+static uint32_t s_gaps;
+
+// ------------------------ ISRs (top halves) ------------------------
+
+/**
+ * @brief gptimer alarm: stamp, post the sample number, return.
+ */
+static bool IRAM_ATTR sensor_alarm_isr(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *ctx)
+{
+    int64_t t = deferred_isr_stamp();
+    BaseType_t hpw = pdFALSE;
+
+    deferred_isr_post_from_isr(&s_sensor_src, ++s_seq, t, &hpw);
+    return hpw == pdTRUE;           // gptimer yields for us when true
+}
+
+/**
+ * @brief BOOT button edge: signal only, bounces coalesce.
+ */
+static void IRAM_ATTR button_isr(void *arg)
+{
+    int64_t t = deferred_isr_stamp();
+    BaseType_t hpw = pdFALSE;
+
+    deferred_isr_signal_from_isr(&s_button_src, t, &hpw);
+    if (hpw == pdTRUE) {
+        portYIELD_FROM_ISR(hpw);
+    }
+}
+
+// ------------------------ Bottom halves ------------------------
+
+/**
+ * @brief Processes one sample; counts samples lost to ring overruns.
+ */
+static void sensor_bottom_half(void *arg, const deferred_isr_event_t *ev)
+{
+    if (s_last_seq != 0 && ev->data != s_last_seq + 1) {
+        s_gaps += ev->data - s_last_seq - 1;
+    }
+    s_last_seq = ev->data;
+    esp_rom_delay_us(SENSOR_WORK_US);
+}
+
+/**
+ * @brief Handles one press; ev->data is the number of edges coalesced.
+ */
+static void button_bottom_half(void *arg, const deferred_isr_event_t *ev)
+{
+    ESP_LOGI(TAG, "button: %" PRIu32 " edge(s) in one call", ev->data);
+}
+
+// ------------------------ Tasks ------------------------
+
+/**
+ * @brief Competing work on the handler's core.
+ *
+ * @param pvParameters Unused.
+ */
+static void load_task(void *pvParameters)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        esp_rom_delay_us(LOAD_BUSY_MS * 1000);
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(LOAD_PERIOD_MS));
+    }
+}
+
+/**
+ * @brief Prints the latency breakdown every REPORT_PERIOD_MS.
+ *
+ * @param pvParameters Unused.
+ */
+static void report_task(void *pvParameters)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(REPORT_PERIOD_MS));
+        deferred_isr_report();
+        printf("[DEMO] samples lost so far: %" PRIu32 "\n", s_gaps);
+    }
+}
+
+/**
+ * @brief Starts the handler, the interrupt sources and the helper tasks.
+ */
+void app_main(void)
+{
+    ESP_ERROR_CHECK(deferred_isr_init(HANDLER_PRIORITY, HANDLER_CORE));
+    ESP_ERROR_CHECK(deferred_isr_register(&s_sensor_src, "sensor", sensor_bottom_half, NULL));
+    ESP_ERROR_CHECK(deferred_isr_register(&s_button_src, "button", button_bottom_half, NULL));
+
+    // Button: falling edge on the BOOT pin
+    gpio_config_t io = {
+        .pin_bit_mask = 1ULL << BUTTON_GPIO,
+        .mode = GPIO_MODE_INPUT,
+        .pull_up_en = GPIO_PULLUP_ENABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_NEGEDGE
+    };
+    ESP_ERROR_CHECK(gpio_config(&io));
+    ESP_ERROR_CHECK(gpio_install_isr_service(0));
+    ESP_ERROR_CHECK(gpio_isr_handler_add(BUTTON_GPIO, button_isr, NULL));
+
+    // Load and report tasks; the load shares the handler's core
+    UBaseType_t load_prio = LOAD_ABOVE_HANDLER ? HANDLER_PRIORITY + 1 : HANDLER_PRIORITY - 1;
+    xTaskCreatePinnedToCore(load_task, "load", 2048, NULL, load_prio, NULL, HANDLER_CORE);
+    xTaskCreatePinnedToCore(report_task, "report", 3072, NULL, 2, NULL, 0);
+
+    // Sensor: 1 MHz gptimer, auto-reload alarm every SAMPLE_PERIOD_US
+    gptimer_handle_t timer = NULL;
+    gptimer_config_t timer_cfg = {
+        .clk_src = GPTIMER_CLK_SRC_DEFAULT,
+        .direction = GPTIMER_COUNT_UP,
+        .resolution_hz = 1000000,
+    };
+    ESP_ERROR_CHECK(gptimer_new_timer(&timer_cfg, &timer));
+    gptimer_event_callbacks_t cbs = { .on_alarm = sensor_alarm_isr };
+    ESP_ERROR_CHECK(gptimer_register_event_callbacks(timer, &cbs, NULL));
+    gptimer_alarm_config_t alarm = {
+        .alarm_count = SAMPLE_PERIOD_US,
+        .reload_count = 0,
+        .flags.auto_reload_on_alarm = true,
+    };
+    ESP_ERROR_CHECK(gptimer_set_alarm_action(timer, &alarm));
+    ESP_ERROR_CHECK(gptimer_enable(timer));
+    ESP_ERROR_CHECK(gptimer_start(timer));
+
+    ESP_LOGI(TAG, "sensor every %d us, handler prio %d on core %d, load prio %d",
+             SAMPLE_PERIOD_US, HANDLER_PRIORITY, HANDLER_CORE, (int)load_prio);
+}
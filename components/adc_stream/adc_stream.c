@@ -0,0 +1,188 @@
+/**
+ * @file adc_stream.c
+ * @brief ADC continuous-mode frames handed to a task by pointer (see adc_stream.h).
+ *
+ * The ISR side only posts the pointer, so the driver's conversion-done
+ * callback stays a single notify call. A NULL pointer is the stop request:
+ * the task answers by giving s_exited and deleting itself, so it is never
+ * deleted in the middle of a callback.
+ */
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "soc/soc_caps.h"
+#include "adc_stream.h"
+
+static adc_continuous_handle_t s_adc;
+static TaskHandle_t s_task;
+static SemaphoreHandle_t s_exited;
+static adc_stream_config_t s_cfg;
+static size_t s_frame_bytes;
+static adc_stream_stats_t s_st;
+static int64_t s_since_us;
+static DRAM_ATTR portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ------------------------ ISR side ------------------------
+
+static bool IRAM_ATTR on_conv_done(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata, void *arg)
+{
+    BaseType_t hpw = pdFALSE;
+    if (xTaskNotifyFromISR(s_task, (uint32_t)(uintptr_t)edata->conv_frame_buffer,
+                           eSetValueWithoutOverwrite, &hpw) != pdPASS) {
+        portENTER_CRITICAL_ISR(&s_lock);
+        s_st.overruns++;            // Previous frame not collected yet: drop this one
+        portEXIT_CRITICAL_ISR(&s_lock);
+    }
+    return hpw == pdTRUE;
+}
+
+static bool IRAM_ATTR on_pool_ovf(adc_continuous_handle_t handle, const adc_continuous_evt_data_t *edata, void *arg)
+{
+    portENTER_CRITICAL_ISR(&s_lock);
+    s_st.pool_ovf++;
+    portEXIT_CRITICAL_ISR(&s_lock);
+    return false;
+}
+
+// ------------------------ Task ------------------------
+
+/**
+ * @brief Waits for frame pointers and runs the callback on each frame in place.
+ *
+ * @param arg Unused.
+ */
+static void adc_stream_task(void *arg)
+{
+    const size_t n = s_frame_bytes / SOC_ADC_DIGI_RESULT_BYTES;
+    uint32_t value;
+
+    while (1) {
+        xTaskNotifyWait(0, 0, &value, portMAX_DELAY);
+        if (value == 0) {
+            break;
+        }
+
+        int64_t t0 = esp_timer_get_time();
+        s_cfg.cb((const adc_digi_output_data_t *)(uintptr_t)value, n, s_cfg.arg);
+        int64_t busy = esp_timer_get_time() - t0;
+
+        portENTER_CRITICAL(&s_lock);
+        s_st.frames++;
+        s_st.samples += (uint32_t)n;
+        s_st.busy_us += (uint64_t)busy;
+        portEXIT_CRITICAL(&s_lock);
+    }
+
+    xSemaphoreGive(s_exited);
+    vTaskDelete(NULL);
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t adc_stream_start(const adc_stream_config_t *cfg)
+{
+    if (cfg == NULL || cfg->cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_adc != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    s_cfg = *cfg;
+    s_cfg.sample_hz = s_cfg.sample_hz ? s_cfg.sample_hz : 20000;
+    s_cfg.frame_samples = s_cfg.frame_samples ? s_cfg.frame_samples : 256;
+    s_cfg.priority = s_cfg.priority ? s_cfg.priority : 10;
+    if (s_cfg.sample_hz < SOC_ADC_SAMPLE_FREQ_THRES_LOW || s_cfg.sample_hz > SOC_ADC_SAMPLE_FREQ_THRES_HIGH) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_frame_bytes = s_cfg.frame_samples * SOC_ADC_DIGI_RESULT_BYTES;
+
+    if (s_exited == NULL) {
+        s_exited = xSemaphoreCreateBinary();
+        if (s_exited == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    // The driver's ring is unused: one frame deep, flushed when it overflows
+    adc_continuous_handle_cfg_t hcfg = {
+        .max_store_buf_size = s_frame_bytes,
+        .conv_frame_size = s_frame_bytes,
+        .flags.flush_pool = 1,
+    };
+    esp_err_t err = adc_continuous_new_handle(&hcfg, &s_adc);
+    if (err != ESP_OK) {
+        s_adc = NULL;
+        return err;
+    }
+
+    adc_digi_pattern_config_t pattern = {
+        .atten = s_cfg.atten,
+        .channel = s_cfg.channel & 0x7,
+        .unit = ADC_UNIT_1,
+        .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+    };
+    adc_continuous_config_t ccfg = {
+        .pattern_num = 1,
+        .adc_pattern = &pattern,
+        .sample_freq_hz = s_cfg.sample_hz,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = ADC_STREAM_FORMAT,
+    };
+    adc_continuous_evt_cbs_t cbs = {
+        .on_conv_done = on_conv_done,
+        .on_pool_ovf = on_pool_ovf,
+    };
+    err = adc_continuous_config(s_adc, &ccfg);
+    if (err == ESP_OK) {
+        err = adc_continuous_register_event_callbacks(s_adc, &cbs, NULL);
+    }
+    if (err == ESP_OK && xTaskCreatePinnedToCore(adc_stream_task, "adc_stream", 4096, NULL,
+                                                 s_cfg.priority, &s_task, s_cfg.core) != pdPASS) {
+        err = ESP_ERR_NO_MEM;
+    }
+    if (err != ESP_OK) {
+        adc_continuous_deinit(s_adc);
+        s_adc = NULL;
+        return err;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    memset(&s_st, 0, sizeof(s_st));
+    s_since_us = esp_timer_get_time();
+    portEXIT_CRITICAL(&s_lock);
+    return adc_continuous_start(s_adc);
+}
+
+esp_err_t adc_stream_stop(void)
+{
+    if (s_adc == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    adc_continuous_stop(s_adc);
+    xTaskNotify(s_task, 0, eSetValueWithOverwrite);
+    xSemaphoreTake(s_exited, portMAX_DELAY);
+    s_task = NULL;
+
+    esp_err_t err = adc_continuous_deinit(s_adc);
+    s_adc = NULL;
+    return err;
+}
+
+void adc_stream_get_stats(adc_stream_stats_t *out, bool reset)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    *out = s_st;
+    out->elapsed_us = (uint64_t)(now - s_since_us);
+    if (reset) {
+        memset(&s_st, 0, sizeof(s_st));
+        s_since_us = now;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
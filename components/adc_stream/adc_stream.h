@@ -0,0 +1,110 @@
+/**
+ * @file adc_stream.h
+ * @brief Continuous ADC over DMA; each completed frame reaches one task by pointer, without a per-sample wakeup.
+ *
+ * A vTaskDelayUntil() sampling loop costs a tick interrupt, two context
+ * switches and one oneshot read per sample, and the tick rate caps it at
+ * CONFIG_FREERTOS_HZ. adc_stream runs the ADC in continuous mode instead.
+ * The driver's DMA fills its internal frame buffers round-robin, and when
+ * a frame is complete the conversion-done ISR sends the frame's address
+ * to the processing task:
+ *
+ *   xTaskNotifyFromISR(task, (uint32_t)frame, eSetValueWithoutOverwrite, ...)
+ *
+ * No sample is copied on the way to the task. The callback reads the
+ * results in place. The notification holds a single pointer. If the task
+ * has not collected the previous frame when the next one completes, the
+ * send fails, and that frame is counted as an overrun instead of silently
+ * replacing the older one.
+ *
+ * A frame stays valid while the DMA fills the driver's other internal
+ * buffers, a few frame periods. A callback that takes longer than one
+ * frame period shows up as overruns well before a buffer is reused under
+ * it.
+ *
+ * The driver also copies every frame into its own ring for
+ * adc_continuous_read(). adc_stream never reads that ring: the pool is
+ * sized to one frame with flush_pool set, and its overflow events are
+ * counted as pool_ovf, an expected and harmless count.
+ *
+ * Usage:
+ *   static void on_frame(const adc_digi_output_data_t *res, size_t n, void *arg)
+ *   {
+ *       for (size_t i = 0; i < n; i++) { sum += ADC_STREAM_DATA(&res[i]); }
+ *   }
+ *   adc_stream_config_t cfg = { .channel = ADC_CHANNEL_6, .sample_hz = 20000,
+ *                               .frame_samples = 256, .cb = on_frame, .core = 1 };
+ *   adc_stream_start(&cfg);
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_err.h"
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+#define ADC_STREAM_FORMAT           ADC_DIGI_OUTPUT_FORMAT_TYPE1
+#define ADC_STREAM_DATA(r)          ((r)->type1.data)
+#define ADC_STREAM_CHANNEL(r)       ((r)->type1.channel)
+#else
+#define ADC_STREAM_FORMAT           ADC_DIGI_OUTPUT_FORMAT_TYPE2
+#define ADC_STREAM_DATA(r)          ((r)->type2.data)
+#define ADC_STREAM_CHANNEL(r)       ((r)->type2.channel)
+#endif
+
+/** @brief Frame callback; runs in the adc_stream task, @p res points into the DMA buffer. */
+typedef void (*adc_stream_frame_cb_t)(const adc_digi_output_data_t *res, size_t n, void *arg);
+
+/**
+ * @brief Stream settings; zero fields take the defaults in brackets.
+ */
+typedef struct {
+    adc_channel_t channel;          //!< ADC1 channel
+    adc_atten_t atten;              //!< [ADC_ATTEN_DB_0]
+    uint32_t sample_hz;             //!< [20000]; ESP32 needs >= 20 kHz in continuous mode
+    uint32_t frame_samples;         //!< Results per frame and notification [256]
+    adc_stream_frame_cb_t cb;
+    void *arg;
+    UBaseType_t priority;           //!< Processing task [10]
+    BaseType_t core;                //!< Processing task core [0]
+} adc_stream_config_t;
+
+/** @brief Counters since adc_stream_start() or the last reset. */
+typedef struct {
+    uint32_t frames;                //!< Frames processed
+    uint32_t samples;               //!< Results processed
+    uint32_t overruns;              //!< Frames lost: the task still had one pending
+    uint32_t pool_ovf;              //!< Driver ring overflows (expected, see above)
+    uint64_t busy_us;               //!< Time spent in the callback
+    uint64_t elapsed_us;            //!< Window length
+} adc_stream_stats_t;
+
+/**
+ * @brief Configure ADC1 continuous mode on one channel, start the task and the DMA.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_INVALID_STATE if running,
+ *         ESP_ERR_NO_MEM, or an error from the ADC driver.
+ */
+esp_err_t adc_stream_start(const adc_stream_config_t *cfg);
+
+/**
+ * @brief Stop the DMA, free the driver and delete the task.
+ */
+esp_err_t adc_stream_stop(void);
+
+/**
+ * @brief Copy the counters, optionally starting a new window.
+ */
+void adc_stream_get_stats(adc_stream_stats_t *out, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
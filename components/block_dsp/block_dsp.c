@@ -0,0 +1,288 @@
+/**
+ * @file block_dsp.c
+ * @brief Scalar, unrolled and esp-dsp block kernels (see block_dsp.h).
+ *
+ * FIR layout. ext[] holds the last ntaps - 1 input samples followed by
+ * the new block, and the taps are stored reversed. Output i is then the
+ * dot product of coeffs_rev[0..ntaps) with ext[i..i + ntaps), one forward
+ * walk through both arrays, and no output needs a wrap-around check. After
+ * the block, the newest ntaps - 1 samples move to the front.
+ *
+ * The accumulator is 32 bits, starts at the rounding constant 1 << 14, and
+ * is shifted right by 15 and saturated to int16. Taps whose absolute
+ * values sum to at most 1.0 (32768) cannot overflow it. Integer sums do
+ * not depend on order, so the unrolled kernels match the scalar ones bit
+ * for bit.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "block_dsp.h"
+
+// ------------------------ Helpers ------------------------
+
+static inline int16_t sat_q15(int32_t acc)
+{
+    acc >>= 15;
+    if (acc > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (acc < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int16_t)acc;
+}
+
+static inline void fir_load(block_dsp_fir_t *f, const int16_t *in, size_t n)
+{
+    memcpy(f->ext + f->ntaps - 1, in, n * sizeof(int16_t));
+}
+
+static inline void fir_keep_history(block_dsp_fir_t *f, size_t n)
+{
+    memmove(f->ext, f->ext + n, (size_t)(f->ntaps - 1) * sizeof(int16_t));
+}
+
+// ------------------------ Scalar ------------------------
+
+static void fir_scalar(block_dsp_fir_t *f, const int16_t *in, int16_t *out, size_t n)
+{
+    const int16_t *h = f->coeffs_rev;
+    const int nt = f->ntaps;
+
+    fir_load(f, in, n);
+    for (size_t i = 0; i < n; i++) {
+        const int16_t *e = f->ext + i;
+        int32_t acc = 1 << 14;
+        for (int k = 0; k < nt; k++) {
+            acc += (int32_t)h[k] * e[k];
+        }
+        out[i] = sat_q15(acc);
+    }
+    fir_keep_history(f, n);
+}
+
+static float rms_scalar(const int16_t *in, size_t n)
+{
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i++) {
+        sum += (uint32_t)((int32_t)in[i] * in[i]);
+    }
+    return n ? sqrtf((float)sum / (float)n) : 0.0f;
+}
+
+static void minmax_scalar(const int16_t *in, size_t n, int16_t *min, int16_t *max)
+{
+    int16_t mn = in[0], mx = in[0];
+    for (size_t i = 1; i < n; i++) {
+        mn = in[i] < mn ? in[i] : mn;
+        mx = in[i] > mx ? in[i] : mx;
+    }
+    *min = mn;
+    *max = mx;
+}
+
+// ------------------------ Unrolled ------------------------
+
+/**
+ * @brief Two outputs per pass, four taps per step: each tap load feeds two MACs.
+ */
+static void fir_unrolled(block_dsp_fir_t *f, const int16_t *in, int16_t *out, size_t n)
+{
+    const int16_t *h = f->coeffs_rev;
+    const int nt = f->ntaps;
+    size_t i = 0;
+
+    fir_load(f, in, n);
+    for (; i + 2 <= n; i += 2) {
+        const int16_t *e = f->ext + i;
+        int32_t a0 = 1 << 14, a1 = 1 << 14;
+        int k = 0;
+        for (; k + 4 <= nt; k += 4) {
+            int32_t h0 = h[k], h1 = h[k + 1], h2 = h[k + 2], h3 = h[k + 3];
+            int32_t e0 = e[k], e1 = e[k + 1], e2 = e[k + 2], e3 = e[k + 3], e4 = e[k + 4];
+            a0 += h0 * e0 + h1 * e1 + h2 * e2 + h3 * e3;
+            a1 += h0 * e1 + h1 * e2 + h2 * e3 + h3 * e4;
+        }
+        for (; k < nt; k++) {
+            a0 += (int32_t)h[k] * e[k];
+            a1 += (int32_t)h[k] * e[k + 1];
+        }
+        out[i] = sat_q15(a0);
+        out[i + 1] = sat_q15(a1);
+    }
+    if (i < n) {
+        const int16_t *e = f->ext + i;
+        int32_t acc = 1 << 14;
+        for (int k = 0; k < nt; k++) {
+            acc += (int32_t)h[k] * e[k];
+        }
+        out[i] = sat_q15(acc);
+    }
+    fir_keep_history(f, n);
+}
+
+static float rms_unrolled(const int16_t *in, size_t n)
+{
+    // Two squares fit in 32 bits (2 * 2^30), so widen once per pair
+    uint64_t s0 = 0, s1 = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        int32_t x0 = in[i], x1 = in[i + 1], x2 = in[i + 2], x3 = in[i + 3];
+        s0 += (uint32_t)(x0 * x0) + (uint32_t)(x1 * x1);
+        s1 += (uint32_t)(x2 * x2) + (uint32_t)(x3 * x3);
+    }
+    for (; i < n; i++) {
+        s0 += (uint32_t)((int32_t)in[i] * in[i]);
+    }
+    return n ? sqrtf((float)(s0 + s1) / (float)n) : 0.0f;
+}
+
+static void minmax_unrolled(const int16_t *in, size_t n, int16_t *min, int16_t *max)
+{
+    int16_t mn0 = in[0], mx0 = in[0], mn1 = in[0], mx1 = in[0];
+    size_t i = 1;
+    for (; i + 2 <= n; i += 2) {
+        int16_t a = in[i], b = in[i + 1];
+        mn0 = a < mn0 ? a : mn0;
+        mx0 = a > mx0 ? a : mx0;
+        mn1 = b < mn1 ? b : mn1;
+        mx1 = b > mx1 ? b : mx1;
+    }
+    if (i < n) {
+        mn0 = in[i] < mn0 ? in[i] : mn0;
+        mx0 = in[i] > mx0 ? in[i] : mx0;
+    }
+    *min = mn0 < mn1 ? mn0 : mn1;
+    *max = mx0 > mx1 ? mx0 : mx1;
+}
+
+// ------------------------ esp-dsp ------------------------
+
+#if BLOCK_DSP_USE_ESP_DSP
+static void fir_esp_dsp(block_dsp_fir_t *f, const int16_t *in, int16_t *out, size_t n)
+{
+    if (!f->dsp_ready) {
+        fir_unrolled(f, in, out, n);
+        return;
+    }
+    dsps_fird_s16(&f->dsp, in, out, (int32_t)n);
+}
+
+static esp_err_t fir_esp_dsp_setup(block_dsp_fir_t *f)
+{
+    memset(f->dsp_delay, 0, (size_t)(f->ntaps + 8) * sizeof(int16_t));
+    return dsps_fird_init_s16(&f->dsp, f->dsp_coeffs, f->dsp_delay, (int16_t)f->ntaps, 1, 0, 0);
+}
+#endif
+
+// ------------------------ Tables ------------------------
+
+static const block_dsp_ops_t s_ops[BLOCK_DSP_IMPL_COUNT] = {
+    [BLOCK_DSP_SCALAR] = { "scalar", fir_scalar, rms_scalar, minmax_scalar },
+    [BLOCK_DSP_UNROLLED] = { "unrolled", fir_unrolled, rms_unrolled, minmax_unrolled },
+#if BLOCK_DSP_USE_ESP_DSP
+    [BLOCK_DSP_ESP_DSP] = { "esp-dsp", fir_esp_dsp, rms_unrolled, minmax_unrolled },
+#endif
+};
+
+const block_dsp_ops_t *block_dsp_get_ops(block_dsp_impl_t impl)
+{
+    if (impl >= BLOCK_DSP_IMPL_COUNT || s_ops[impl].name == NULL) {
+        return NULL;
+    }
+    return &s_ops[impl];
+}
+
+const block_dsp_ops_t *block_dsp_best(void)
+{
+#if BLOCK_DSP_USE_ESP_DSP
+    return &s_ops[BLOCK_DSP_ESP_DSP];
+#else
+    return &s_ops[BLOCK_DSP_UNROLLED];
+#endif
+}
+
+// ------------------------ FIR state ------------------------
+
+esp_err_t block_dsp_fir_init(block_dsp_fir_t *f, const int16_t *taps, int ntaps, size_t block_max)
+{
+    if (f == NULL || taps == NULL || ntaps < 1 || block_max == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(f, 0, sizeof(*f));
+    f->ntaps = ntaps;
+    f->block_max = block_max;
+    f->coeffs_rev = heap_caps_aligned_alloc(16, (size_t)ntaps * sizeof(int16_t), MALLOC_CAP_8BIT);
+    f->ext = heap_caps_aligned_alloc(16, (ntaps - 1 + block_max) * sizeof(int16_t), MALLOC_CAP_8BIT);
+    if (f->coeffs_rev == NULL || f->ext == NULL) {
+        block_dsp_fir_deinit(f);
+        return ESP_ERR_NO_MEM;
+    }
+    for (int k = 0; k < ntaps; k++) {
+        f->coeffs_rev[k] = taps[ntaps - 1 - k];
+    }
+
+#if BLOCK_DSP_USE_ESP_DSP
+    // The aes3 kernel wants 16-byte aligned arrays, ntaps % 8 == 0 and 8 spare delay slots
+    if (ntaps % 8 == 0) {
+        f->dsp_coeffs = heap_caps_aligned_alloc(16, (size_t)ntaps * sizeof(int16_t), MALLOC_CAP_8BIT);
+        f->dsp_delay = heap_caps_aligned_alloc(16, (size_t)(ntaps + 8) * sizeof(int16_t), MALLOC_CAP_8BIT);
+        if (f->dsp_coeffs != NULL && f->dsp_delay != NULL) {
+            memcpy(f->dsp_coeffs, taps, (size_t)ntaps * sizeof(int16_t));
+            f->dsp_ready = fir_esp_dsp_setup(f) == ESP_OK;
+        }
+    }
+#endif
+    block_dsp_fir_reset(f);
+    return ESP_OK;
+}
+
+void block_dsp_fir_reset(block_dsp_fir_t *f)
+{
+    memset(f->ext, 0, (size_t)(f->ntaps - 1) * sizeof(int16_t));
+#if BLOCK_DSP_USE_ESP_DSP
+    if (f->dsp_ready) {
+        dsps_fird_s16_aexx_free(&f->dsp);
+        f->dsp_ready = fir_esp_dsp_setup(f) == ESP_OK;
+    }
+#endif
+}
+
+void block_dsp_fir_deinit(block_dsp_fir_t *f)
+{
+#if BLOCK_DSP_USE_ESP_DSP
+    if (f->dsp_ready) {
+        dsps_fird_s16_aexx_free(&f->dsp);
+    }
+    heap_caps_free(f->dsp_coeffs);
+    heap_caps_free(f->dsp_delay);
+#endif
+    heap_caps_free(f->coeffs_rev);
+    heap_caps_free(f->ext);
+    memset(f, 0, sizeof(*f));
+}
+
+// ------------------------ Sampler ------------------------
+
+esp_err_t block_sampler_init(block_sampler_t *s, size_t n, sample_block_cb_t cb, void *arg)
+{
+    if (s == NULL || n == 0 || cb == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(s, 0, sizeof(*s));
+    s->buf[0] = heap_caps_aligned_alloc(16, n * sizeof(int16_t), MALLOC_CAP_8BIT);
+    s->buf[1] = heap_caps_aligned_alloc(16, n * sizeof(int16_t), MALLOC_CAP_8BIT);
+    if (s->buf[0] == NULL || s->buf[1] == NULL) {
+        heap_caps_free(s->buf[0]);
+        heap_caps_free(s->buf[1]);
+        return ESP_ERR_NO_MEM;
+    }
+    s->n = n;
+    s->cb = cb;
+    s->arg = arg;
+    return ESP_OK;
+}
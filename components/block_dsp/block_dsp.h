@@ -0,0 +1,166 @@
+/**
+ * @file block_dsp.h
+ * @brief Block kernels for int16 sample streams (Q15 FIR, RMS, min/max) with scalar, unrolled and esp-dsp paths.
+ *
+ * A sampling task that handles one value per wakeup leaves the CPU idle
+ * between samples, and then pays loop overhead on every sample. block_dsp
+ * works on whole blocks of 1..4 k samples instead. Every kernel exists in
+ * up to three implementations with the same results:
+ *   - BLOCK_DSP_SCALAR   : plain C, the reference
+ *   - BLOCK_DSP_UNROLLED : portable C with 4 independent accumulators and,
+ *                          for the FIR, two outputs per pass sharing each
+ *                          coefficient load. This avoids the load-use and
+ *                          loop-carried stalls of the scalar loop on either core.
+ *   - BLOCK_DSP_ESP_DSP  : the FIR runs on esp-dsp's dsps_fird_s16(). That
+ *                          is the ESP32-S3 PIE (aes3) assembly kernel, or
+ *                          the ae32 one on ESP32. RMS and min/max use the
+ *                          unrolled path: esp-dsp's int16 dot product
+ *                          saturates to 16 bits, which is too narrow for
+ *                          a sum of squares. Only available when the
+ *                          espressif/esp-dsp component is in the build.
+ * The FIR keeps its history across calls, so consecutive blocks filter as
+ * one continuous stream. The scalar and unrolled paths are bit exact; the
+ * esp-dsp path rounds its internal shift on its own and may differ by 1 LSB.
+ *
+ * block_sampler_t connects a per-sample producer, such as a sensor read in
+ * a vTaskDelayUntil() loop or an ADC FIFO drain, to a sample_block_cb_t.
+ * It fills one of two buffers and calls the callback in the producer's
+ * task when the buffer is full. The block stays valid until the other
+ * buffer fills, which leaves time to pass it to another task.
+ *
+ * Usage:
+ *   static block_dsp_fir_t fir;
+ *   block_dsp_fir_init(&fir, taps, 32, 1024);
+ *   const block_dsp_ops_t *ops = block_dsp_best();
+ *   ops->fir(&fir, in, out, 1024);
+ *   float rms = ops->rms(out, 1024);
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifndef BLOCK_DSP_USE_ESP_DSP
+#if defined(__has_include)
+#if __has_include("esp_dsp.h")
+#define BLOCK_DSP_USE_ESP_DSP 1
+#endif
+#endif
+#endif
+#ifndef BLOCK_DSP_USE_ESP_DSP
+#define BLOCK_DSP_USE_ESP_DSP 0
+#endif
+
+#if BLOCK_DSP_USE_ESP_DSP
+#include "esp_dsp.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Kernel implementations. */
+typedef enum {
+    BLOCK_DSP_SCALAR,
+    BLOCK_DSP_UNROLLED,
+    BLOCK_DSP_ESP_DSP,
+    BLOCK_DSP_IMPL_COUNT,
+} block_dsp_impl_t;
+
+/**
+ * @brief Q15 FIR state; all fields are private.
+ */
+typedef struct {
+    int16_t *coeffs_rev;            //!< Taps reversed, so the inner loop walks forward
+    int ntaps;
+    size_t block_max;
+    int16_t *ext;                   //!< ntaps - 1 history samples, then the current block
+#if BLOCK_DSP_USE_ESP_DSP
+    fir_s16_t dsp;
+    int16_t *dsp_coeffs;
+    int16_t *dsp_delay;
+    bool dsp_ready;                 //!< ntaps is a multiple of 8 and init succeeded
+#endif
+} block_dsp_fir_t;
+
+/** @brief One implementation's kernels. */
+typedef struct {
+    const char *name;
+    /** y = h * x in Q15 with rounding and saturation; n <= block_max. */
+    void (*fir)(block_dsp_fir_t *f, const int16_t *in, int16_t *out, size_t n);
+    /** Root mean square of n samples. */
+    float (*rms)(const int16_t *in, size_t n);
+    /** Smallest and largest of n >= 1 samples. */
+    void (*minmax)(const int16_t *in, size_t n, int16_t *min, int16_t *max);
+} block_dsp_ops_t;
+
+/** @brief Called when a block is complete; @p block stays valid until the next call. */
+typedef void (*sample_block_cb_t)(const int16_t *block, size_t n, void *arg);
+
+/**
+ * @brief Ping-pong block collector; all fields are private.
+ */
+typedef struct {
+    int16_t *buf[2];
+    size_t n;
+    size_t fill;
+    int cur;
+    sample_block_cb_t cb;
+    void *arg;
+} block_sampler_t;
+
+/**
+ * @brief Kernels of @p impl, or NULL if it is not built in.
+ */
+const block_dsp_ops_t *block_dsp_get_ops(block_dsp_impl_t impl);
+
+/**
+ * @brief Fastest built-in implementation.
+ */
+const block_dsp_ops_t *block_dsp_best(void);
+
+/**
+ * @brief Set up a FIR with @p ntaps Q15 taps for blocks of up to @p block_max samples.
+ *
+ * For the esp-dsp path, ntaps must be a multiple of 8. Otherwise that
+ * path falls back to the unrolled FIR.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM.
+ */
+esp_err_t block_dsp_fir_init(block_dsp_fir_t *f, const int16_t *taps, int ntaps, size_t block_max);
+
+/**
+ * @brief Clear the FIR history (all paths).
+ */
+void block_dsp_fir_reset(block_dsp_fir_t *f);
+
+/**
+ * @brief Free the FIR buffers.
+ */
+void block_dsp_fir_deinit(block_dsp_fir_t *f);
+
+/**
+ * @brief Allocate two @p n-sample buffers and set the block callback.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM.
+ */
+esp_err_t block_sampler_init(block_sampler_t *s, size_t n, sample_block_cb_t cb, void *arg);
+
+/**
+ * @brief Append one sample; runs the callback when the block is full.
+ */
+static inline void block_sampler_push(block_sampler_t *s, int16_t sample)
+{
+    s->buf[s->cur][s->fill++] = sample;
+    if (s->fill == s->n) {
+        s->cb(s->buf[s->cur], s->n, s->arg);
+        s->cur ^= 1;
+        s->fill = 0;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
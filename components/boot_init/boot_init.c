@@ -0,0 +1,249 @@
+/**
+ * @file boot_init.c
+ * @brief Parallel init steps behind event-group barriers (see boot_init.h).
+ *
+ * Every step gets its own task, created before any step may run. Each
+ * task waits for BOOT_START_BIT plus its dependency bits with
+ * xEventGroupWaitBits(), runs, sets its own bit and deletes itself, so a
+ * step that blocks never holds up another one. A step's times and the
+ * failed mask are written before its bit is set. Event-group calls run
+ * inside a critical section, so a task that sees the bit also sees those
+ * writes.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "esp_timer.h"
+#include "boot_init.h"
+
+#define BOOT_START_BIT      (1UL << BOOT_MAX_STEPS)
+
+static const boot_step_t *s_steps;
+static boot_step_time_t *s_times;
+static int s_n;
+static uint32_t s_all;
+static uint32_t s_failed;
+static int64_t s_t0;
+static bool s_busy;
+static StaticEventGroup_t s_eg_buf;
+static EventGroupHandle_t s_eg;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ------------------------ Steps ------------------------
+
+/**
+ * @brief Check indices, cores and that the dependency graph has no cycle.
+ */
+static bool table_valid(const boot_step_t *steps, int n)
+{
+    uint32_t all = BOOT_DEP(n) - 1;
+    for (int i = 0; i < n; i++) {
+        if (steps[i].fn == NULL || (steps[i].deps & ~all) || (steps[i].deps & BOOT_DEP(i)) ||
+            steps[i].core < BOOT_ANY_CORE || steps[i].core >= portNUM_PROCESSORS) {
+            return false;
+        }
+    }
+
+    uint32_t done = 0;
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        for (int i = 0; i < n; i++) {
+            if (!(done & BOOT_DEP(i)) && (steps[i].deps & ~done) == 0) {
+                done |= BOOT_DEP(i);
+                progress = true;
+            }
+        }
+    }
+    return done == all;
+}
+
+/**
+ * @brief Run (or skip) one step whose dependencies are done, record its times and set its bit.
+ */
+static void run_step(int i)
+{
+    const boot_step_t *st = &s_steps[i];
+    boot_step_time_t *t = &s_times[i];
+
+    t->ready_us = s_t0;
+    for (int d = 0; d < s_n; d++) {
+        if ((st->deps & BOOT_DEP(d)) && s_times[d].end_us > t->ready_us) {
+            t->ready_us = s_times[d].end_us;
+        }
+    }
+    t->core = (int8_t)xPortGetCoreID();
+
+    portENTER_CRITICAL(&s_lock);
+    bool skip = (s_failed & st->deps) != 0;
+    portEXIT_CRITICAL(&s_lock);
+
+    t->start_us = esp_timer_get_time();
+    t->err = skip ? ESP_ERR_INVALID_STATE : st->fn(st->arg);
+    t->end_us = esp_timer_get_time();
+
+    if (t->err != ESP_OK) {
+        portENTER_CRITICAL(&s_lock);
+        s_failed |= BOOT_DEP(i);        // Dependents are skipped in turn
+        portEXIT_CRITICAL(&s_lock);
+    }
+    xEventGroupSetBits(s_eg, BOOT_DEP(i));
+}
+
+// ------------------------ Step tasks ------------------------
+
+/**
+ * @brief Waits for the start barrier and the step's dependencies, runs it, exits.
+ *
+ * @param arg Step index (cast from intptr_t).
+ */
+static void boot_step_task(void *arg)
+{
+    int i = (int)(intptr_t)arg;
+
+    xEventGroupWaitBits(s_eg, BOOT_START_BIT | s_steps[i].deps, pdFALSE, pdTRUE, portMAX_DELAY);
+    run_step(i);
+    vTaskDelete(NULL);
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t boot_init_run(const boot_step_t *steps, int n, const boot_init_config_t *cfg, boot_step_time_t *times)
+{
+    if (steps == NULL || times == NULL || n <= 0 || n > BOOT_MAX_STEPS || !table_valid(steps, n)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_busy) {
+        return ESP_ERR_INVALID_STATE;   // A previous run timed out and still owns the state
+    }
+
+    boot_init_config_t c = cfg ? *cfg : (boot_init_config_t) { 0 };
+    c.priority = c.priority ? c.priority : 10;
+    c.stack_size = c.stack_size ? c.stack_size : 4096;
+    c.timeout_ms = c.timeout_ms ? c.timeout_ms : 10000;
+
+    s_busy = true;
+    s_steps = steps;
+    s_times = times;
+    s_n = n;
+    s_all = BOOT_DEP(n) - 1;
+    s_failed = 0;
+    memset(times, 0, sizeof(*times) * (size_t)n);
+    s_eg = xEventGroupCreateStatic(&s_eg_buf);
+
+    if (c.serial) {
+        // Table order if ready, else the first ready step; the table is acyclic
+        s_t0 = esp_timer_get_time();
+        for (int k = 0; k < n; k++) {
+            uint32_t done = (uint32_t)xEventGroupGetBits(s_eg) & s_all;
+            int i = 0;
+            while ((done & BOOT_DEP(i)) || (steps[i].deps & ~done) != 0) {
+                i++;
+            }
+            run_step(i);
+        }
+    } else {
+        // Every task exists before any step runs, so no step waits for a task to be created
+        esp_err_t create_err = ESP_OK;
+        for (int i = 0; i < n; i++) {
+            BaseType_t core = steps[i].core == BOOT_ANY_CORE ? tskNO_AFFINITY : steps[i].core;
+            if (create_err == ESP_OK &&
+                xTaskCreatePinnedToCore(boot_step_task, steps[i].name, c.stack_size, (void *)(intptr_t)i,
+                                        c.priority, NULL, core) == pdPASS) {
+                continue;
+            }
+            // No task: fail the step now, its dependents are skipped
+            create_err = ESP_ERR_NO_MEM;
+            times[i].err = ESP_ERR_NO_MEM;
+            times[i].core = -1;
+            s_failed |= BOOT_DEP(i);
+            xEventGroupSetBits(s_eg, BOOT_DEP(i));
+        }
+        s_t0 = esp_timer_get_time();
+        for (int i = 0; i < n; i++) {
+            if (times[i].err == ESP_ERR_NO_MEM) {
+                times[i].ready_us = times[i].start_us = times[i].end_us = s_t0;
+            }
+        }
+        xEventGroupSetBits(s_eg, BOOT_START_BIT);
+
+        EventBits_t bits = xEventGroupWaitBits(s_eg, s_all, pdFALSE, pdTRUE, pdMS_TO_TICKS(c.timeout_ms));
+        if ((bits & s_all) != s_all) {
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+
+    vEventGroupDelete(s_eg);
+    s_busy = false;
+    for (int i = 0; i < n; i++) {
+        if (times[i].err != ESP_OK) {
+            return times[i].err;
+        }
+    }
+    return ESP_OK;
+}
+
+void boot_init_report(const boot_step_t *steps, int n, const boot_step_time_t *times)
+{
+    int64_t t0 = INT64_MAX, serial = 0;
+    int last = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (times[i].ready_us < t0) {
+            t0 = times[i].ready_us;
+        }
+        if (times[i].end_us > times[last].end_us) {
+            last = i;
+        }
+        serial += times[i].end_us - times[i].start_us;
+    }
+
+    printf("[BOOT] %-12s core  ready  start    end    dur  (ms since reset)\n", "step");
+    for (int i = 0; i < n; i++) {
+        const boot_step_time_t *t = &times[i];
+        printf("[BOOT] %-12s %4d %6.1f %6.1f %6.1f %6.1f", steps[i].name, t->core,
+               t->ready_us / 1000.0, t->start_us / 1000.0, t->end_us / 1000.0,
+               (t->end_us - t->start_us) / 1000.0);
+        if (t->err == ESP_ERR_INVALID_STATE) {
+            printf("  skipped");
+        } else if (t->err != ESP_OK) {
+            printf("  FAILED: %s", esp_err_to_name(t->err));
+        }
+        printf("\n");
+    }
+
+    int64_t wall = times[last].end_us - t0;
+    printf("[BOOT] steps %.1f ms serial, %.1f ms wall (%.2fx)\n",
+           serial / 1000.0, wall / 1000.0, wall > 0 ? (double)serial / (double)wall : 0.0);
+
+    // Walk back from the last step to finish through the dependency that finished last
+    int path[BOOT_MAX_STEPS];
+    int len = 0;
+    for (int i = last; i >= 0 && len < BOOT_MAX_STEPS;) {
+        path[len++] = i;
+        int prev = -1;
+        for (int d = 0; d < n; d++) {
+            if ((steps[i].deps & BOOT_DEP(d)) && (prev < 0 || times[d].end_us > times[prev].end_us)) {
+                prev = d;
+            }
+        }
+        i = prev;
+    }
+
+    // A step on the path that started well after it was ready waited for a CPU
+    int64_t queued = 0;
+    printf("[BOOT] critical path: ");
+    for (int k = len - 1; k >= 0; k--) {
+        const boot_step_time_t *t = &times[path[k]];
+        int64_t gap = t->start_us - (k == len - 1 ? t0 : t->ready_us);
+        queued += gap;
+        printf("%s", steps[path[k]].name);
+        if (gap >= 1000) {
+            printf(" (queued %.1f ms)", gap / 1000.0);
+        }
+        printf("%s", k ? " -> " : "");
+    }
+    printf(" = %.1f ms, %.1f ms of it between ready and start\n", wall / 1000.0, queued / 1000.0);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file boot_init.h
+ * @brief Dependency-driven parallel subsystem init on both cores, with a per-step boot profile.
+ *
+ * The examples' app_main() functions init everything in sequence:
+ * configure GPIOs, then each peripheral, then create the tasks. A step that
+ * mostly waits, such as a sensor power-up delay, a radio calibration or a
+ * flash read, holds up every step after it. With boot_init the caller
+ * instead lists its steps in a table. Each step names the earlier-finished
+ * steps it needs as a bitmask of table indices (BOOT_DEP()).
+ *
+ * boot_init_run() creates one short-lived task per step, all of them before
+ * any step may start (they wait for a start bit). Each step owns one bit of
+ * an event group that its task sets when the step returns; waiting for the
+ * dependency bits is the barrier. A step therefore starts on whichever core
+ * is free the moment its last dependency finishes, and a step that blocks
+ * (a power-up delay, a driver waiting for an interrupt) only parks its own
+ * task. A step can be pinned, e.g. when it installs an interrupt, which is
+ * bound to the core that allocates it. All step tasks exist at once, so the
+ * run needs n * stack_size bytes of heap until the steps finish.
+ *
+ * If a step fails, the steps that depend on it, directly or through
+ * others, are skipped and marked ESP_ERR_INVALID_STATE. Independent steps
+ * still run. Every step records when its dependencies were met, when it
+ * started, when it ended and on which core. boot_init_report() prints the
+ * table and the critical path, i.e. the dependency chain that set the end
+ * time. A step on it that started more than 1 ms after it was ready,
+ * because both cores were busy with other steps, is marked "queued":
+ *   [BOOT] step        core  ready  start    end    dur  (ms since reset)
+ *   [BOOT] nvs            1  298.1  298.2  361.3   63.1
+ *   [BOOT] wifi           0  361.3  361.4  641.7  280.3
+ *   [BOOT] steps 785.4 ms serial, 443.9 ms wall (1.77x)
+ *   [BOOT] critical path: nvs -> wifi -> sntp -> app_tasks = 443.9 ms, 0.3 ms of it between ready and start
+ *   (illustrative)
+ * "serial" adds up the step durations of this run. Steps sharing a core
+ * stretch each other, so it is a little above a real serial boot.
+ * Times come from esp_timer_get_time(), which starts counting during early
+ * startup. "Since reset" therefore leaves out the ROM and bootloader time
+ * before it.
+ *
+ * Usage:
+ *   enum { STEP_NVS, STEP_WIFI, STEP_LED, STEP_COUNT };
+ *   static const boot_step_t steps[STEP_COUNT] = {
+ *       [STEP_NVS]  = { "nvs",  init_nvs,  NULL, 0,                  BOOT_ANY_CORE },
+ *       [STEP_WIFI] = { "wifi", init_wifi, NULL, BOOT_DEP(STEP_NVS), 0 },
+ *       [STEP_LED]  = { "led",  init_led,  NULL, 0,                  BOOT_ANY_CORE },
+ *   };
+ *   static boot_step_time_t times[STEP_COUNT];
+ *   boot_init_run(steps, STEP_COUNT, NULL, times);
+ *   boot_init_report(steps, STEP_COUNT, times);
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Steps per run: 24 event-group bits, one of them kept for the start barrier */
+#define BOOT_MAX_STEPS      23
+#define BOOT_DEP(i)         (1UL << (i))
+#define BOOT_ANY_CORE       (-1)
+
+typedef esp_err_t (*boot_step_fn_t)(void *arg);
+
+/**
+ * @brief One init step.
+ */
+typedef struct {
+    const char *name;
+    boot_step_fn_t fn;
+    void *arg;
+    uint32_t deps;                  //!< BOOT_DEP() of every step that must finish first
+    int8_t core;                    //!< 0, 1 or BOOT_ANY_CORE
+} boot_step_t;
+
+/**
+ * @brief Run options; zero fields take the defaults in brackets.
+ */
+typedef struct {
+    UBaseType_t priority;           //!< Step task priority [10]
+    uint32_t stack_size;            //!< Stack of each step task in bytes [4096]
+    uint32_t timeout_ms;            //!< Whole run [10000]
+    bool serial;                    //!< Run the steps one by one on the calling task, ignoring core (for comparison)
+} boot_init_config_t;
+
+/** @brief Profile of one step, in µs of esp_timer_get_time(). */
+typedef struct {
+    int64_t ready_us;               //!< Last dependency finished (run start if none)
+    int64_t start_us;
+    int64_t end_us;
+    esp_err_t err;                  //!< Step result; ESP_ERR_INVALID_STATE = skipped
+    int8_t core;
+} boot_step_time_t;
+
+/**
+ * @brief Run all steps and return when every one has finished or been skipped.
+ *
+ * @param cfg   Options, or NULL for the defaults.
+ * @param times One entry per step; filled in.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG (bad table, unknown dependency or
+ *         cycle), ESP_ERR_INVALID_STATE (an earlier run timed out),
+ *         ESP_ERR_TIMEOUT (a step hung; its task and those waiting on it
+ *         are left running), or the error of the first failed step
+ *         (ESP_ERR_NO_MEM for a step whose task could not be created).
+ */
+esp_err_t boot_init_run(const boot_step_t *steps, int n, const boot_init_config_t *cfg, boot_step_time_t *times);
+
+/**
+ * @brief Print the step table, serial vs wall time and the critical path.
+ */
+void boot_init_report(const boot_step_t *steps, int n, const boot_step_time_t *times);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,192 @@
+/**
+ * @file buffer_pool.h
+ * @brief Fixed-block buffer pool and pointer queue for zero-copy task-to-task transfer.
+ *
+ * A buffer_pool_t owns a statically allocated array of equally sized blocks.
+ * A buffer_queue_t carries only pointers to those blocks, so a frame is
+ * written once by the producer and read in place by the consumer instead of
+ * being copied into and out of the queue storage by xQueueSend/xQueueReceive.
+ *
+ * Ownership rules:
+ *   - buffer_pool_acquire()  hands a free block to the caller.
+ *   - buffer_queue_send()    transfers ownership to the receiver on success;
+ *                            on failure the caller still owns the block.
+ *   - buffer_queue_receive() hands ownership to the caller.
+ *   - buffer_pool_release()  returns the block to the pool it came from.
+ *
+ * Both objects are declared with a DEFINE macro so that every byte of storage
+ * (blocks, free list, queue ring and control blocks) is static. No heap is used.
+ *
+ * Usage:
+ *   BUFFER_POOL_DEFINE(frame_pool, 1500, 8);
+ *   BUFFER_QUEUE_DEFINE(frame_queue, 6);
+ *
+ *   buffer_pool_init(&frame_pool);
+ *   buffer_queue_init(&frame_queue);
+ *
+ *   // producer
+ *   pool_buf_t *buf = buffer_pool_acquire(&frame_pool, portMAX_DELAY);
+ *   buf->len = fill_frame(buf->data, frame_pool.payload_size);
+ *   if (buffer_queue_send(&frame_queue, buf, pdMS_TO_TICKS(10)) != pdPASS) {
+ *       buffer_pool_release(buf);
+ *   }
+ *
+ *   // consumer
+ *   pool_buf_t *buf = buffer_queue_receive(&frame_queue, portMAX_DELAY);
+ *   process_frame(buf->data, buf->len);
+ *   buffer_pool_release(buf);
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct buffer_pool buffer_pool_t;
+
+/**
+ * @brief Header placed at the start of every pool block; payload follows it.
+ */
+typedef struct {
+    buffer_pool_t *pool;    //!< Owning pool (set by the pool, do not modify)
+    size_t len;             //!< Number of valid payload bytes
+    uint8_t data[];         //!< Payload, pool->payload_size bytes
+} pool_buf_t;
+
+/**
+ * @brief Fixed-block pool; declare instances with BUFFER_POOL_DEFINE().
+ */
+struct buffer_pool {
+    uint8_t *blocks;            //!< Block storage (block_count * stride bytes)
+    size_t payload_size;        //!< Usable bytes per block
+    size_t stride;              //!< Bytes between consecutive blocks
+    size_t block_count;         //!< Number of blocks
+    uint8_t *free_storage;      //!< Ring storage of the free-list queue
+    StaticQueue_t free_queue_buf;
+    QueueHandle_t free_queue;   //!< Queue of pool_buf_t * that are free
+};
+
+/**
+ * @brief Queue of pool_buf_t pointers; declare instances with BUFFER_QUEUE_DEFINE().
+ */
+typedef struct {
+    uint8_t *storage;           //!< Ring storage (length pointers)
+    UBaseType_t length;         //!< Queue depth in buffers
+    StaticQueue_t queue_buf;
+    QueueHandle_t handle;
+} buffer_queue_t;
+
+/** @brief Distance between blocks for a payload of @p size bytes (8-byte aligned). */
+#define BUFFER_POOL_STRIDE(size) \
+    ((sizeof(pool_buf_t) + (size_t)(size) + 7u) & ~(size_t)7u)
+
+/**
+ * @brief Define a statically allocated pool named @p name.
+ *
+ * @param name  Identifier of the buffer_pool_t object.
+ * @param size  Payload bytes per block.
+ * @param count Number of blocks.
+ */
+#define BUFFER_POOL_DEFINE(name, size, count)                                           \
+    static uint8_t name##_blocks[(count) * BUFFER_POOL_STRIDE(size)]                    \
+        __attribute__((aligned(8)));                                                    \
+    static uint8_t name##_free_storage[(count) * sizeof(pool_buf_t *)];                 \
+    static buffer_pool_t name = {                                                       \
+        .blocks = name##_blocks,                                                        \
+        .payload_size = (size),                                                         \
+        .stride = BUFFER_POOL_STRIDE(size),                                             \
+        .block_count = (count),                                                         \
+        .free_storage = name##_free_storage,                                            \
+    }
+
+/**
+ * @brief Define a statically allocated pointer queue named @p name.
+ *
+ * @param name  Identifier of the buffer_queue_t object.
+ * @param depth Maximum number of buffers in flight in the queue.
+ */
+#define BUFFER_QUEUE_DEFINE(name, depth)                                                \
+    static uint8_t name##_storage[(depth) * sizeof(pool_buf_t *)];                      \
+    static buffer_queue_t name = {                                                      \
+        .storage = name##_storage,                                                      \
+        .length = (depth),                                                              \
+    }
+
+/**
+ * @brief Create the pool's free list and put every block on it.
+ *
+ * @param pool Pool declared with BUFFER_POOL_DEFINE().
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on a malformed pool,
+ *         ESP_ERR_INVALID_STATE if the pool is already initialized.
+ */
+esp_err_t buffer_pool_init(buffer_pool_t *pool);
+
+/**
+ * @brief Take a free block from the pool.
+ *
+ * The returned buffer has len set to 0 and is owned by the caller until it is
+ * sent on a buffer_queue_t or released.
+ *
+ * @param pool Pool to take from.
+ * @param wait Ticks to wait for a block to become free.
+ * @return Pointer to the buffer, or NULL if none became free in time.
+ */
+pool_buf_t *buffer_pool_acquire(buffer_pool_t *pool, TickType_t wait);
+
+/**
+ * @brief Return a block to the pool it was acquired from.
+ *
+ * @param buf Buffer owned by the caller (NULL is ignored).
+ */
+void buffer_pool_release(pool_buf_t *buf);
+
+/**
+ * @brief Number of blocks currently free in the pool.
+ */
+UBaseType_t buffer_pool_available(const buffer_pool_t *pool);
+
+/**
+ * @brief Create the pointer queue in its static storage.
+ *
+ * @param queue Queue declared with BUFFER_QUEUE_DEFINE().
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG on a malformed queue,
+ *         ESP_ERR_INVALID_STATE if the queue is already initialized.
+ */
+esp_err_t buffer_queue_init(buffer_queue_t *queue);
+
+/**
+ * @brief Transfer ownership of @p buf to the receiving task.
+ *
+ * Only the pointer is enqueued; the payload is not copied.
+ *
+ * @param queue Destination queue.
+ * @param buf   Buffer owned by the caller.
+ * @param wait  Ticks to wait for space in the queue.
+ * @return pdPASS if the buffer was enqueued (caller no longer owns it),
+ *         errQUEUE_FULL otherwise (caller still owns it).
+ */
+BaseType_t buffer_queue_send(buffer_queue_t *queue, pool_buf_t *buf, TickType_t wait);
+
+/**
+ * @brief Receive the next buffer and take ownership of it.
+ *
+ * @param queue Source queue.
+ * @param wait  Ticks to wait for a buffer to arrive.
+ * @return The buffer (release it when done), or NULL on timeout.
+ */
+pool_buf_t *buffer_queue_receive(buffer_queue_t *queue, TickType_t wait);
+
+/**
+ * @brief Number of buffers waiting in the queue.
+ */
+UBaseType_t buffer_queue_waiting(const buffer_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,239 @@
+/**
+ * @file core_arena.c
+ * @brief Per-core slabs with batched remote frees (see core_arena.h).
+ *
+ * Each (core, class) slab is one contiguous allocation, so the owner and
+ * class of a block follow from its address. Blocks need no header. A
+ * free block's first word links it into a list.
+ *
+ * Ownership of the lists:
+ *   local[core][class]      : touched only on core, under its interrupt mask
+ *   out[core][owner][class] : same (a batch being built on core)
+ *   remote[owner][class]    : pushed by any core with CAS, emptied by owner
+ *                             with an exchange
+ * The arena memory comes from heap_caps_malloc(MALLOC_CAP_INTERNAL). CAS
+ * needs the S32C1I-capable internal RAM on ESP32, so the arena must not
+ * live in PSRAM.
+ */
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "core_arena.h"
+
+typedef struct block {
+    struct block *next;
+} block_t;
+
+typedef struct {
+    block_t *head;
+    block_t *tail;
+    uint32_t count;
+} chain_t;
+
+static DRAM_ATTR const uint16_t k_sizes[CORE_ARENA_CLASSES] = CORE_ARENA_CLASS_SIZES;
+
+static uint8_t *s_base[portNUM_PROCESSORS][CORE_ARENA_CLASSES];
+static uint8_t *s_end[portNUM_PROCESSORS][CORE_ARENA_CLASSES];
+static DRAM_ATTR block_t *s_local[portNUM_PROCESSORS][CORE_ARENA_CLASSES];
+static DRAM_ATTR chain_t s_out[portNUM_PROCESSORS][portNUM_PROCESSORS][CORE_ARENA_CLASSES];
+static DRAM_ATTR _Atomic(block_t *) s_remote[portNUM_PROCESSORS][CORE_ARENA_CLASSES];
+static DRAM_ATTR core_arena_stats_t s_stats[portNUM_PROCESSORS];
+static bool s_ready;
+
+// ------------------------ Lists ------------------------
+
+/**
+ * @brief Push a whole chain onto owner's remote stack with one CAS. Any core.
+ */
+static IRAM_ATTR void remote_push(int owner, int cls, block_t *head, block_t *tail)
+{
+    block_t *old = atomic_load_explicit(&s_remote[owner][cls], memory_order_relaxed);
+    do {
+        tail->next = old;
+    } while (!atomic_compare_exchange_weak_explicit(&s_remote[owner][cls], &old, head,
+                                                    memory_order_release, memory_order_relaxed));
+}
+
+/**
+ * @brief Move the remote stack onto the local free list. Owner core, interrupts masked.
+ */
+static IRAM_ATTR block_t *drain_remote(int core, int cls)
+{
+    block_t *chain = atomic_exchange_explicit(&s_remote[core][cls], NULL, memory_order_acquire);
+    if (chain != NULL) {
+        s_stats[core].drains++;
+    }
+    return chain;
+}
+
+/**
+ * @brief Find the owner and class of p by address range.
+ *
+ * @return false if p is not an arena block.
+ */
+static IRAM_ATTR bool locate(const void *p, int *owner, int *cls)
+{
+    const uint8_t *a = (const uint8_t *)p;
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        for (int k = 0; k < CORE_ARENA_CLASSES; k++) {
+            if (a >= s_base[c][k] && a < s_end[c][k]) {
+                *owner = c;
+                *cls = k;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t core_arena_init(const core_arena_config_t *cfg)
+{
+    if (s_ready) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        for (int k = 0; k < CORE_ARENA_CLASSES; k++) {
+            uint32_t n = (cfg && cfg->blocks[k]) ? cfg->blocks[k] : 64;
+            uint8_t *slab = heap_caps_malloc((size_t)n * k_sizes[k], MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+            if (slab == NULL) {
+                return ESP_ERR_NO_MEM;      // Slabs carved so far stay reserved
+            }
+            s_base[c][k] = slab;
+            s_end[c][k] = slab + (size_t)n * k_sizes[k];
+
+            block_t *head = NULL;
+            for (uint32_t i = n; i-- > 0;) {
+                block_t *b = (block_t *)(slab + (size_t)i * k_sizes[k]);
+                b->next = head;
+                head = b;
+            }
+            s_local[c][k] = head;
+        }
+    }
+    s_ready = true;
+    return ESP_OK;
+}
+
+IRAM_ATTR void *core_arena_alloc(size_t size)
+{
+    int cls = 0;
+    while (cls < CORE_ARENA_CLASSES && size > k_sizes[cls]) {
+        cls++;
+    }
+
+    block_t *b = NULL;
+    if (s_ready) {
+        UBaseType_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+        int core = xPortGetCoreID();
+        core_arena_stats_t *st = &s_stats[core];
+
+        if (cls < CORE_ARENA_CLASSES) {
+            b = s_local[core][cls];
+            if (b == NULL) {
+                b = drain_remote(core, cls);
+            }
+        }
+        if (b != NULL) {
+            s_local[core][cls] = b->next;
+            st->allocs++;
+        } else {
+            st->fallbacks++;        // Oversized or class exhausted
+        }
+        portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+    }
+    if (b == NULL && xPortInIsrContext()) {
+        return NULL;                // The heap is not ISR-safe
+    }
+    return b ? (void *)b : heap_caps_malloc(size, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+}
+
+IRAM_ATTR void core_arena_free(void *p)
+{
+    int owner, cls;
+    if (p == NULL) {
+        return;
+    }
+    if (!locate(p, &owner, &cls)) {
+        heap_caps_free(p);
+        return;
+    }
+
+    block_t *b = (block_t *)p;
+    UBaseType_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+    int core = xPortGetCoreID();
+    core_arena_stats_t *st = &s_stats[core];
+
+    if (owner == core) {
+        b->next = s_local[core][cls];
+        s_local[core][cls] = b;
+        st->frees_local++;
+    } else {
+        chain_t *out = &s_out[core][owner][cls];
+        b->next = out->head;
+        out->head = b;
+        if (out->tail == NULL) {
+            out->tail = b;
+        }
+        st->frees_remote++;
+        st->frees_remote_to[owner]++;
+        if (++out->count == CORE_ARENA_BATCH) {
+            remote_push(owner, cls, out->head, out->tail);
+            *out = (chain_t) { 0 };
+            st->batches_out++;
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+}
+
+IRAM_ATTR void core_arena_flush(void)
+{
+    UBaseType_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+    int core = xPortGetCoreID();
+    for (int owner = 0; owner < portNUM_PROCESSORS; owner++) {
+        for (int k = 0; k < CORE_ARENA_CLASSES; k++) {
+            chain_t *out = &s_out[core][owner][k];
+            if (out->count) {
+                remote_push(owner, k, out->head, out->tail);
+                *out = (chain_t) { 0 };
+                s_stats[core].batches_out++;
+            }
+        }
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+}
+
+void core_arena_get_stats(int core, core_arena_stats_t *out)
+{
+    *out = s_stats[core];           // Single writer per core: a torn copy is off by one at most
+}
+
+void core_arena_report(void)
+{
+    core_arena_stats_t st[portNUM_PROCESSORS];
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        core_arena_get_stats(c, &st[c]);
+    }
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        // Blocks of core c still out: its allocs minus every free of its blocks, on either core
+        uint32_t in_use = st[c].allocs - st[c].frees_local;
+        uint32_t total = 0;
+        for (int d = 0; d < portNUM_PROCESSORS; d++) {
+            in_use -= st[d].frees_remote_to[c];
+        }
+        for (int k = 0; k < CORE_ARENA_CLASSES; k++) {
+            total += (uint32_t)((s_end[c][k] - s_base[c][k]) / k_sizes[k]);
+        }
+        printf("[ARENA] core%d alloc=%" PRIu32 " free local=%" PRIu32 " remote=%" PRIu32
+               " | batches out=%" PRIu32 " drained=%" PRIu32 " | fallback=%" PRIu32 " | in use %" PRIu32 " of %" PRIu32 "\n",
+               c, st[c].allocs, st[c].frees_local, st[c].frees_remote, st[c].batches_out, st[c].drains,
+               st[c].fallbacks, in_use, total);
+    }
+}
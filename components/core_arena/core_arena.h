@@ -0,0 +1,112 @@
+/**
+ * @file core_arena.h
+ * @brief Per-core slab allocator with fixed size classes and batched cross-core frees.
+ *
+ * heap_caps_malloc() takes one heap lock shared by both cores. Tasks pinned
+ * to different cores, as in task_core_affinity.c, spin on each other's
+ * allocations, which shows up as p99 latency spikes. core_arena gives every
+ * core its own slab per size class (CORE_ARENA_CLASS_SIZES), carved once
+ * from internal RAM by core_arena_init():
+ *   - alloc and local free pop/push the core's own free list with
+ *     interrupts masked on that core only. There is no shared lock, so the
+ *     other core never waits.
+ *   - a block freed on the other core goes into that core's outgoing batch
+ *     for the owner. Every CORE_ARENA_BATCH blocks, the whole chain is
+ *     pushed onto the owner's lock-free remote stack with one CAS.
+ *   - when its free list is empty, the owner takes the entire remote stack
+ *     with one atomic exchange. A single exchange by a single consumer
+ *     cannot suffer ABA.
+ * Requests larger than the biggest class, and requests made while a class
+ * is exhausted, fall back to heap_caps_malloc(MALLOC_CAP_INTERNAL). They
+ * are counted as fallbacks. In an ISR there is no fallback: the heap is not
+ * ISR-safe, so such a request returns NULL. core_arena_free() tells arena
+ * blocks from others by address range, so one free call handles both.
+ *
+ * Blocks can sit in another core's outgoing batch while it is short of
+ * CORE_ARENA_BATCH. core_arena_flush() pushes the calling core's batches
+ * early, e.g. from an idle point of a task.
+ *
+ * alloc, free and flush may be called from an ISR, with the limits above:
+ * an ISR gets NULL instead of a heap block, and must not free one.
+ *
+ * core_arena_report() prints one line per core:
+ *   [ARENA] core0 alloc=20000 free local=15000 remote=5000 | batches out=625 drained=610 | fallback=0 | in use 12 of 320
+ *   (illustrative)
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CORE_ARENA_CLASSES      5
+#define CORE_ARENA_CLASS_SIZES  { 32, 64, 128, 256, 512 }
+
+#ifndef CORE_ARENA_BATCH
+#define CORE_ARENA_BATCH        8
+#endif
+
+/**
+ * @brief Blocks per size class per core; zero fields take the default [64].
+ */
+typedef struct {
+    uint16_t blocks[CORE_ARENA_CLASSES];
+} core_arena_config_t;
+
+/** @brief Counters of one core (written by that core only). */
+typedef struct {
+    uint32_t allocs;
+    uint32_t frees_local;
+    uint32_t frees_remote;          //!< Frees of other cores' blocks made on this core
+    uint32_t frees_remote_to[portNUM_PROCESSORS];   //!< The same, by owning core
+    uint32_t batches_out;           //!< Chains pushed to other cores
+    uint32_t drains;                //!< Remote stacks taken over by this core
+    uint32_t fallbacks;             //!< Oversized or class exhausted: heap_caps_malloc(), or NULL in an ISR
+} core_arena_stats_t;
+
+/**
+ * @brief Carve every core's slabs from internal RAM.
+ *
+ * @param cfg Block counts, or NULL for the defaults.
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already initialised, ESP_ERR_NO_MEM.
+ */
+esp_err_t core_arena_init(const core_arena_config_t *cfg);
+
+/**
+ * @brief Allocate from the calling core's smallest fitting class.
+ *
+ * @return Block, or NULL if the heap fallback fails too or, in an ISR, when
+ *         no block of a fitting class is free.
+ */
+void *core_arena_alloc(size_t size);
+
+/**
+ * @brief Free a block from core_arena_alloc() on any core; NULL is ignored.
+ *
+ * In an ISR only arena blocks may be freed, never a heap fallback block.
+ */
+void core_arena_free(void *p);
+
+/**
+ * @brief Push the calling core's partial outgoing batches to their owners now.
+ */
+void core_arena_flush(void);
+
+/**
+ * @brief Copy one core's counters.
+ */
+void core_arena_get_stats(int core, core_arena_stats_t *out);
+
+/**
+ * @brief Print one [ARENA] line per core.
+ */
+void core_arena_report(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,246 @@
+/**
+ * @file core_balancer.c
+ * @brief Core-affinity balancer with hysteresis (see core_balancer.h).
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "cpu_load.h"
+#include "core_balancer.h"
+
+#define TAG "CORE_BAL"
+
+static core_balancer_config_t s_cfg;
+static TaskHandle_t s_balancer;
+static core_balancer_task_t *s_tasks[CORE_BALANCER_MAX_TASKS];
+static size_t s_ntasks;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ------------------------ Worker ------------------------
+
+/**
+ * @brief Runs the step function; re-creates itself on a new core when asked.
+ *
+ * @param arg The core_balancer_task_t.
+ */
+static void balancer_worker(void *arg)
+{
+    core_balancer_task_t *t = (core_balancer_task_t *)arg;
+
+    while (1) {
+        int target = atomic_load(&t->target_core);
+        if (target != t->core) {
+            // Safe point: no step in progress, all state is in t->cfg.arg
+            BaseType_t old = t->core;
+            TaskHandle_t h;
+            t->core = target;
+            if (xTaskCreatePinnedToCore(balancer_worker, t->cfg.name, t->cfg.stack_size, t,
+                                        t->cfg.priority, &h, target) == pdPASS) {
+                portENTER_CRITICAL(&s_lock);
+                t->handle = h;
+                portEXIT_CRITICAL(&s_lock);
+                vTaskDelete(NULL);
+            }
+            ESP_LOGW(TAG, "%s: could not move to core %d, staying on %d", t->cfg.name, target, (int)old);
+            t->core = old;
+            atomic_store(&t->target_core, (int)old);
+        }
+        t->cfg.step(t->cfg.arg);
+    }
+}
+
+/**
+ * @brief Ask @p t to move to @p core.
+ */
+static void migrate(core_balancer_task_t *t, BaseType_t core)
+{
+#if CONFIG_FREERTOS_SMP
+    vTaskCoreAffinitySet(t->handle, 1 << core);
+    t->core = core;
+    atomic_store(&t->target_core, (int)core);
+#else
+    atomic_store(&t->target_core, (int)core);      // Worker moves at its next safe point
+#endif
+    t->moves++;
+    t->last_move = xTaskGetTickCount();
+}
+
+// ------------------------ Balancer ------------------------
+
+/**
+ * @brief Load of a managed task in the last cpu_load window, or -1 if unknown.
+ */
+static float task_load(const cpu_load_task_t *loads, size_t n, TaskHandle_t h)
+{
+    for (size_t i = 0; i < n; i++) {
+        if (loads[i].handle == h) {
+            return loads[i].percent;
+        }
+    }
+    return -1.0f;
+}
+
+/**
+ * @brief Decision loop: one evaluation per period_ms.
+ *
+ * @param arg Unused.
+ */
+static void core_balancer_task(void *arg)
+{
+    static cpu_load_task_t loads[CPU_LOAD_MAX_TASKS];
+    TickType_t last_wake = xTaskGetTickCount();
+    uint32_t streak = 0;
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(s_cfg.period_ms));
+
+        float core_load[portNUM_PROCESSORS];
+        int hi = 0, lo = 0;
+        bool ready = true;
+        for (int c = 0; c < portNUM_PROCESSORS; c++) {
+            core_load[c] = cpu_load_get_core(c);
+            ready = ready && core_load[c] >= 0.0f;
+            hi = core_load[c] > core_load[hi] ? c : hi;
+            lo = core_load[c] < core_load[lo] ? c : lo;
+        }
+        if (!ready) {
+            continue;                       // No cpu_load window yet
+        }
+        float diff = core_load[hi] - core_load[lo];
+
+        if (diff < (float)s_cfg.imbalance_pct) {
+            streak = 0;
+            continue;
+        }
+        if (++streak < s_cfg.confirm_windows) {
+            continue;
+        }
+
+        size_t n = cpu_load_get_tasks(loads, CPU_LOAD_MAX_TASKS);
+        TickType_t now = xTaskGetTickCount();
+        core_balancer_task_t *best = NULL;
+        float best_diff = diff - (float)s_cfg.min_gain_pct;
+        float best_load = 0.0f;
+
+        portENTER_CRITICAL(&s_lock);
+        size_t count = s_ntasks;
+        portEXIT_CRITICAL(&s_lock);
+
+        for (size_t i = 0; i < count; i++) {
+            core_balancer_task_t *t = s_tasks[i];
+            if (t->core != hi || atomic_load(&t->target_core) != t->core) {
+                continue;                   // Other core, or a move is still pending
+            }
+            if (t->moves > 0 && now - t->last_move < pdMS_TO_TICKS(s_cfg.cooldown_ms)) {
+                continue;
+            }
+            portENTER_CRITICAL(&s_lock);
+            TaskHandle_t h = t->handle;
+            portEXIT_CRITICAL(&s_lock);
+
+            float l = task_load(loads, n, h);
+            if (l <= 0.0f) {
+                continue;
+            }
+            float new_diff = fabsf((core_load[hi] - l) - (core_load[lo] + l));
+            if (new_diff < best_diff) {
+                best = t;
+                best_diff = new_diff;
+                best_load = l;
+            }
+        }
+        if (best == NULL) {
+            continue;                       // Imbalanced, but no move helps enough
+        }
+
+        portENTER_CRITICAL(&s_lock);
+        core_balancer_mode_t mode = s_cfg.mode;
+        portEXIT_CRITICAL(&s_lock);
+
+        printf("[BAL] core%d %.1f%% vs core%d %.1f%%: %s %s (%.1f%%) core %d -> %d, expected diff %.1f%%\n",
+               hi, (double)core_load[hi], lo, (double)core_load[lo],
+               mode == CORE_BALANCER_APPLY ? "moving" : "suggest moving",
+               best->cfg.name, (double)best_load, hi, lo, (double)best_diff);
+        if (mode == CORE_BALANCER_APPLY) {
+            migrate(best, lo);
+        }
+        streak = 0;
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t core_balancer_add_task(core_balancer_task_t *t, const core_balancer_task_config_t *cfg)
+{
+    if (t == NULL || cfg == NULL || cfg->step == NULL || cfg->stack_size == 0 ||
+        cfg->core < 0 || cfg->core >= portNUM_PROCESSORS) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    t->cfg = *cfg;
+    t->core = cfg->core;
+    atomic_store(&t->target_core, (int)cfg->core);
+    t->moves = 0;
+    t->last_move = 0;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_ntasks == CORE_BALANCER_MAX_TASKS) {
+        portEXIT_CRITICAL(&s_lock);
+        return ESP_ERR_NO_MEM;
+    }
+    s_tasks[s_ntasks++] = t;
+    portEXIT_CRITICAL(&s_lock);
+
+    TaskHandle_t h;
+    if (xTaskCreatePinnedToCore(balancer_worker, cfg->name, cfg->stack_size, t,
+                                cfg->priority, &h, cfg->core) != pdPASS) {
+        portENTER_CRITICAL(&s_lock);
+        s_ntasks--;                         // t was the last entry
+        portEXIT_CRITICAL(&s_lock);
+        return ESP_ERR_NO_MEM;
+    }
+    portENTER_CRITICAL(&s_lock);
+    t->handle = h;
+    portEXIT_CRITICAL(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t core_balancer_start(const core_balancer_config_t *cfg)
+{
+#if portNUM_PROCESSORS < 2
+    (void)cfg;
+    return ESP_ERR_NOT_SUPPORTED;
+#else
+    if (s_balancer != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (cfg != NULL) {
+        s_cfg = *cfg;
+    }
+    s_cfg.period_ms = s_cfg.period_ms ? s_cfg.period_ms : 1000;
+    s_cfg.imbalance_pct = s_cfg.imbalance_pct ? s_cfg.imbalance_pct : 20;
+    s_cfg.confirm_windows = s_cfg.confirm_windows ? s_cfg.confirm_windows : 2;
+    s_cfg.min_gain_pct = s_cfg.min_gain_pct ? s_cfg.min_gain_pct : 5;
+    s_cfg.cooldown_ms = s_cfg.cooldown_ms ? s_cfg.cooldown_ms : 5000;
+    s_cfg.priority = s_cfg.priority ? s_cfg.priority : 3;
+
+    if (xTaskCreate(core_balancer_task, "core_bal", 3072, NULL, s_cfg.priority, &s_balancer) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+#endif
+}
+
+void core_balancer_set_mode(core_balancer_mode_t mode)
+{
+    portENTER_CRITICAL(&s_lock);
+    s_cfg.mode = mode;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+BaseType_t core_balancer_get_core(const core_balancer_task_t *t)
+{
+    return t->core;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file core_balancer.h
+ * @brief Opt-in core-affinity balancer: moves migratable tasks off the busier core.
+ *
+ * Pinning decided at design time goes stale as the workload changes.
+ * core_balancer reads per-core utilization from components/cpu_load once
+ * per window. When one core stays busier than the other by more than
+ * imbalance_pct for confirm_windows windows in a row, it picks the
+ * migratable task on the busy core whose move best evens out the two
+ * loads. It then either prints the suggestion (CORE_BALANCER_SUGGEST) or
+ * moves the task (CORE_BALANCER_APPLY).
+ *
+ * Hysteresis against bouncing:
+ *   - the imbalance must exceed imbalance_pct for confirm_windows windows
+ *   - a move must shrink the imbalance by at least min_gain_pct
+ *   - a task that moved is left alone for cooldown_ms
+ *   - at most one move per window
+ *
+ * How a task moves:
+ *   ESP-IDF FreeRTOS cannot change the affinity of an existing task, so a
+ *   migratable task is written as a step function that the balancer calls
+ *   in a loop from a worker task it owns. Between two steps, which is a safe
+ *   point by construction, the worker creates its replacement pinned to the
+ *   new core and deletes itself. All state lives in the step's arg, so
+ *   nothing is lost. With CONFIG_FREERTOS_SMP (Amazon SMP kernel)
+ *   vTaskCoreAffinitySet() is used instead and the task is never re-created.
+ *
+ * Only tasks added with core_balancer_add_task() are ever moved. Other
+ * tasks count towards the core loads but keep their pinning. cpu_load must
+ * be running (cpu_load_start()) before core_balancer_start().
+ */
+#pragma once
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CORE_BALANCER_MAX_TASKS
+#define CORE_BALANCER_MAX_TASKS 8
+#endif
+
+/** @brief One unit of work of a migratable task; may block, must return. */
+typedef void (*core_balancer_step_t)(void *arg);
+
+/** @brief What the balancer does with a decision. */
+typedef enum {
+    CORE_BALANCER_SUGGEST,          //!< Print the move only
+    CORE_BALANCER_APPLY,            //!< Print and perform the move
+} core_balancer_mode_t;
+
+/**
+ * @brief Migratable task description.
+ */
+typedef struct {
+    const char *name;
+    core_balancer_step_t step;
+    void *arg;                      //!< Passed to step; holds all task state
+    UBaseType_t priority;
+    uint32_t stack_size;            //!< Bytes
+    BaseType_t core;                //!< Initial core (0 or 1)
+} core_balancer_task_config_t;
+
+/**
+ * @brief Migratable task object; all fields are private.
+ */
+typedef struct {
+    core_balancer_task_config_t cfg;
+    TaskHandle_t handle;            //!< Current worker (changes on migration)
+    BaseType_t core;                //!< Core the worker is pinned to
+    atomic_int target_core;         //!< Core requested by the balancer
+    TickType_t last_move;
+    uint32_t moves;
+} core_balancer_task_t;
+
+/**
+ * @brief Balancer settings; zero fields take the defaults in brackets.
+ */
+typedef struct {
+    core_balancer_mode_t mode;      //!< [CORE_BALANCER_SUGGEST]
+    uint32_t period_ms;             //!< Decision interval, match cpu_load [1000]
+    uint32_t imbalance_pct;         //!< Load difference that triggers a move [20]
+    uint32_t confirm_windows;       //!< Consecutive imbalanced windows required [2]
+    uint32_t min_gain_pct;          //!< Minimum improvement of the difference [5]
+    uint32_t cooldown_ms;           //!< Per-task quiet time after a move [5000]
+    UBaseType_t priority;           //!< Balancer task priority [3]
+} core_balancer_config_t;
+
+/**
+ * @brief Create a migratable task on cfg->core and register it.
+ *
+ * @param t   Task object (static storage).
+ * @param cfg Description, copied.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM (task or registry full).
+ */
+esp_err_t core_balancer_add_task(core_balancer_task_t *t, const core_balancer_task_config_t *cfg);
+
+/**
+ * @brief Start the balancer task.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already running, ESP_ERR_NO_MEM,
+ *         or ESP_ERR_NOT_SUPPORTED on a single-core target.
+ */
+esp_err_t core_balancer_start(const core_balancer_config_t *cfg);
+
+/**
+ * @brief Switch between suggesting and applying at run time.
+ */
+void core_balancer_set_mode(core_balancer_mode_t mode);
+
+/**
+ * @brief Core a migratable task currently runs on.
+ */
+BaseType_t core_balancer_get_core(const core_balancer_task_t *t);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,226 @@
+/**
+ * @file cpu_load.c
+ * @brief Per-task and per-core CPU utilization sampler (see cpu_load.h).
+ *
+ * The total run time returned by uxTaskGetSystemState() is wall-clock time
+ * from the run-time stats clock. Each task's counter only advances while
+ * that task runs on some core. So one window of length T holds T of
+ * capacity per core, and a task's share of one core is
+ * delta_task * 100 / delta_total.
+ *
+ * Counters are unsigned and wrap. Deltas are taken as unsigned differences
+ * in the counter type, which stays correct across one wrap per window.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "cpu_load.h"
+
+#if !configUSE_TRACE_FACILITY || !configGENERATE_RUN_TIME_STATS
+#error "cpu_load needs CONFIG_FREERTOS_USE_TRACE_FACILITY and CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS"
+#endif
+
+// The affinity comes from the snapshot: xTaskGetCoreID() on a handle could race a deletion
+#if !configTASKLIST_INCLUDE_COREID
+#error "cpu_load needs CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID"
+#endif
+
+#ifdef configRUN_TIME_COUNTER_TYPE
+typedef configRUN_TIME_COUNTER_TYPE counter_t;
+#else
+typedef uint32_t counter_t;
+#endif
+
+static cpu_load_config_t s_cfg;
+static TaskHandle_t s_sampler;
+
+// Double-buffered snapshots: s_snap[s_cur] is the newest
+static TaskStatus_t s_snap[2][CPU_LOAD_MAX_TASKS];
+static UBaseType_t s_count[2];
+static counter_t s_total[2];
+static int s_cur;
+
+// Published results
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static cpu_load_task_t s_tasks[CPU_LOAD_MAX_TASKS];
+static size_t s_ntasks;
+static float s_core[portNUM_PROCESSORS] = {
+    [0 ... portNUM_PROCESSORS - 1] = -1.0f
+};
+
+// ------------------------ Helpers ------------------------
+
+/**
+ * @brief Find a task of the previous snapshot by its unique task number.
+ */
+static const TaskStatus_t *find_prev(int prev, UBaseType_t number)
+{
+    for (UBaseType_t i = 0; i < s_count[prev]; i++) {
+        if (s_snap[prev][i].xTaskNumber == number) {
+            return &s_snap[prev][i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Take a new snapshot and publish the deltas against the previous one.
+ *
+ * @return false while there is no previous snapshot yet.
+ */
+static bool sample_window(void)
+{
+    int prev = s_cur;
+    int cur = s_cur ^ 1;
+    counter_t total;
+
+    s_count[cur] = uxTaskGetSystemState(s_snap[cur], CPU_LOAD_MAX_TASKS, &total);
+    s_total[cur] = total;
+    s_cur = cur;
+    if (s_count[prev] == 0 || s_count[cur] == 0) {
+        return false;
+    }
+
+    counter_t window = s_total[cur] - s_total[prev];
+    if (window == 0) {
+        return false;
+    }
+
+    cpu_load_task_t work[CPU_LOAD_MAX_TASKS];
+    float core_load[portNUM_PROCESSORS];
+    size_t n = 0;
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        core_load[c] = 100.0f;
+    }
+    for (UBaseType_t i = 0; i < s_count[cur]; i++) {
+        const TaskStatus_t *now = &s_snap[cur][i];
+        const TaskStatus_t *before = find_prev(prev, now->xTaskNumber);
+        // A task created during the window ran at most since its creation
+        counter_t ran = (counter_t)now->ulRunTimeCounter - (before ? (counter_t)before->ulRunTimeCounter : 0);
+        float pct = (float)ran * 100.0f / (float)window;
+
+        // Idle tasks only feed the per-core figure
+        bool idle = false;
+        for (int c = 0; c < portNUM_PROCESSORS; c++) {
+            if (now->xHandle == xTaskGetIdleTaskHandleForCore(c)) {
+                core_load[c] = 100.0f - pct;
+                idle = true;
+            }
+        }
+        if (idle) {
+            continue;
+        }
+
+        // Insertion sort, busiest first (n <= CPU_LOAD_MAX_TASKS)
+        size_t pos = n++;
+        while (pos > 0 && work[pos - 1].percent < pct) {
+            work[pos] = work[pos - 1];
+            pos--;
+        }
+        work[pos].handle = now->xHandle;
+        snprintf(work[pos].name, sizeof(work[pos].name), "%s", now->pcTaskName);
+        work[pos].core = now->xCoreID;
+        work[pos].priority = now->uxCurrentPriority;
+        work[pos].percent = pct;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    memcpy(s_tasks, work, n * sizeof(work[0]));
+    s_ntasks = n;
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        s_core[c] = core_load[c] < 0.0f ? 0.0f : core_load[c];
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return true;
+}
+
+/**
+ * @brief Sampler task: one window per period, report every report_every windows.
+ *
+ * @param arg Unused.
+ */
+static void cpu_load_task(void *arg)
+{
+    TickType_t last_wake = xTaskGetTickCount();
+    uint32_t windows = 0;
+
+    sample_window();                // Baseline snapshot
+    while (1) {
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(s_cfg.period_ms));
+        if (sample_window() && s_cfg.report_every != UINT32_MAX && ++windows >= s_cfg.report_every) {
+            windows = 0;
+            cpu_load_report();
+        }
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t cpu_load_start(const cpu_load_config_t *cfg)
+{
+    if (s_sampler != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (cfg != NULL) {
+        s_cfg = *cfg;
+    } else {
+        s_cfg.core = tskNO_AFFINITY;
+    }
+    s_cfg.period_ms = s_cfg.period_ms ? s_cfg.period_ms : 1000;
+    s_cfg.report_every = s_cfg.report_every ? s_cfg.report_every : 1;
+    s_cfg.priority = s_cfg.priority ? s_cfg.priority : 2;
+
+    // The work array of one window lives on this stack
+    if (xTaskCreatePinnedToCore(cpu_load_task, "cpu_load", 3072 + sizeof(cpu_load_task_t) * CPU_LOAD_MAX_TASKS,
+                                NULL, s_cfg.priority, &s_sampler, s_cfg.core) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+float cpu_load_get_core(BaseType_t core)
+{
+    if (core < 0 || core >= portNUM_PROCESSORS) {
+        return -1.0f;
+    }
+    portENTER_CRITICAL(&s_lock);
+    float v = s_core[core];
+    portEXIT_CRITICAL(&s_lock);
+    return v;
+}
+
+size_t cpu_load_get_tasks(cpu_load_task_t *out, size_t max)
+{
+    portENTER_CRITICAL(&s_lock);
+    size_t n = s_ntasks < max ? s_ntasks : max;
+    memcpy(out, s_tasks, n * sizeof(out[0]));
+    portEXIT_CRITICAL(&s_lock);
+    return n;
+}
+
+void cpu_load_report(void)
+{
+    cpu_load_task_t top[CPU_LOAD_REPORT_TOP];
+    size_t n = cpu_load_get_tasks(top, CPU_LOAD_REPORT_TOP);
+    char line[64 + CPU_LOAD_REPORT_TOP * (configMAX_TASK_NAME_LEN + 12)];
+    size_t pos = (size_t)snprintf(line, sizeof(line), "[CPU]");
+
+    for (int c = 0; c < portNUM_PROCESSORS && pos < sizeof(line); c++) {
+        pos += (size_t)snprintf(line + pos, sizeof(line) - pos, " core%d %5.1f%% ", c, (double)cpu_load_get_core(c));
+    }
+    if (pos < sizeof(line)) {
+        pos += (size_t)snprintf(line + pos, sizeof(line) - pos, "|");
+    }
+    for (size_t i = 0; i < n && pos < sizeof(line); i++) {
+        if (top[i].core == tskNO_AFFINITY) {
+            pos += (size_t)snprintf(line + pos, sizeof(line) - pos, " %s:%.1f%%@*", top[i].name, (double)top[i].percent);
+        } else {
+            pos += (size_t)snprintf(line + pos, sizeof(line) - pos, " %s:%.1f%%@%d", top[i].name,
+                                    (double)top[i].percent, (int)top[i].core);
+        }
+    }
+    printf("%s\n", line);
+}
@@ -0,0 +1,98 @@
+/**
+ * @file cpu_load.h
+ * @brief Per-task and per-core CPU utilization from FreeRTOS run-time counters.
+ *
+ * Printing xPortGetCoreID() shows where a task runs, not how busy each core
+ * is. cpu_load samples uxTaskGetSystemState() every period_ms and turns the
+ * difference between two snapshots into percentages:
+ *   - per task : run-time delta / window length, as % of one core
+ *   - per core : 100% minus the share of that core's idle task
+ *
+ * The snapshots live in two static TaskStatus_t arrays that swap on every
+ * sample. Nothing is allocated after cpu_load_start(), and one sample costs
+ * one uxTaskGetSystemState() call plus an O(n^2) match over at most
+ * CPU_LOAD_MAX_TASKS entries. Results are published under a spinlock and
+ * read with the getters, or printed every report_every samples as:
+ *
+ *   [CPU] core0  38.2%  core1  96.7%  | ctrl:61.0%@1 sensor:22.4%@1 wifi:18.0%@0
+ *
+ * Requires CONFIG_FREERTOS_USE_TRACE_FACILITY=y,
+ * CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS=y and
+ * CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID=y (TaskStatus_t.xCoreID).
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef CPU_LOAD_MAX_TASKS
+#define CPU_LOAD_MAX_TASKS 32
+#endif
+
+#ifndef CPU_LOAD_REPORT_TOP
+#define CPU_LOAD_REPORT_TOP 6       //!< Busiest tasks listed in the report line
+#endif
+
+/** @brief Load of one task over the last window. */
+typedef struct {
+    TaskHandle_t handle;
+    char name[configMAX_TASK_NAME_LEN];
+    BaseType_t core;                //!< Affinity (tskNO_AFFINITY if unpinned)
+    UBaseType_t priority;
+    float percent;                  //!< Share of one core, 0..100
+} cpu_load_task_t;
+
+/**
+ * @brief Sampler settings; zero fields take the defaults in brackets.
+ */
+typedef struct {
+    uint32_t period_ms;             //!< Window length [1000]
+    uint32_t report_every;          //!< Print every N windows, UINT32_MAX = never [1]
+    UBaseType_t priority;           //!< Sampler priority [2]
+    BaseType_t core;                //!< Sampler core [tskNO_AFFINITY]
+} cpu_load_config_t;
+
+/**
+ * @brief Start the sampler task.
+ *
+ * Windows are measured with the kernel's total run time, so the numbers
+ * stay exact even when the sampler runs late. Raise the priority only if
+ * both cores are saturated and the sampler starves.
+ *
+ * @param cfg Settings, or NULL for all defaults.
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already running, ESP_ERR_NO_MEM.
+ */
+esp_err_t cpu_load_start(const cpu_load_config_t *cfg);
+
+/**
+ * @brief Utilization of @p core over the last window (0..100, -1 before the first window).
+ */
+float cpu_load_get_core(BaseType_t core);
+
+/**
+ * @brief Copy the per-task loads of the last window, busiest first.
+ *
+ * Idle tasks are not listed; their time is what cpu_load_get_core() reports as free.
+ *
+ * @param out Destination array.
+ * @param max Capacity of @p out.
+ * @return Entries written.
+ */
+size_t cpu_load_get_tasks(cpu_load_task_t *out, size_t max);
+
+/**
+ * @brief Print the last window as one compact line.
+ */
+void cpu_load_report(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,263 @@
+/**
+ * @file deadline_boost.c
+ * @brief Deadline-aware priority boosting supervisor (see deadline_boost.h).
+ *
+ * vTaskPrioritySet() may yield, so it is never called inside s_lock. That
+ * leaves a window where the supervisor boosts a job that has just
+ * completed. After each boost the supervisor therefore re-checks, under
+ * the lock, that the same job is still running. If not, it puts the base
+ * priority back. The task and the supervisor both end at the base
+ * priority whichever of them runs first.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_timer.h"
+#include "deadline_boost.h"
+
+typedef enum {
+    EV_BOOST,
+    EV_MET,
+    EV_MISS,
+} event_type_t;
+
+typedef struct {
+    int64_t at_us;
+    const deadline_task_t *task;
+    event_type_t type;
+    uint32_t ms;                    //!< Elapsed (boost) or response time (met/miss)
+    UBaseType_t from, to;           //!< Priorities (boost)
+    bool boosted;                   //!< Met/miss: job was boosted
+} event_t;
+
+static deadline_boost_config_t s_cfg;
+static TaskHandle_t s_supervisor;
+static deadline_task_t *s_tasks[DEADLINE_BOOST_MAX_TASKS];
+static int s_ntasks;
+static event_t s_log[DEADLINE_BOOST_LOG_SIZE];
+static uint32_t s_log_head;         //!< Events written (wraps the log)
+static uint32_t s_log_read;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ------------------------ Helpers ------------------------
+
+/**
+ * @brief Append an event; the oldest unread one is overwritten when full. Call with s_lock held.
+ */
+static void log_event(const deadline_task_t *t, event_type_t type, uint32_t ms,
+                      UBaseType_t from, UBaseType_t to, bool boosted)
+{
+    event_t *e = &s_log[s_log_head % DEADLINE_BOOST_LOG_SIZE];
+    e->at_us = esp_timer_get_time();
+    e->task = t;
+    e->type = type;
+    e->ms = ms;
+    e->from = from;
+    e->to = to;
+    e->boosted = boosted;
+    s_log_head++;
+    if (s_log_head - s_log_read > DEADLINE_BOOST_LOG_SIZE) {
+        s_log_read = s_log_head - DEADLINE_BOOST_LOG_SIZE;
+    }
+}
+
+// ------------------------ Supervisor ------------------------
+
+/**
+ * @brief Boosts jobs that crossed their guard time; flags deadline overruns.
+ *
+ * @param arg Unused.
+ */
+static void deadline_boost_task(void *arg)
+{
+    TickType_t period = pdMS_TO_TICKS(s_cfg.check_period_ms);
+    TickType_t last_wake = xTaskGetTickCount();
+
+    if (period == 0) {
+        period = 1;
+    }
+    while (1) {
+        vTaskDelayUntil(&last_wake, period);
+        int64_t now = esp_timer_get_time();
+
+        for (int i = 0; i < s_ntasks; i++) {
+            deadline_task_t *t = s_tasks[i];
+            bool boost = false;
+            int64_t release = 0;
+
+            portENTER_CRITICAL(&s_lock);
+            if (t->active) {
+                int64_t elapsed = now - t->release_us;
+                int64_t guard = (int64_t)t->cfg.deadline_ms * t->cfg.guard_pct * 10;   // µs
+                if (s_cfg.enabled && !t->boosted && elapsed >= guard) {
+                    t->boosted = true;
+                    t->boosts++;
+                    boost = true;
+                    release = t->release_us;
+                    log_event(t, EV_BOOST, (uint32_t)(elapsed / 1000), t->base_priority,
+                              t->cfg.boost_priority, true);
+                }
+                if (elapsed > (int64_t)t->cfg.deadline_ms * 1000) {
+                    t->missed = true;
+                }
+            }
+            portEXIT_CRITICAL(&s_lock);
+
+            if (boost) {
+                vTaskPrioritySet(t->handle, t->cfg.boost_priority);
+
+                portENTER_CRITICAL(&s_lock);
+                bool stale = !t->active || t->release_us != release;
+                UBaseType_t base = t->base_priority;
+                portEXIT_CRITICAL(&s_lock);
+                if (stale) {
+                    vTaskPrioritySet(t->handle, base);  // Job completed meanwhile
+                }
+            }
+        }
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t deadline_boost_start(const deadline_boost_config_t *cfg)
+{
+    if (s_supervisor != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (cfg != NULL) {
+        s_cfg = *cfg;
+    } else {
+        s_cfg.core = tskNO_AFFINITY;
+        s_cfg.enabled = true;
+    }
+    s_cfg.check_period_ms = s_cfg.check_period_ms ? s_cfg.check_period_ms : 1;
+    s_cfg.priority = s_cfg.priority ? s_cfg.priority : configMAX_PRIORITIES - 2;
+
+    if (xTaskCreatePinnedToCore(deadline_boost_task, "deadline_boost", 2048, NULL,
+                                s_cfg.priority, &s_supervisor, s_cfg.core) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t deadline_boost_register(deadline_task_t *t, TaskHandle_t task, const deadline_task_config_t *cfg)
+{
+    if (t == NULL || cfg == NULL || cfg->deadline_ms == 0 || cfg->boost_priority >= configMAX_PRIORITIES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *t = (deadline_task_t) {
+        .cfg = *cfg,
+        .handle = task ? task : xTaskGetCurrentTaskHandle(),
+    };
+    if (t->cfg.guard_pct == 0 || t->cfg.guard_pct > 100) {
+        t->cfg.guard_pct = 50;
+    }
+    t->base_priority = uxTaskPriorityGet(t->handle);
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_ntasks == DEADLINE_BOOST_MAX_TASKS) {
+        portEXIT_CRITICAL(&s_lock);
+        return ESP_ERR_NO_MEM;
+    }
+    s_tasks[s_ntasks++] = t;
+    portEXIT_CRITICAL(&s_lock);
+    return ESP_OK;
+}
+
+void deadline_boost_release(deadline_task_t *t)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    t->release_us = now;
+    t->active = true;
+    t->boosted = false;
+    t->missed = false;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+bool deadline_boost_complete(deadline_task_t *t)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    uint32_t resp = (uint32_t)(now - t->release_us);
+    bool met = resp <= t->cfg.deadline_ms * 1000 && !t->missed;
+    bool was_boosted = t->boosted;
+    UBaseType_t base = t->base_priority;
+
+    t->active = false;
+    t->boosted = false;
+    t->jobs++;
+    t->resp_sum_us += resp;
+    if (resp > t->resp_max_us) {
+        t->resp_max_us = resp;
+    }
+    if (!met) {
+        t->misses++;
+        log_event(t, EV_MISS, resp / 1000, 0, 0, was_boosted);
+    } else if (was_boosted) {
+        t->rescued++;
+        log_event(t, EV_MET, resp / 1000, 0, 0, true);
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (was_boosted) {
+        vTaskPrioritySet(t->handle, base);
+    }
+    return met;
+}
+
+void deadline_boost_set_base_priority(deadline_task_t *t, UBaseType_t priority)
+{
+    portENTER_CRITICAL(&s_lock);
+    t->base_priority = priority;
+    bool boosted = t->boosted;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (!boosted) {
+        vTaskPrioritySet(t->handle, priority);
+    }
+}
+
+void deadline_boost_report(void)
+{
+    for (int i = 0; i < s_ntasks; i++) {
+        deadline_task_t *t = s_tasks[i];
+        portENTER_CRITICAL(&s_lock);
+        deadline_task_t c = *t;
+        portEXIT_CRITICAL(&s_lock);
+
+        printf("[DLB] %-8s jobs=%" PRIu32 " boosts=%" PRIu32 " rescued=%" PRIu32 " miss=%" PRIu32
+               " | resp avg %" PRIu32 " max %" PRIu32 " ms (deadline %" PRIu32 ")\n",
+               c.cfg.name, c.jobs, c.boosts, c.rescued, c.misses,
+               c.jobs ? (uint32_t)(c.resp_sum_us / c.jobs / 1000) : 0,
+               c.resp_max_us / 1000, c.cfg.deadline_ms);
+    }
+
+    while (1) {
+        event_t e;
+        portENTER_CRITICAL(&s_lock);
+        bool have = s_log_read != s_log_head;
+        if (have) {
+            e = s_log[s_log_read % DEADLINE_BOOST_LOG_SIZE];
+            s_log_read++;
+        }
+        portEXIT_CRITICAL(&s_lock);
+        if (!have) {
+            break;
+        }
+
+        uint32_t ms = (uint32_t)(e.at_us / 1000);
+        if (e.type == EV_BOOST) {
+            printf("[DLB]  t=%" PRIu32 ".%03" PRIu32 "s %-8s BOOST %u->%u at %" PRIu32 " ms\n",
+                   ms / 1000, ms % 1000, e.task->cfg.name, (unsigned)e.from, (unsigned)e.to, e.ms);
+        } else {
+            printf("[DLB]  t=%" PRIu32 ".%03" PRIu32 "s %-8s %s after %" PRIu32 " ms%s\n",
+                   ms / 1000, ms % 1000, e.task->cfg.name, e.type == EV_MET ? "MET " : "MISS",
+                   e.ms, e.boosted ? " (boosted)" : "");
+        }
+    }
+}
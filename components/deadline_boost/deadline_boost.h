@@ -0,0 +1,128 @@
+/**
+ * @file deadline_boost.h
+ * @brief Deadline-aware priority boosting: raise a late job's priority, restore it when the job completes.
+ *
+ * A fixed priority is right on average and wrong under overload: a
+ * low-priority task with a tight deadline misses whenever a higher-priority
+ * task has a long burst. deadline_boost lets each task declare a period and
+ * a relative deadline, and brackets every job:
+ *   deadline_boost_release(t)   at the start of the job
+ *   deadline_boost_complete(t)  at the end of the job
+ * A supervisor task checks the running jobs every check_period_ms. When a
+ * job has used guard_pct of its deadline without completing, it raises the
+ * task to boost_priority. deadline_boost_complete() puts the base priority
+ * back.
+ *
+ * Per task it counts jobs, boosts, "rescued" jobs (boosted, then made the
+ * deadline) and misses (completed after the deadline, boosted or not). The
+ * last DEADLINE_BOOST_LOG_SIZE events are kept in a small log. The
+ * supervisor never prints. deadline_boost_report() does, from whichever
+ * task calls it:
+ *   [DLB] ctrl   jobs=250 boosts=41 rescued=39 miss=2 | resp avg 38 max 131 ms (deadline 100)
+ *   [DLB]  t=12.400s ctrl   BOOST 1->3 at 50 ms
+ *   [DLB]  t=12.441s ctrl   MET   after 91 ms (boosted)
+ *
+ * A rescued job would not necessarily have missed without the boost.
+ * Compare the miss counts with boosting disabled to see the real effect.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef DEADLINE_BOOST_MAX_TASKS
+#define DEADLINE_BOOST_MAX_TASKS 8
+#endif
+
+#ifndef DEADLINE_BOOST_LOG_SIZE
+#define DEADLINE_BOOST_LOG_SIZE 16
+#endif
+
+/**
+ * @brief Timing contract of one task.
+ */
+typedef struct {
+    const char *name;
+    uint32_t period_ms;             //!< Informational (report only)
+    uint32_t deadline_ms;           //!< Relative to deadline_boost_release()
+    uint32_t guard_pct;             //!< Boost after this share of the deadline [50]
+    UBaseType_t boost_priority;     //!< Priority while boosted
+} deadline_task_config_t;
+
+/**
+ * @brief Task record; all fields are private.
+ */
+typedef struct {
+    deadline_task_config_t cfg;
+    TaskHandle_t handle;
+    UBaseType_t base_priority;      //!< Priority at registration or last complete
+    int64_t release_us;
+    bool active;                    //!< Between release and complete
+    bool boosted;
+    bool missed;                    //!< Current job already past its deadline
+    uint32_t jobs;
+    uint32_t boosts;
+    uint32_t rescued;
+    uint32_t misses;
+    uint64_t resp_sum_us;
+    uint32_t resp_max_us;
+} deadline_task_t;
+
+/**
+ * @brief Supervisor settings; zero fields take the defaults in brackets.
+ */
+typedef struct {
+    uint32_t check_period_ms;       //!< Scan interval, rounded up to one tick [1]
+    UBaseType_t priority;           //!< Keep above every boost_priority [configMAX_PRIORITIES - 2]
+    BaseType_t core;                //!< [tskNO_AFFINITY]
+    bool enabled;                   //!< false: measure only, never boost
+} deadline_boost_config_t;
+
+/**
+ * @brief Start the supervisor.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already running, ESP_ERR_NO_MEM.
+ */
+esp_err_t deadline_boost_start(const deadline_boost_config_t *cfg);
+
+/**
+ * @brief Register @p task (NULL = calling task) with its timing contract.
+ *
+ * The task's current priority becomes its base priority.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM (table full).
+ */
+esp_err_t deadline_boost_register(deadline_task_t *t, TaskHandle_t task, const deadline_task_config_t *cfg);
+
+/**
+ * @brief Start a job: its deadline is now + deadline_ms.
+ */
+void deadline_boost_release(deadline_task_t *t);
+
+/**
+ * @brief Finish the current job: account it and restore the base priority.
+ *
+ * @return true if the deadline was met.
+ */
+bool deadline_boost_complete(deadline_task_t *t);
+
+/**
+ * @brief Change the base priority (the priority restored after a boost).
+ */
+void deadline_boost_set_base_priority(deadline_task_t *t, UBaseType_t priority);
+
+/**
+ * @brief Print one [DLB] line per task and the event log, then clear the log.
+ */
+void deadline_boost_report(void);
+
+#ifdef __cplusplus
+}
+#endif
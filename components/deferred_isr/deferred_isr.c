@@ -0,0 +1,249 @@
+/**
+ * @file deferred_isr.c
+ * @brief ISR-to-task deferred work with latency measurement (see deferred_isr.h).
+ *
+ * The ring carries (source id, payload, two timestamps). Its indices are
+ * only touched under s_ring_lock, so several ISRs and both cores may post.
+ * Signals do not use the ring: the ISR bumps the source's pending count and
+ * remembers the entry stamp of the oldest pending signal.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include "deferred_isr.h"
+
+_Static_assert((DEFERRED_ISR_RING_SIZE & (DEFERRED_ISR_RING_SIZE - 1)) == 0,
+               "DEFERRED_ISR_RING_SIZE must be a power of two");
+
+typedef struct {
+    uint8_t src;
+    uint32_t data;
+    int64_t t_entry;
+    int64_t t_post;
+} ring_item_t;
+
+static DRAM_ATTR ring_item_t s_ring[DEFERRED_ISR_RING_SIZE];
+static uint32_t s_head;
+static uint32_t s_tail;
+static DRAM_ATTR portMUX_TYPE s_ring_lock = portMUX_INITIALIZER_UNLOCKED;
+static portMUX_TYPE s_stats_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static deferred_isr_source_t *s_sources[DEFERRED_ISR_MAX_SOURCES];
+static int s_nsources;
+static TaskHandle_t s_task;
+
+// ------------------------ ISR side ------------------------
+
+bool IRAM_ATTR deferred_isr_post_from_isr(deferred_isr_source_t *src, uint32_t data, int64_t t_entry, BaseType_t *hpw)
+{
+    int64_t now = esp_timer_get_time();
+    bool stored = false;
+
+    portENTER_CRITICAL_ISR(&s_ring_lock);
+    if (s_head - s_tail < DEFERRED_ISR_RING_SIZE) {
+        ring_item_t *it = &s_ring[s_head & (DEFERRED_ISR_RING_SIZE - 1)];
+        it->src = src->id;
+        it->data = data;
+        it->t_entry = t_entry ? t_entry : now;
+        it->t_post = now;
+        s_head++;
+        stored = true;
+    } else {
+        src->drops++;
+    }
+    portEXIT_CRITICAL_ISR(&s_ring_lock);
+
+    if (stored) {
+        vTaskNotifyGiveFromISR(s_task, hpw);
+    }
+    return stored;
+}
+
+void IRAM_ATTR deferred_isr_signal_from_isr(deferred_isr_source_t *src, int64_t t_entry, BaseType_t *hpw)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL_ISR(&s_ring_lock);
+    if (src->pending++ == 0) {
+        src->pending_entry = t_entry ? t_entry : now;
+        src->pending_post = now;
+    }
+    portEXIT_CRITICAL_ISR(&s_ring_lock);
+
+    vTaskNotifyGiveFromISR(s_task, hpw);
+}
+
+// ------------------------ Handler task ------------------------
+
+static void acc_add(deferred_isr_acc_t *acc, int64_t us)
+{
+    uint32_t v = us > 0 ? (uint32_t)us : 0;
+    acc->sum += v;
+    if (v < acc->min) {
+        acc->min = v;
+    }
+    if (v > acc->max) {
+        acc->max = v;
+    }
+}
+
+static void acc_reset(deferred_isr_acc_t *acc)
+{
+    acc->sum = 0;
+    acc->min = UINT32_MAX;
+    acc->max = 0;
+}
+
+static void acc_get(const deferred_isr_acc_t *acc, uint32_t count, deferred_isr_latency_t *out)
+{
+    out->min_us = count ? acc->min : 0;
+    out->avg_us = count ? (uint32_t)(acc->sum / count) : 0;
+    out->max_us = acc->max;
+}
+
+/**
+ * @brief Run one bottom half and account its three latency components.
+ */
+static void dispatch(deferred_isr_source_t *src, uint32_t data, int64_t t_entry, int64_t t_post)
+{
+    deferred_isr_event_t ev = { .data = data, .t_entry = t_entry, .t_post = t_post };
+    int64_t t_start = esp_timer_get_time();
+    src->handler(src->arg, &ev);
+    int64_t t_end = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_stats_lock);
+    src->count++;
+    acc_add(&src->isr, t_post - t_entry);
+    acc_add(&src->wake, t_start - t_post);
+    acc_add(&src->run, t_end - t_start);
+    acc_add(&src->total, t_end - t_entry);
+    portEXIT_CRITICAL(&s_stats_lock);
+}
+
+/**
+ * @brief Drains the ring and the pending signals after every notification.
+ *
+ * @param arg Unused.
+ */
+static void deferred_isr_task(void *arg)
+{
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        bool more = true;
+        while (more) {
+            more = false;
+
+            ring_item_t it;
+            while (1) {
+                portENTER_CRITICAL(&s_ring_lock);
+                bool have = s_tail != s_head;
+                if (have) {
+                    it = s_ring[s_tail & (DEFERRED_ISR_RING_SIZE - 1)];
+                    s_tail++;
+                }
+                portEXIT_CRITICAL(&s_ring_lock);
+                if (!have) {
+                    break;
+                }
+                dispatch(s_sources[it.src], it.data, it.t_entry, it.t_post);
+            }
+
+            for (int i = 0; i < s_nsources; i++) {
+                deferred_isr_source_t *src = s_sources[i];
+                portENTER_CRITICAL(&s_ring_lock);
+                uint32_t n = src->pending;
+                int64_t t_entry = src->pending_entry;
+                int64_t t_post = src->pending_post;
+                src->pending = 0;
+                portEXIT_CRITICAL(&s_ring_lock);
+                if (n) {
+                    dispatch(src, n, t_entry, t_post);
+                    more = true;            // Events may have arrived meanwhile
+                }
+            }
+        }
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t deferred_isr_init(UBaseType_t priority, BaseType_t core)
+{
+    if (s_task != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xTaskCreatePinnedToCore(deferred_isr_task, "deferred_isr", 4096, NULL,
+                                priority, &s_task, core) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t deferred_isr_register(deferred_isr_source_t *src, const char *name,
+                                deferred_isr_handler_t handler, void *arg)
+{
+    if (src == NULL || handler == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_nsources == DEFERRED_ISR_MAX_SOURCES) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    memset(src, 0, sizeof(*src));
+    src->name = name ? name : "isr";
+    src->handler = handler;
+    src->arg = arg;
+    src->id = (uint8_t)s_nsources;
+    acc_reset(&src->isr);
+    acc_reset(&src->wake);
+    acc_reset(&src->run);
+    acc_reset(&src->total);
+    s_sources[s_nsources++] = src;
+    return ESP_OK;
+}
+
+void deferred_isr_get_stats(deferred_isr_source_t *src, deferred_isr_stats_t *out, bool reset)
+{
+    portENTER_CRITICAL(&s_stats_lock);
+    out->count = src->count;
+    acc_get(&src->isr, src->count, &out->isr);
+    acc_get(&src->wake, src->count, &out->wake);
+    acc_get(&src->run, src->count, &out->run);
+    acc_get(&src->total, src->count, &out->total);
+    if (reset) {
+        src->count = 0;
+        acc_reset(&src->isr);
+        acc_reset(&src->wake);
+        acc_reset(&src->run);
+        acc_reset(&src->total);
+    }
+    portEXIT_CRITICAL(&s_stats_lock);
+
+    // Drops are counted by the ISRs under the ring lock
+    portENTER_CRITICAL(&s_ring_lock);
+    out->drops = src->drops;
+    if (reset) {
+        src->drops = 0;
+    }
+    portEXIT_CRITICAL(&s_ring_lock);
+}
+
+void deferred_isr_report(void)
+{
+    for (int i = 0; i < s_nsources; i++) {
+        deferred_isr_stats_t st;
+        deferred_isr_get_stats(s_sources[i], &st, true);
+        printf("[DISR] %s n=%" PRIu32 " drop=%" PRIu32
+               " | isr %" PRIu32 "/%" PRIu32 "/%" PRIu32
+               " wake %" PRIu32 "/%" PRIu32 "/%" PRIu32
+               " run %" PRIu32 "/%" PRIu32 "/%" PRIu32
+               " | total %" PRIu32 "/%" PRIu32 "/%" PRIu32 " us\n",
+               s_sources[i]->name, st.count, st.drops,
+               st.isr.min_us, st.isr.avg_us, st.isr.max_us,
+               st.wake.min_us, st.wake.avg_us, st.wake.max_us,
+               st.run.min_us, st.run.avg_us, st.run.max_us,
+               st.total.min_us, st.total.avg_us, st.total.max_us);
+    }
+}
@@ -0,0 +1,247 @@
+/**
+ * @file deferred_log.c
+ * @brief Deferred binary logger with per-core rings (see deferred_log.h).
+ *
+ * Each core's ring has many writers (every task and ISR on that core) and
+ * exactly one reader (the drain task). Writers are serialized by masking
+ * interrupts on their own core only. head is published with a release
+ * store and tail with a release store from the reader, so the two cores
+ * never share a lock.
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "deferred_log.h"
+
+#define DLOG_TAG        "DLOG"
+#define DLOG_LINE_MAX   256
+#define DLOG_RING_MASK  (DLOG_RING_RECORDS - 1)
+
+_Static_assert((DLOG_RING_RECORDS & DLOG_RING_MASK) == 0, "DLOG_RING_RECORDS must be a power of two");
+
+/** @brief Compact binary log record. */
+typedef struct {
+    const char *tag;
+    const char *fmt;
+    int64_t ts_us;
+    char level;
+    uint8_t nargs;
+    dlog_arg_t args[DLOG_MAX_ARGS];
+} dlog_record_t;
+
+/** @brief Ring owned by one core. */
+typedef struct {
+    atomic_uint head;               //!< Written by tasks/ISRs on the owning core
+    atomic_uint tail;               //!< Written by the drain task
+    uint32_t written;
+    uint32_t dropped;
+    dlog_record_t records[DLOG_RING_RECORDS];
+} dlog_ring_t;
+
+static dlog_ring_t s_rings[portNUM_PROCESSORS];
+static TaskHandle_t s_drain_task;
+
+// ------------------------ Hot path ------------------------
+
+void dlog_write(char level, const char *tag, const char *fmt, uint8_t nargs, const dlog_arg_t *args)
+{
+    int64_t now = esp_timer_get_time();
+    if (nargs > DLOG_MAX_ARGS) {
+        nargs = DLOG_MAX_ARGS;
+    }
+
+    // Masking interrupts on this core also pins us here for the write.
+    UBaseType_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+    dlog_ring_t *r = &s_rings[xPortGetCoreID()];
+
+    uint32_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+    uint32_t next = (head + 1) & DLOG_RING_MASK;
+    if (next == atomic_load_explicit(&r->tail, memory_order_acquire)) {
+        r->dropped++;
+    } else {
+        dlog_record_t *rec = &r->records[head];
+        rec->tag = tag;
+        rec->fmt = fmt;
+        rec->ts_us = now;
+        rec->level = level;
+        rec->nargs = nargs;
+        memcpy(rec->args, args, nargs * sizeof(dlog_arg_t));
+        atomic_store_explicit(&r->head, next, memory_order_release);
+        r->written++;
+    }
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+}
+
+// ------------------------ Formatting ------------------------
+
+typedef enum { LEN_INT, LEN_LONG, LEN_LLONG, LEN_SIZE } len_class_t;
+
+/**
+ * @brief Append one formatted conversion to the line buffer.
+ *
+ * @param spec  NUL-terminated conversion spec, e.g. "%08lx".
+ * @param conv  Conversion character (last char of spec).
+ * @param len   Length modifier class.
+ * @param arg   Captured argument.
+ * @return Characters written (as snprintf).
+ */
+static int format_one(char *dst, size_t room, const char *spec, char conv, len_class_t len, dlog_arg_t arg)
+{
+    switch (conv) {
+    case 'd': case 'i':
+        switch (len) {
+        case LEN_LLONG: return snprintf(dst, room, spec, (long long)arg.i);
+        case LEN_LONG:  return snprintf(dst, room, spec, (long)arg.i);
+        case LEN_SIZE:  return snprintf(dst, room, spec, (size_t)arg.i);
+        default:        return snprintf(dst, room, spec, (int)arg.i);
+        }
+    case 'u': case 'x': case 'X': case 'o':
+        switch (len) {
+        case LEN_LLONG: return snprintf(dst, room, spec, (unsigned long long)arg.i);
+        case LEN_LONG:  return snprintf(dst, room, spec, (unsigned long)arg.i);
+        case LEN_SIZE:  return snprintf(dst, room, spec, (size_t)arg.i);
+        default:        return snprintf(dst, room, spec, (unsigned)arg.i);
+        }
+    case 'c':
+        return snprintf(dst, room, spec, (int)arg.i);
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        return snprintf(dst, room, spec, arg.f);
+    case 's':
+        return snprintf(dst, room, spec, arg.p ? (const char *)arg.p : "(null)");
+    case 'p':
+        return snprintf(dst, room, spec, arg.p);
+    default:
+        return snprintf(dst, room, "%s", spec);     // Unknown: print verbatim
+    }
+}
+
+/**
+ * @brief Expand a record's format string with its captured arguments.
+ */
+static void format_record(const dlog_record_t *rec, char *line, size_t size)
+{
+    size_t pos = (size_t)snprintf(line, size, "%c (%lu) %s: ", rec->level,
+                                  (unsigned long)(rec->ts_us / 1000), rec->tag);
+    const char *f = rec->fmt;
+    uint8_t argi = 0;
+
+    while (*f != '\0' && pos < size - 1) {
+        if (*f != '%') {
+            line[pos++] = *f++;
+            continue;
+        }
+        if (f[1] == '%') {
+            line[pos++] = '%';
+            f += 2;
+            continue;
+        }
+
+        // Collect "%[flags][width][.prec][length]conv" into spec.
+        char spec[24];
+        size_t n = 0;
+        len_class_t len = LEN_INT;
+        spec[n++] = *f++;
+        while (*f != '\0' && strchr("-+ #0123456789.", *f) != NULL && n < sizeof(spec) - 4) {
+            spec[n++] = *f++;
+        }
+        while (*f != '\0' && strchr("hlzjtL", *f) != NULL && n < sizeof(spec) - 2) {
+            if (*f == 'l') {
+                len = (len == LEN_LONG) ? LEN_LLONG : LEN_LONG;
+            } else if (*f == 'j') {
+                len = LEN_LLONG;
+            } else if (*f == 'z' || *f == 't') {
+                len = LEN_SIZE;
+            }
+            if (*f != 'L') {        // Long double args are captured as double
+                spec[n++] = *f;
+            }
+            f++;
+        }
+        if (*f == '\0') {
+            break;
+        }
+        char conv = *f++;
+        spec[n++] = conv;
+        spec[n] = '\0';
+
+        dlog_arg_t arg = { .i = 0 };
+        if (argi < rec->nargs) {
+            arg = rec->args[argi++];
+        }
+        int w = format_one(line + pos, size - pos, spec, conv, len, arg);
+        if (w > 0) {
+            pos += (size_t)w;
+        }
+    }
+    if (pos > size - 2) {
+        pos = size - 2;
+    }
+    line[pos++] = '\n';
+    line[pos] = '\0';
+}
+
+// ------------------------ Drain task ------------------------
+
+/**
+ * @brief Low-priority task that formats and prints queued records.
+ *
+ * Drains both rings every DLOG_DRAIN_PERIOD_MS oldest-first per core, and
+ * reports new drops once per pass.
+ *
+ * @param arg Unused.
+ */
+static void dlog_drain_task(void *arg)
+{
+    static char line[DLOG_LINE_MAX];
+    uint32_t reported_drops[portNUM_PROCESSORS] = { 0 };
+
+    while (1) {
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            dlog_ring_t *r = &s_rings[core];
+            uint32_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+
+            while (tail != atomic_load_explicit(&r->head, memory_order_acquire)) {
+                format_record(&r->records[tail], line, sizeof(line));
+                tail = (tail + 1) & DLOG_RING_MASK;
+                atomic_store_explicit(&r->tail, tail, memory_order_release);
+                fputs(line, stdout);
+            }
+
+            uint32_t dropped = r->dropped;
+            if (dropped != reported_drops[core]) {
+                printf("W (%lu) %s: core %d ring full, %lu records dropped (total %lu)\n",
+                       (unsigned long)(esp_timer_get_time() / 1000), DLOG_TAG, core,
+                       (unsigned long)(dropped - reported_drops[core]), (unsigned long)dropped);
+                reported_drops[core] = dropped;
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(DLOG_DRAIN_PERIOD_MS));
+    }
+}
+
+esp_err_t dlog_init(UBaseType_t priority, BaseType_t core)
+{
+    if (s_drain_task != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xTaskCreatePinnedToCore(dlog_drain_task, "dlog_drain", 3072, NULL,
+                                priority, &s_drain_task, core) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+void dlog_get_stats(BaseType_t core, dlog_core_stats_t *out)
+{
+    if (core < 0 || core >= portNUM_PROCESSORS) {
+        out->written = 0;
+        out->dropped = 0;
+        return;
+    }
+    out->written = s_rings[core].written;
+    out->dropped = s_rings[core].dropped;
+}
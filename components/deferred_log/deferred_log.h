@@ -0,0 +1,127 @@
+/**
+ * @file deferred_log.h
+ * @brief Non-blocking deferred logger: hot tasks record, a low-priority task formats.
+ *
+ * ESP_LOGI() formats the message (floats included) and writes it to the
+ * UART inside the calling task, so the console shows up as jitter in
+ * whatever the task is timing. DLOGI() only stores a compact binary record
+ * in a ring owned by the current core: the format-string pointer, a
+ * timestamp and up to DLOG_MAX_ARGS raw arguments. A low-priority drain
+ * task formats and prints the records later.
+ *
+ * Hot path properties:
+ *   - no lock shared between cores: each core has its own ring. Writers on
+ *     one core are serialized by briefly masking that core's interrupts,
+ *     which also keeps the task from migrating mid-write.
+ *   - no kernel call and no formatting: the drain task polls every
+ *     DLOG_DRAIN_PERIOD_MS.
+ *   - never blocks: when a ring is full the record is dropped and counted.
+ *     The drain task reports drops as a warning line.
+ *
+ * Argument rules:
+ *   - at most DLOG_MAX_ARGS arguments per call
+ *   - integers, floats/doubles, pointers (%p) and strings (%s) are supported;
+ *     strings are stored by pointer and must outlive the record (string literals)
+ *   - the format string must be a string literal or otherwise static
+ *   - '*' width/precision is not supported
+ *
+ * Usage:
+ *   dlog_init(1, tskNO_AFFINITY);
+ *   DLOGI(TAG, "period=%.2f ms sample=%d", dt_ms, sample);
+ */
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef DLOG_MAX_ARGS
+#define DLOG_MAX_ARGS 6
+#endif
+
+#ifndef DLOG_RING_RECORDS
+#define DLOG_RING_RECORDS 64        //!< Per core, power of two (one slot unused)
+#endif
+
+#ifndef DLOG_DRAIN_PERIOD_MS
+#define DLOG_DRAIN_PERIOD_MS 20
+#endif
+
+/** @brief One captured argument, interpreted by the drain task per conversion. */
+typedef union {
+    int64_t i;
+    double f;
+    const void *p;
+} dlog_arg_t;
+
+/** @brief Counters for one core's ring. */
+typedef struct {
+    uint32_t written;               //!< Records stored
+    uint32_t dropped;               //!< Records lost because the ring was full
+} dlog_core_stats_t;
+
+/**
+ * @brief Start the drain task.
+ *
+ * @param priority Drain task priority (keep it below every timed task).
+ * @param core     Core for the drain task, or tskNO_AFFINITY.
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already started, ESP_ERR_NO_MEM
+ *         if the task could not be created.
+ */
+esp_err_t dlog_init(UBaseType_t priority, BaseType_t core);
+
+/**
+ * @brief Store one record (use the DLOGx macros instead of calling this).
+ *
+ * Safe from tasks and ISRs on either core. Never blocks.
+ */
+void dlog_write(char level, const char *tag, const char *fmt, uint8_t nargs, const dlog_arg_t *args);
+
+/**
+ * @brief Read the counters of one core's ring.
+ */
+void dlog_get_stats(BaseType_t core, dlog_core_stats_t *out);
+
+// ------------------------ Argument capture ------------------------
+
+static inline dlog_arg_t dlog_arg_i(int64_t v)     { dlog_arg_t a; a.i = v; return a; }
+static inline dlog_arg_t dlog_arg_f(double v)      { dlog_arg_t a; a.f = v; return a; }
+static inline dlog_arg_t dlog_arg_p(const void *v) { dlog_arg_t a; a.p = v; return a; }
+
+/** @brief Capture one argument with the representation its C type needs. */
+#define DLOG_ARG(x) _Generic((x),                                                       \
+        float: dlog_arg_f, double: dlog_arg_f,                                          \
+        char *: dlog_arg_p, const char *: dlog_arg_p,                                   \
+        void *: dlog_arg_p, const void *: dlog_arg_p,                                   \
+        default: dlog_arg_i)(x)
+
+#define DLOG_CAT_(a, b) a##b
+#define DLOG_CAT(a, b) DLOG_CAT_(a, b)
+#define DLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, n, ...) n
+#define DLOG_NARGS(...) DLOG_NARGS_(_, ##__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+
+#define DLOG_MAP_0()
+#define DLOG_MAP_1(a)                   DLOG_ARG(a),
+#define DLOG_MAP_2(a, b)                DLOG_MAP_1(a) DLOG_ARG(b),
+#define DLOG_MAP_3(a, b, c)             DLOG_MAP_2(a, b) DLOG_ARG(c),
+#define DLOG_MAP_4(a, b, c, d)          DLOG_MAP_3(a, b, c) DLOG_ARG(d),
+#define DLOG_MAP_5(a, b, c, d, e)       DLOG_MAP_4(a, b, c, d) DLOG_ARG(e),
+#define DLOG_MAP_6(a, b, c, d, e, f)    DLOG_MAP_5(a, b, c, d, e) DLOG_ARG(f),
+
+#define DLOG_WRITE(level, tag, fmt, ...)                                                \
+    dlog_write((level), (tag), (fmt), DLOG_NARGS(__VA_ARGS__),                          \
+               (const dlog_arg_t[]){                                                    \
+                   DLOG_CAT(DLOG_MAP_, DLOG_NARGS(__VA_ARGS__))(__VA_ARGS__)            \
+                   { .i = 0 } })
+
+#define DLOGE(tag, fmt, ...) DLOG_WRITE('E', tag, fmt, ##__VA_ARGS__)
+#define DLOGW(tag, fmt, ...) DLOG_WRITE('W', tag, fmt, ##__VA_ARGS__)
+#define DLOGI(tag, fmt, ...) DLOG_WRITE('I', tag, fmt, ##__VA_ARGS__)
+
+#ifdef __cplusplus
+}
+#endif
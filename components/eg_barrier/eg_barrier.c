@@ -0,0 +1,211 @@
+/**
+ * @file eg_barrier.c
+ * @brief Event-group barrier and fan-in (see eg_barrier.h).
+ *
+ * Round bookkeeping needs no generation counter. A participant keeps its
+ * arrival time in a local and records it together with its resume time,
+ * under the lock, before it can arrive at the next round. That round
+ * cannot release until every participant has arrived. So all the records
+ * of round r are written before any of round r+1, and the last one to
+ * record closes the round.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "eg_barrier.h"
+
+// ------------------------ Stats ------------------------
+
+static void acc_add(eg_barrier_acc_t *acc, int64_t us)
+{
+    uint32_t v = us > 0 ? (uint32_t)us : 0;
+    acc->sum += v;
+    if (v > acc->max) {
+        acc->max = v;
+    }
+}
+
+/**
+ * @brief Fold the finished round into the stats. Call with b->lock held.
+ */
+static void close_round(eg_barrier_t *b)
+{
+    int64_t first_arrive = INT64_MAX, last_arrive = INT64_MIN;
+    int64_t first_resume = INT64_MAX, last_resume = INT64_MIN;
+    int64_t core_min[portNUM_PROCESSORS], core_max[portNUM_PROCESSORS];
+    uint32_t core_n[portNUM_PROCESSORS] = { 0 };
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        core_min[c] = INT64_MAX;
+        core_max[c] = INT64_MIN;
+    }
+    // The last to arrive releases the others and never blocks: its resume is
+    // just the return of its own xEventGroupSync(), so only waiters count
+    uint32_t releaser = 0;
+    for (uint32_t i = 0; i < b->n; i++) {
+        int64_t a = b->arrive_us[i];
+        first_arrive = a < first_arrive ? a : first_arrive;
+        if (a > last_arrive) {
+            last_arrive = a;
+            releaser = i;
+        }
+    }
+    if (b->n == 1) {
+        b->rounds++;                // Nobody waits, nothing to measure
+        return;
+    }
+    for (uint32_t i = 0; i < b->n; i++) {
+        int64_t r = b->resume_us[i];
+        int c = b->core[i];
+        if (i == releaser) {
+            continue;
+        }
+        first_resume = r < first_resume ? r : first_resume;
+        last_resume = r > last_resume ? r : last_resume;
+        core_min[c] = r < core_min[c] ? r : core_min[c];
+        core_max[c] = r > core_max[c] ? r : core_max[c];
+        core_n[c]++;
+    }
+
+    b->rounds++;
+    acc_add(&b->release, first_resume - last_arrive);
+    acc_add(&b->skew_all, last_resume - first_resume);
+    acc_add(&b->spread, last_arrive - first_arrive);
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        if (core_n[c] >= 2) {
+            b->skew_rounds[c]++;
+            acc_add(&b->skew_core[c], core_max[c] - core_min[c]);
+        }
+    }
+}
+
+// ------------------------ Barrier ------------------------
+
+esp_err_t eg_barrier_init(eg_barrier_t *b, const char *name, uint32_t n)
+{
+    if (b == NULL || n == 0 || n > EG_BARRIER_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(b, 0, sizeof(*b));
+    b->name = name ? name : "barrier";
+    b->n = n;
+    b->all = (EventBits_t)((1UL << n) - 1);
+    portMUX_INITIALIZE(&b->lock);
+    b->eg = xEventGroupCreateStatic(&b->eg_buf);
+    return ESP_OK;
+}
+
+esp_err_t eg_barrier_wait(eg_barrier_t *b, uint32_t idx, TickType_t timeout)
+{
+    if (idx >= b->n) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    EventBits_t bit = (EventBits_t)(1UL << idx);
+    int64_t arrive = esp_timer_get_time();
+    EventBits_t bits = xEventGroupSync(b->eg, bit, b->all, timeout);
+    int64_t now = esp_timer_get_time();
+
+    if ((bits & b->all) != b->all) {
+        xEventGroupClearBits(b->eg, bit);
+        portENTER_CRITICAL(&b->lock);
+        b->timeouts++;
+        b->resumed = 0;             // The round's records are incomplete
+        portEXIT_CRITICAL(&b->lock);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    portENTER_CRITICAL(&b->lock);
+    b->arrive_us[idx] = arrive;
+    b->resume_us[idx] = now;
+    b->core[idx] = (int8_t)xPortGetCoreID();
+    if (++b->resumed == b->n) {
+        close_round(b);
+        b->resumed = 0;
+    }
+    portEXIT_CRITICAL(&b->lock);
+    return ESP_OK;
+}
+
+void eg_barrier_get_stats(eg_barrier_t *b, eg_barrier_stats_t *out, bool reset)
+{
+    portENTER_CRITICAL(&b->lock);
+    uint32_t r = b->rounds;
+    *out = (eg_barrier_stats_t) {
+        .rounds = r,
+        .timeouts = b->timeouts,
+        .release_avg_us = r ? (uint32_t)(b->release.sum / r) : 0,
+        .release_max_us = b->release.max,
+        .skew_all_avg_us = r ? (uint32_t)(b->skew_all.sum / r) : 0,
+        .skew_all_max_us = b->skew_all.max,
+        .spread_avg_us = r ? (uint32_t)(b->spread.sum / r) : 0,
+        .spread_max_us = b->spread.max,
+    };
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        uint32_t rc = b->skew_rounds[c];
+        out->skew_avg_us[c] = rc ? (uint32_t)(b->skew_core[c].sum / rc) : 0;
+        out->skew_max_us[c] = b->skew_core[c].max;
+    }
+    if (reset) {
+        b->rounds = 0;
+        b->timeouts = 0;
+        memset(b->skew_rounds, 0, sizeof(b->skew_rounds));
+        memset(&b->release, 0, sizeof(b->release));
+        memset(b->skew_core, 0, sizeof(b->skew_core));
+        memset(&b->skew_all, 0, sizeof(b->skew_all));
+        memset(&b->spread, 0, sizeof(b->spread));
+    }
+    portEXIT_CRITICAL(&b->lock);
+}
+
+void eg_barrier_report(eg_barrier_t *b)
+{
+    eg_barrier_stats_t st;
+    eg_barrier_get_stats(b, &st, true);
+
+    printf("[BAR] %s n=%" PRIu32 " rounds=%" PRIu32 " timeouts=%" PRIu32
+           " | release avg %" PRIu32 " max %" PRIu32 " us | skew",
+           b->name, b->n, st.rounds, st.timeouts, st.release_avg_us, st.release_max_us);
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        printf(" c%d avg %" PRIu32 " max %" PRIu32 ",", c, st.skew_avg_us[c], st.skew_max_us[c]);
+    }
+    printf(" all avg %" PRIu32 " max %" PRIu32 " us | spread avg %" PRIu32 " max %" PRIu32 " us\n",
+           st.skew_all_avg_us, st.skew_all_max_us, st.spread_avg_us, st.spread_max_us);
+}
+
+// ------------------------ Fan-in ------------------------
+
+esp_err_t eg_fanin_init(eg_fanin_t *f, uint32_t n)
+{
+    if (f == NULL || n == 0 || n > EG_BARRIER_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    f->all = (EventBits_t)((1UL << n) - 1);
+    f->eg = xEventGroupCreateStatic(&f->eg_buf);
+    return ESP_OK;
+}
+
+void eg_fanin_signal(eg_fanin_t *f, uint32_t idx)
+{
+    xEventGroupSetBits(f->eg, (EventBits_t)(1UL << idx) & f->all);
+}
+
+void eg_fanin_signal_from_isr(eg_fanin_t *f, uint32_t idx, BaseType_t *hpw)
+{
+    xEventGroupSetBitsFromISR(f->eg, (EventBits_t)(1UL << idx) & f->all, hpw);
+}
+
+esp_err_t eg_fanin_wait(eg_fanin_t *f, TickType_t timeout, uint32_t *missing)
+{
+    EventBits_t bits = xEventGroupWaitBits(f->eg, f->all, pdTRUE, pdTRUE, timeout);
+    if ((bits & f->all) != f->all) {
+        if (missing != NULL) {
+            *missing = (uint32_t)(f->all & ~bits);
+        }
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file eg_barrier.h
+ * @brief Reusable event-group barrier and fan-in for up to 24 tasks on both cores, with release-skew stats.
+ *
+ * Phase-synchronised stages ("all sensors sample, then all filter") need
+ * each task to wait until every participant has finished the current
+ * phase. Polling a shared flag with vTaskDelay(1) wakes every task on every
+ * tick and releases the group up to a tick late. Spinning on the flag
+ * instead burns the core.
+ *
+ * eg_barrier_t gives each participant one bit of an event group (24 bits
+ * on ESP-IDF, configUSE_16_BIT_TICKS = 0). eg_barrier_wait() is one
+ * xEventGroupSync() call: it sets the caller's bit and blocks until all
+ * bits are set. The last arrival's call releases every waiter in the same
+ * pass and clears the bits, so the barrier can be reused at once. A fast
+ * task entering the next round cannot be mistaken for this one.
+ *
+ * Each round records the arrival and resume time and the core of every
+ * participant. The last participant to resume folds the round into the
+ * stats. The last to arrive releases the round without blocking, so it is
+ * left out of the resume times, which are those of the waiters:
+ *   release : first waiter resume - last arrival (wakeup cost of the barrier)
+ *   skew    : last resume - first resume of the waiters, per core and
+ *             overall; includes whatever the tasks released first run
+ *             before the others on the same core get the CPU
+ *   spread  : last arrival - first arrival (load imbalance, not barrier cost)
+ * eg_barrier_report() prints, for example:
+ *   [BAR] phase n=24 rounds=500 timeouts=0 | release avg 9 max 31 us | skew c0 avg 38 max 95, c1 avg 41 max 102, all avg 57 max 118 us | spread avg 212 max 410 us
+ *   (illustrative)
+ *
+ * eg_fanin_t is the one-way case: producers call eg_fanin_signal() once
+ * per round without blocking. One consumer waits in eg_fanin_wait() for
+ * every bit, and the bits are cleared as it is released.
+ *
+ * After a timeout the round is broken for everyone. The other participants
+ * may already have been released, so treat ESP_ERR_TIMEOUT as an error and
+ * resynchronise the group.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EG_BARRIER_MAX  24          //!< Usable event-group bits
+
+/** @brief Sum and maximum of one duration, in µs. */
+typedef struct {
+    uint64_t sum;
+    uint32_t max;
+} eg_barrier_acc_t;
+
+/**
+ * @brief Barrier object; all fields are private.
+ */
+typedef struct {
+    const char *name;
+    StaticEventGroup_t eg_buf;
+    EventGroupHandle_t eg;
+    EventBits_t all;
+    uint32_t n;
+    int64_t arrive_us[EG_BARRIER_MAX];
+    int64_t resume_us[EG_BARRIER_MAX];
+    int8_t core[EG_BARRIER_MAX];
+    uint32_t resumed;               //!< Participants that recorded the current round
+    uint32_t rounds;
+    uint32_t timeouts;
+    uint32_t skew_rounds[portNUM_PROCESSORS];   //!< Rounds with >= 2 participants on the core
+    eg_barrier_acc_t release;
+    eg_barrier_acc_t skew_core[portNUM_PROCESSORS];
+    eg_barrier_acc_t skew_all;
+    eg_barrier_acc_t spread;
+    portMUX_TYPE lock;
+} eg_barrier_t;
+
+/** @brief Averages and maxima since the last reset, in µs. */
+typedef struct {
+    uint32_t rounds;
+    uint32_t timeouts;
+    uint32_t release_avg_us, release_max_us;
+    uint32_t skew_avg_us[portNUM_PROCESSORS], skew_max_us[portNUM_PROCESSORS];
+    uint32_t skew_all_avg_us, skew_all_max_us;
+    uint32_t spread_avg_us, spread_max_us;
+} eg_barrier_stats_t;
+
+/**
+ * @brief Fan-in object; all fields are private.
+ */
+typedef struct {
+    StaticEventGroup_t eg_buf;
+    EventGroupHandle_t eg;
+    EventBits_t all;
+} eg_fanin_t;
+
+/**
+ * @brief Create a barrier for participants 0..n-1.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG (n is 0 or above EG_BARRIER_MAX).
+ */
+esp_err_t eg_barrier_init(eg_barrier_t *b, const char *name, uint32_t n);
+
+/**
+ * @brief Arrive as participant idx and block until all n have arrived.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG (bad idx), ESP_ERR_TIMEOUT.
+ */
+esp_err_t eg_barrier_wait(eg_barrier_t *b, uint32_t idx, TickType_t timeout);
+
+/**
+ * @brief Copy the stats; optionally reset them.
+ */
+void eg_barrier_get_stats(eg_barrier_t *b, eg_barrier_stats_t *out, bool reset);
+
+/**
+ * @brief Print the stats as one [BAR] line and reset them.
+ */
+void eg_barrier_report(eg_barrier_t *b);
+
+/**
+ * @brief Create a fan-in for producers 0..n-1.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG (n is 0 or above EG_BARRIER_MAX).
+ */
+esp_err_t eg_fanin_init(eg_fanin_t *f, uint32_t n);
+
+/**
+ * @brief Mark producer idx done for this round; never blocks.
+ */
+void eg_fanin_signal(eg_fanin_t *f, uint32_t idx);
+
+/**
+ * @brief ISR variant of eg_fanin_signal().
+ *
+ * xEventGroupSetBitsFromISR() defers the set to the timer service task, so
+ * the consumer wakes only after that task has run.
+ */
+void eg_fanin_signal_from_isr(eg_fanin_t *f, uint32_t idx, BaseType_t *hpw);
+
+/**
+ * @brief Block until every producer has signalled, then clear the round.
+ *
+ * @param missing Optional: bits of the producers still missing on timeout.
+ * @return ESP_OK, ESP_ERR_TIMEOUT.
+ */
+esp_err_t eg_fanin_wait(eg_fanin_t *f, TickType_t timeout, uint32_t *missing);
+
+#ifdef __cplusplus
+}
+#endif
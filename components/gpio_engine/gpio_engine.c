@@ -0,0 +1,216 @@
+/**
+ * @file gpio_engine.c
+ * @brief Shadow-state GPIO output engine (see gpio_engine.h).
+ *
+ * The shadow word, the channel table and the register stores are all
+ * updated inside one spinlock section. The shadow therefore always matches
+ * what was written to the pins, even when gpio_engine_write() runs on the
+ * other core at the same time as the scheduler.
+ */
+
+#include "soc/soc.h"
+#include "soc/gpio_reg.h"
+#include "gpio_engine.h"
+
+typedef struct {
+    uint64_t bit;
+    TickType_t half_period;         //!< 0 = not toggling
+    TickType_t next;                //!< Tick of the next edge
+} channel_t;
+
+static channel_t s_ch[GPIO_ENGINE_MAX_CHANNELS];
+static int s_nch;
+static uint64_t s_owned;            //!< Pins added to the engine
+static uint64_t s_shadow;
+static gpio_engine_stats_t s_stats;
+static TaskHandle_t s_task;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ------------------------ Register access ------------------------
+
+/**
+ * @brief Apply set/clear masks with one W1TS and one W1TC store per bank.
+ *
+ * Called with s_lock held.
+ */
+static inline void write_masks(uint64_t set_mask, uint64_t clr_mask)
+{
+    if ((uint32_t)set_mask) {
+        REG_WRITE(GPIO_OUT_W1TS_REG, (uint32_t)set_mask);
+        s_stats.stores++;
+    }
+    if ((uint32_t)clr_mask) {
+        REG_WRITE(GPIO_OUT_W1TC_REG, (uint32_t)clr_mask);
+        s_stats.stores++;
+    }
+#ifdef GPIO_OUT1_W1TS_REG
+    // GPIO32 and up live in the second bank (not present on every chip)
+    if ((uint32_t)(set_mask >> 32)) {
+        REG_WRITE(GPIO_OUT1_W1TS_REG, (uint32_t)(set_mask >> 32));
+        s_stats.stores++;
+    }
+    if ((uint32_t)(clr_mask >> 32)) {
+        REG_WRITE(GPIO_OUT1_W1TC_REG, (uint32_t)(clr_mask >> 32));
+        s_stats.stores++;
+    }
+#endif
+}
+
+// ------------------------ Scheduler ------------------------
+
+/**
+ * @brief Produce every due edge in one batch, then sleep until the next one.
+ *
+ * @param arg Unused.
+ */
+static void gpio_engine_task(void *arg)
+{
+    while (1) {
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = portMAX_DELAY;
+        uint64_t set_mask = 0;
+        uint64_t clr_mask = 0;
+
+        portENTER_CRITICAL(&s_lock);
+        for (int i = 0; i < s_nch; i++) {
+            channel_t *ch = &s_ch[i];
+            if (ch->half_period == 0) {
+                continue;
+            }
+            if ((int32_t)(now - ch->next) >= 0) {
+                if (s_shadow & ch->bit) {
+                    clr_mask |= ch->bit;
+                } else {
+                    set_mask |= ch->bit;
+                }
+                s_shadow ^= ch->bit;
+                s_stats.toggles++;
+                ch->next += ch->half_period;
+                if ((int32_t)(now - ch->next) >= 0) {
+                    s_stats.late++;         // Missed a whole edge: resync instead of bursting
+                    ch->next = now + ch->half_period;
+                }
+            }
+            TickType_t left = ch->next - now;
+            if (left < wait) {
+                wait = left;
+            }
+        }
+        write_masks(set_mask, clr_mask);
+        s_stats.wakes++;
+        portEXIT_CRITICAL(&s_lock);
+
+        // Channel changes notify the task so a new, earlier edge is not missed
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t gpio_engine_init(UBaseType_t priority, BaseType_t core)
+{
+    if (s_task != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xTaskCreatePinnedToCore(gpio_engine_task, "gpio_engine", GPIO_ENGINE_STACK_SIZE, NULL,
+                                priority, &s_task, core) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_engine_add_channel(gpio_num_t pin, uint32_t half_period_ms, uint32_t phase_ms, int *out_ch)
+{
+    if (!GPIO_IS_VALID_OUTPUT_GPIO(pin)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    uint64_t bit = 1ULL << pin;
+
+    gpio_config_t io = {
+        .pin_bit_mask = bit,
+        .mode = GPIO_MODE_OUTPUT,
+        .pull_up_en = GPIO_PULLUP_DISABLE,
+        .pull_down_en = GPIO_PULLDOWN_DISABLE,
+        .intr_type = GPIO_INTR_DISABLE
+    };
+    esp_err_t err = gpio_config(&io);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_owned & bit) {
+        portEXIT_CRITICAL(&s_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (s_nch == GPIO_ENGINE_MAX_CHANNELS) {
+        portEXIT_CRITICAL(&s_lock);
+        return ESP_ERR_NO_MEM;
+    }
+    int id = s_nch++;
+    s_ch[id].bit = bit;
+    s_ch[id].half_period = half_period_ms ? pdMS_TO_TICKS(half_period_ms) : 0;
+    if (half_period_ms && s_ch[id].half_period == 0) {
+        s_ch[id].half_period = 1;   // Shorter than a tick: toggle every tick
+    }
+    s_ch[id].next = xTaskGetTickCount() + pdMS_TO_TICKS(phase_ms);
+    s_owned |= bit;
+    s_shadow &= ~bit;
+    write_masks(0, bit);
+    portEXIT_CRITICAL(&s_lock);
+
+    if (s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+    if (out_ch != NULL) {
+        *out_ch = id;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_engine_set_period(int ch, uint32_t half_period_ms)
+{
+    if (ch < 0 || ch >= s_nch) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    TickType_t half = pdMS_TO_TICKS(half_period_ms);
+    if (half_period_ms && half == 0) {
+        half = 1;
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    s_ch[ch].half_period = half;
+    s_ch[ch].next = xTaskGetTickCount() + half;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+    return ESP_OK;
+}
+
+void gpio_engine_write(uint64_t set_mask, uint64_t clr_mask)
+{
+    portENTER_CRITICAL(&s_lock);
+    set_mask &= s_owned;
+    clr_mask &= s_owned & ~set_mask;
+    s_shadow = (s_shadow | set_mask) & ~clr_mask;
+    write_masks(set_mask, clr_mask);
+    portEXIT_CRITICAL(&s_lock);
+}
+
+uint64_t gpio_engine_get_shadow(void)
+{
+    portENTER_CRITICAL(&s_lock);
+    uint64_t v = s_shadow;
+    portEXIT_CRITICAL(&s_lock);
+    return v;
+}
+
+void gpio_engine_get_stats(gpio_engine_stats_t *out)
+{
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+    out->stack_free = s_task ? (uint32_t)uxTaskGetStackHighWaterMark(s_task) : 0;
+}
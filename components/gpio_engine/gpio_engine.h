@@ -0,0 +1,96 @@
+/**
+ * @file gpio_engine.h
+ * @brief Shadow-state GPIO output engine: many blink channels, one task, batched W1TS/W1TC stores.
+ *
+ * Toggling with gpio_get_level()/gpio_set_level() costs two driver calls
+ * per edge, and one task per LED costs one stack per LED. gpio_engine
+ * keeps the output levels in a shadow word and drives every channel from
+ * a single scheduler task:
+ *   - each channel toggles with its own half period and phase (in ticks)
+ *   - all edges due at the same tick are merged into one set mask and one
+ *     clear mask, written with one GPIO_OUT_W1TS store and one
+ *     GPIO_OUT_W1TC store per 32-pin bank
+ *   - W1TS/W1TC only touch the bits that are set in the mask, so pins not
+ *     owned by the engine are never read-modified-written
+ *
+ * The scheduler sleeps until the earliest due channel and is woken by a
+ * notification when channels change. Periods are rounded to ticks, so with
+ * CONFIG_FREERTOS_HZ=100 the resolution is 10 ms.
+ *
+ * gpio_engine_write() sets and clears any number of engine pins in one call,
+ * for status patterns that are not periodic.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef GPIO_ENGINE_MAX_CHANNELS
+#define GPIO_ENGINE_MAX_CHANNELS 32
+#endif
+
+#ifndef GPIO_ENGINE_STACK_SIZE
+#define GPIO_ENGINE_STACK_SIZE 2048 //!< Bytes; the scheduler does not log
+#endif
+
+/** @brief Engine counters since gpio_engine_init(). */
+typedef struct {
+    uint32_t toggles;               //!< Channel edges produced
+    uint32_t wakes;                 //!< Scheduler iterations
+    uint32_t stores;                //!< W1TS/W1TC register writes issued
+    uint32_t late;                  //!< Edges produced a full half period late or more
+    uint32_t stack_free;            //!< Scheduler stack high-water mark, bytes
+} gpio_engine_stats_t;
+
+/**
+ * @brief Start the scheduler task.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already started, ESP_ERR_NO_MEM.
+ */
+esp_err_t gpio_engine_init(UBaseType_t priority, BaseType_t core);
+
+/**
+ * @brief Configure @p pin as an output driven low and add a blink channel for it.
+ *
+ * @param pin            Output-capable GPIO.
+ * @param half_period_ms Time between edges; 0 adds the pin held low (use gpio_engine_write()).
+ * @param phase_ms       Delay of the first edge, to spread channels over time.
+ * @param out_ch         Channel id for gpio_engine_set_period() (may be NULL).
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_INVALID_STATE (pin already used),
+ *         ESP_ERR_NO_MEM (all channels used).
+ */
+esp_err_t gpio_engine_add_channel(gpio_num_t pin, uint32_t half_period_ms, uint32_t phase_ms, int *out_ch);
+
+/**
+ * @brief Change the half period of a channel; 0 stops it at its current level.
+ */
+esp_err_t gpio_engine_set_period(int ch, uint32_t half_period_ms);
+
+/**
+ * @brief Drive engine pins high (@p set_mask) and low (@p clr_mask) in one batch.
+ *
+ * Bit n is GPIO n. Bits of pins not added to the engine are ignored.
+ */
+void gpio_engine_write(uint64_t set_mask, uint64_t clr_mask);
+
+/**
+ * @brief Output levels as last written by the engine (bit n = GPIO n).
+ */
+uint64_t gpio_engine_get_shadow(void);
+
+/**
+ * @brief Copy the engine counters.
+ */
+void gpio_engine_get_stats(gpio_engine_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file guarded_resource.c
+ * @brief Timed binary semaphore / mutex / spinlock guard (see guarded_resource.h).
+ *
+ * The hold statistics are written by the owner while it still owns the
+ * resource. A small spinlock (s_stats_mux) only keeps them consistent for
+ * readers. It is never held across a blocking call.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "guarded_resource.h"
+
+#define SPINLOCK_MAX_HOLD_US    20  // Longer critical sections hurt interrupt latency
+#define MUTEX_SHORT_HOLD_US     10  // Below this a critical section is cheaper
+
+static portMUX_TYPE s_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static const char *kind_name(guarded_resource_kind_t kind)
+{
+    switch (kind) {
+    case GUARDED_BINARY_SEM:
+        return "binsem";
+    case GUARDED_MUTEX:
+        return "mutex";
+    default:
+        return "spinlock";
+    }
+}
+
+esp_err_t guarded_resource_init(guarded_resource_t *r, const char *name,
+                                guarded_resource_kind_t kind, uint32_t warn_hold_us)
+{
+    if (r == NULL || kind > GUARDED_SPINLOCK) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(r, 0, sizeof(*r));
+    r->name = name ? name : "res";
+    r->kind = kind;
+    r->warn_hold_us = warn_hold_us;
+    portMUX_INITIALIZE(&r->mux);
+
+    if (kind == GUARDED_BINARY_SEM) {
+        r->sem = xSemaphoreCreateBinaryStatic(&r->sem_buf);
+        xSemaphoreGive(r->sem);     // Binary semaphores start empty
+    } else if (kind == GUARDED_MUTEX) {
+        r->sem = xSemaphoreCreateMutexStatic(&r->sem_buf);
+    }
+    return ESP_OK;
+}
+
+void guarded_resource_deinit(guarded_resource_t *r)
+{
+    if (r->sem != NULL) {
+        vSemaphoreDelete(r->sem);
+        r->sem = NULL;
+    }
+}
+
+bool guarded_resource_lock(guarded_resource_t *r, TickType_t wait)
+{
+    int64_t t0 = esp_timer_get_time();
+    bool contended = false;
+
+    if (r->kind == GUARDED_SPINLOCK) {
+        portENTER_CRITICAL(&r->mux);
+    } else if (xSemaphoreTake(r->sem, 0) != pdTRUE) {
+        contended = true;
+        if (xSemaphoreTake(r->sem, wait) != pdTRUE) {
+            portENTER_CRITICAL(&s_stats_mux);
+            r->st.timeouts++;
+            portEXIT_CRITICAL(&s_stats_mux);
+            return false;
+        }
+    }
+
+    int64_t t1 = esp_timer_get_time();
+    uint32_t waited = (uint32_t)(t1 - t0);
+    r->t_locked = t1;
+
+    portENTER_CRITICAL_SAFE(&s_stats_mux);
+    r->st.count++;
+    // A spinlock cannot report a failed first try; a measurable wait means it spun
+    if (contended || (r->kind == GUARDED_SPINLOCK && waited > 1)) {
+        r->st.contended++;
+    }
+    r->wait_sum += waited;
+    if (waited > r->st.wait_max_us) {
+        r->st.wait_max_us = waited;
+    }
+    portEXIT_CRITICAL_SAFE(&s_stats_mux);
+    return true;
+}
+
+void guarded_resource_unlock(guarded_resource_t *r)
+{
+    uint32_t held = (uint32_t)(esp_timer_get_time() - r->t_locked);
+
+    portENTER_CRITICAL_SAFE(&s_stats_mux);
+    r->hold_sum += held;
+    if (held > r->st.hold_max_us) {
+        r->st.hold_max_us = held;
+    }
+    if (r->warn_hold_us && held > r->warn_hold_us) {
+        r->st.long_holds++;
+        const char *who = pcTaskGetName(NULL);
+        size_t i = 0;
+        for (; who[i] != '\0' && i < sizeof(r->st.long_holder) - 1; i++) {
+            r->st.long_holder[i] = who[i];
+        }
+        r->st.long_holder[i] = '\0';
+    }
+    portEXIT_CRITICAL_SAFE(&s_stats_mux);
+
+    if (r->kind == GUARDED_SPINLOCK) {
+        portEXIT_CRITICAL(&r->mux);
+    } else {
+        xSemaphoreGive(r->sem);
+    }
+}
+
+void guarded_resource_get_stats(guarded_resource_t *r, guarded_resource_stats_t *out, bool reset)
+{
+    portENTER_CRITICAL(&s_stats_mux);
+    *out = r->st;
+    out->wait_avg_us = r->st.count ? (uint32_t)(r->wait_sum / r->st.count) : 0;
+    out->hold_avg_us = r->st.count ? (uint32_t)(r->hold_sum / r->st.count) : 0;
+    if (reset) {
+        memset(&r->st, 0, sizeof(r->st));
+        r->wait_sum = 0;
+        r->hold_sum = 0;
+    }
+    portEXIT_CRITICAL(&s_stats_mux);
+}
+
+const char *guarded_resource_advice(guarded_resource_kind_t kind, const guarded_resource_stats_t *st)
+{
+    if (st->count == 0) {
+        return "no locks recorded in this window: nothing to advise";
+    }
+    if (kind == GUARDED_SPINLOCK && st->hold_max_us > SPINLOCK_MAX_HOLD_US) {
+        return "spinlock held too long: interrupts on that core are masked meanwhile, use a mutex";
+    }
+    if (kind == GUARDED_BINARY_SEM && st->contended > 0) {
+        return "binary semaphore used as a lock: no priority inheritance, use a mutex";
+    }
+    if (kind == GUARDED_MUTEX && st->hold_max_us <= MUTEX_SHORT_HOLD_US) {
+        return "holds are very short: a spinlock is cheaper if the section never blocks";
+    }
+    if (st->contended == 0) {
+        return "no contention seen: keep it, or prefer a mutex if higher-priority users appear";
+    }
+    return "primitive fits the measured wait and hold times";
+}
+
+void guarded_resource_report(guarded_resource_t *r)
+{
+    guarded_resource_stats_t st;
+    guarded_resource_get_stats(r, &st, true);
+
+    printf("[GUARD] %s(%s) n=%" PRIu32 " contended=%" PRIu32 " timeouts=%" PRIu32
+           " | wait avg %" PRIu32 " max %" PRIu32 " us | hold avg %" PRIu32 " max %" PRIu32 " us | long=%" PRIu32,
+           r->name, kind_name(r->kind), st.count, st.contended, st.timeouts,
+           st.wait_avg_us, st.wait_max_us, st.hold_avg_us, st.hold_max_us, st.long_holds);
+    if (st.long_holds) {
+        printf(" (last: %s)", st.long_holder);
+    }
+    printf("\n[GUARD] %s: %s\n", r->name, guarded_resource_advice(r->kind, &st));
+}
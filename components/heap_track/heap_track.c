@@ -0,0 +1,203 @@
+/**
+ * @file heap_track.c
+ * @brief Heap shape per capability region and per-task totals (see heap_track.h).
+ *
+ * The failed-allocation hook runs in whichever context made the failing
+ * call, possibly with the heap lock held. It therefore only copies a few
+ * values under a spinlock. Everything else runs in the caller of
+ * heap_track_report().
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include "sdkconfig.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "heap_track.h"
+
+#if CONFIG_HEAP_TASK_TRACKING
+#include "esp_heap_task_info.h"
+#endif
+
+static const struct {
+    const char *name;
+    uint32_t caps;
+} k_regions[HEAP_TRACK_REGIONS] = {
+    [HEAP_TRACK_INTERNAL] = { "internal", MALLOC_CAP_INTERNAL },
+    [HEAP_TRACK_DMA]      = { "dma",      MALLOC_CAP_DMA },
+    [HEAP_TRACK_PSRAM]    = { "psram",    MALLOC_CAP_SPIRAM },
+};
+
+static heap_track_snapshot_t s_base;
+static uint32_t s_fails;
+static size_t s_fail_size;
+static uint32_t s_fail_caps;
+static char s_fail_task[configMAX_TASK_NAME_LEN];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ------------------------ Failed allocations ------------------------
+
+static void on_alloc_failed(size_t size, uint32_t caps, const char *function_name)
+{
+    const char *who = xPortInIsrContext() ? "(isr)" : pcTaskGetName(NULL);
+
+    portENTER_CRITICAL_SAFE(&s_lock);
+    s_fails++;
+    s_fail_size = size;
+    s_fail_caps = caps;
+    size_t i = 0;
+    for (; who[i] != '\0' && i < sizeof(s_fail_task) - 1; i++) {
+        s_fail_task[i] = who[i];
+    }
+    s_fail_task[i] = '\0';
+    portEXIT_CRITICAL_SAFE(&s_lock);
+}
+
+// ------------------------ Per-task totals ------------------------
+
+#if CONFIG_HEAP_TASK_TRACKING
+static heap_task_totals_t s_totals[HEAP_TRACK_MAX_TASKS];
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+static TaskStatus_t s_status[HEAP_TRACK_MAX_TASKS];
+#endif
+
+/**
+ * @brief Name of a live task, or NULL if the handle belongs to no current task.
+ */
+static const char *live_task_name(TaskHandle_t task, UBaseType_t ntasks)
+{
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    for (UBaseType_t i = 0; i < ntasks; i++) {
+        if (s_status[i].xHandle == task) {
+            return s_status[i].pcTaskName;
+        }
+    }
+    return NULL;
+#else
+    (void)ntasks;
+    return "?";                     // Cannot tell live from deleted without the task list
+#endif
+}
+
+static void report_tasks(void)
+{
+    heap_task_info_params_t params = { 0 };
+    size_t ntotals = 0;
+
+    for (int r = 0; r < HEAP_TRACK_REGIONS; r++) {
+        params.caps[r] = (int32_t)k_regions[r].caps;
+        params.mask[r] = (int32_t)k_regions[r].caps;
+    }
+    params.totals = s_totals;
+    params.num_totals = &ntotals;
+    params.max_totals = HEAP_TRACK_MAX_TASKS;
+    heap_caps_get_per_task_info(&params);
+
+    UBaseType_t ntasks = 0;
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    ntasks = uxTaskGetSystemState(s_status, HEAP_TRACK_MAX_TASKS, NULL);
+#endif
+
+    printf("[HEAP] %-16s", "task");
+    for (int r = 0; r < HEAP_TRACK_REGIONS; r++) {
+        printf(" %10s/blocks", k_regions[r].name);
+    }
+    printf("\n");
+
+    size_t gone_size[HEAP_TRACK_REGIONS] = { 0 }, gone_count[HEAP_TRACK_REGIONS] = { 0 };
+    bool any_gone = false;
+    for (size_t i = 0; i < ntotals; i++) {
+        const heap_task_totals_t *t = &s_totals[i];
+        const char *name = t->task ? live_task_name(t->task, ntasks) : "(startup)";
+        if (name == NULL) {
+            any_gone = true;
+            for (int r = 0; r < HEAP_TRACK_REGIONS; r++) {
+                gone_size[r] += t->size[r];
+                gone_count[r] += t->count[r];
+            }
+            continue;
+        }
+        printf("[HEAP] %-16s", name);
+        for (int r = 0; r < HEAP_TRACK_REGIONS; r++) {
+            printf(" %10u/%-6u", (unsigned)t->size[r], (unsigned)t->count[r]);
+        }
+        printf("\n");
+    }
+    if (any_gone) {
+        printf("[HEAP] %-16s", "(deleted)");
+        for (int r = 0; r < HEAP_TRACK_REGIONS; r++) {
+            printf(" %10u/%-6u", (unsigned)gone_size[r], (unsigned)gone_count[r]);
+        }
+        printf("\n");
+    }
+    if (ntotals == HEAP_TRACK_MAX_TASKS) {
+        printf("[HEAP] (table full: raise HEAP_TRACK_MAX_TASKS)\n");
+    }
+}
+#endif
+
+// ------------------------ API ------------------------
+
+esp_err_t heap_track_init(void)
+{
+    heap_track_snapshot(&s_base);
+    return heap_caps_register_failed_alloc_callback(on_alloc_failed);
+}
+
+void heap_track_snapshot(heap_track_snapshot_t *out)
+{
+    for (int r = 0; r < HEAP_TRACK_REGIONS; r++) {
+        heap_track_region_t *reg = &out->region[r];
+        uint32_t caps = k_regions[r].caps;
+
+        reg->total = heap_caps_get_total_size(caps);
+        reg->free = heap_caps_get_free_size(caps);
+        reg->largest = heap_caps_get_largest_free_block(caps);
+        reg->min_free = heap_caps_get_minimum_free_size(caps);
+        reg->frag_pct = reg->free ? (uint32_t)(100 - reg->largest * 100 / reg->free) : 0;
+    }
+    portENTER_CRITICAL(&s_lock);
+    out->alloc_fails = s_fails;
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void heap_track_report(void)
+{
+    heap_track_snapshot_t now;
+    heap_track_snapshot(&now);
+
+    for (int r = 0; r < HEAP_TRACK_REGIONS; r++) {
+        const heap_track_region_t *c = &now.region[r], *b = &s_base.region[r];
+        if (c->total == 0) {
+            printf("[HEAP] %-8s n/a\n", k_regions[r].name);
+            continue;
+        }
+        printf("[HEAP] %-8s free %u (base %u) largest %u (base %u) min %u frag %" PRIu32 "%% (base %" PRIu32 "%%)\n",
+               k_regions[r].name, (unsigned)c->free, (unsigned)b->free, (unsigned)c->largest,
+               (unsigned)b->largest, (unsigned)c->min_free, c->frag_pct, b->frag_pct);
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    uint32_t fails = s_fails;
+    size_t size = s_fail_size;
+    uint32_t caps = s_fail_caps;
+    char task[configMAX_TASK_NAME_LEN];
+    for (size_t i = 0; i < sizeof(task); i++) {
+        task[i] = s_fail_task[i];
+    }
+    portEXIT_CRITICAL(&s_lock);
+    if (fails) {
+        printf("[HEAP] alloc failures %" PRIu32 ", last: %u B caps 0x%08" PRIx32 " by %s\n",
+               fails, (unsigned)size, caps, task);
+    } else {
+        printf("[HEAP] alloc failures 0\n");
+    }
+
+#if CONFIG_HEAP_TASK_TRACKING
+    report_tasks();
+#else
+    printf("[HEAP] per-task totals n/a (needs CONFIG_HEAP_TASK_TRACKING)\n");
+#endif
+}
@@ -0,0 +1,93 @@
+/**
+ * @file heap_track.h
+ * @brief Per-region heap shape (free, largest block, minimum ever) and per-task allocation totals.
+ *
+ * Slow fragmentation does not show up as less free heap. The free total
+ * stays flat while the largest free block shrinks, until an xTaskCreate()
+ * or xQueueCreate() that needs one contiguous stack or storage area fails
+ * after days of uptime. heap_track watches the values that predict this,
+ * separately for each capability region:
+ *   internal : MALLOC_CAP_INTERNAL, where TCBs, stacks and queues live
+ *   dma      : MALLOC_CAP_DMA, the DMA-capable part of internal RAM
+ *   psram    : MALLOC_CAP_SPIRAM, when external RAM is enabled
+ * For each it reports free, largest free block, minimum ever free and
+ * frag% = 100 - largest * 100 / free, against the baseline taken by
+ * heap_track_init(). It also registers a failed-allocation hook that counts
+ * failures and remembers the last one (size, caps, task).
+ *
+ * With CONFIG_HEAP_TASK_TRACKING=y it also lists the bytes and blocks each
+ * task currently holds in each region (heap_caps_get_per_task_info()).
+ * Blocks still owned by tasks that no longer exist are summed in one
+ * "(deleted)" row. They are leaks, unless ownership was handed on, as with
+ * a queue created in app_main. A new task can reuse the TCB address of a
+ * deleted one and then inherits its totals, so treat that row as a lower
+ * bound. Task names need CONFIG_FREERTOS_USE_TRACE_FACILITY.
+ *
+ * heap_track_report() prints, for example:
+ *   [HEAP] internal free 182340 (base 231200) largest 61440 (base 113792) min 170112 frag 66% (base 51%)
+ *   [HEAP] dma      free 180100 (base 228900) largest 61440 (base 113792) min 168020 frag 65% (base 50%)
+ *   [HEAP] psram    n/a
+ *   [HEAP] alloc failures 3, last: 3924 B caps 0x00001800 by main
+ *   [HEAP] task             internal/blocks       dma/blocks     psram/blocks
+ *   [HEAP] main                 3212/14           3212/14              0/0
+ *   [HEAP] keeper                 0/0               0/0              0/0
+ *   [HEAP] (deleted)           18432/24          18432/24             0/0
+ *   (illustrative)
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef HEAP_TRACK_MAX_TASKS
+#define HEAP_TRACK_MAX_TASKS 32
+#endif
+
+/** @brief Capability regions, in report order. */
+typedef enum {
+    HEAP_TRACK_INTERNAL,
+    HEAP_TRACK_DMA,
+    HEAP_TRACK_PSRAM,
+    HEAP_TRACK_REGIONS,
+} heap_track_region_id_t;
+
+/** @brief Shape of one region. */
+typedef struct {
+    size_t total;                   //!< 0 = region not present
+    size_t free;
+    size_t largest;                 //!< Largest free block
+    size_t min_free;                //!< Lowest free since boot
+    uint32_t frag_pct;              //!< 100 - largest * 100 / free
+} heap_track_region_t;
+
+/** @brief All regions plus the failed-allocation count. */
+typedef struct {
+    heap_track_region_t region[HEAP_TRACK_REGIONS];
+    uint32_t alloc_fails;
+} heap_track_snapshot_t;
+
+/**
+ * @brief Take the baseline and register the failed-allocation hook.
+ *
+ * @return ESP_OK, or the error from heap_caps_register_failed_alloc_callback().
+ */
+esp_err_t heap_track_init(void);
+
+/**
+ * @brief Read the current shape of every region.
+ */
+void heap_track_snapshot(heap_track_snapshot_t *out);
+
+/**
+ * @brief Print the regions against the baseline, the last failure and (with task tracking) the per-task table.
+ */
+void heap_track_report(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,141 @@
+/**
+ * @file hires_periodic.c
+ * @brief esp_timer-driven periodic jobs with a task handoff (see hires_periodic.h).
+ */
+
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#include "hires_periodic.h"
+
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+#define HIRES_DISPATCH ESP_TIMER_ISR
+#else
+#define HIRES_DISPATCH ESP_TIMER_TASK
+#endif
+
+// ------------------------ Timer side ------------------------
+
+/**
+ * @brief esp_timer callback: timestamp the fire and wake the worker.
+ *
+ * Runs in the timer ISR with ISR dispatch, otherwise in the esp_timer task.
+ */
+static void IRAM_ATTR hires_timer_cb(void *arg)
+{
+    hires_periodic_t *job = (hires_periodic_t *)arg;
+
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL_SAFE(&job->lock);  // 64-bit store: the worker may read it on the other core
+    job->fire_us = now;
+    portEXIT_CRITICAL_SAFE(&job->lock);
+#if CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD
+    BaseType_t hp_task_woken = pdFALSE;
+    vTaskNotifyGiveFromISR(job->worker, &hp_task_woken);
+    if (hp_task_woken == pdTRUE) {
+        esp_timer_isr_dispatch_need_yield();
+    }
+#else
+    xTaskNotifyGive(job->worker);
+#endif
+}
+
+// ------------------------ Worker side ------------------------
+
+/**
+ * @brief Worker task: one callback run per notification.
+ *
+ * @param arg The hires_periodic_t.
+ */
+static void hires_worker_task(void *arg)
+{
+    hires_periodic_t *job = (hires_periodic_t *)arg;
+
+    while (1) {
+        uint32_t pending = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        int64_t now = esp_timer_get_time();
+
+        period_stats_mark_at(&job->stats, now);
+
+        portENTER_CRITICAL(&job->lock);
+        int64_t lat = now - job->fire_us;
+        uint32_t lat_us = lat < 0 ? 0 : (uint32_t)lat;
+        job->activations++;
+        if (pending > 1) {
+            job->overruns += pending - 1;
+        }
+        job->latency_sum_us += lat_us;
+        if (lat_us > job->latency_max_us) {
+            job->latency_max_us = lat_us;
+        }
+        portEXIT_CRITICAL(&job->lock);
+
+        job->cfg.callback(job->cfg.arg);
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t hires_periodic_create(hires_periodic_t *job, const hires_periodic_config_t *cfg)
+{
+    if (job == NULL || cfg == NULL || cfg->callback == NULL ||
+        cfg->period_us < HIRES_PERIODIC_MIN_PERIOD_US || cfg->stack_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(job, 0, sizeof(*job));
+    job->cfg = *cfg;
+    portMUX_INITIALIZE(&job->lock);
+
+    if (xTaskCreatePinnedToCore(hires_worker_task, cfg->name, cfg->stack_size, job,
+                                cfg->priority, &job->worker, cfg->core) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    const esp_timer_create_args_t args = {
+        .callback = hires_timer_cb,
+        .arg = job,
+        .dispatch_method = HIRES_DISPATCH,
+        .name = cfg->name,
+        .skip_unhandled_events = true,      // Never burst-fire to catch up
+    };
+    esp_err_t err = esp_timer_create(&args, &job->timer);
+    if (err != ESP_OK) {
+        vTaskDelete(job->worker);
+        job->worker = NULL;
+        return err;
+    }
+
+    // Registered last, so a failed create leaves nothing in the report list.
+    // The worker does not touch the stats before the timer is started.
+    // 1 us buckets around the nominal period; 25% lateness counts as a miss
+    period_stats_init(&job->stats, cfg->name, cfg->period_us, 1, (int32_t)(cfg->period_us / 4));
+    return ESP_OK;
+}
+
+esp_err_t hires_periodic_start(hires_periodic_t *job)
+{
+    period_stats_reset(&job->stats);
+    return esp_timer_start_periodic(job->timer, job->cfg.period_us);
+}
+
+esp_err_t hires_periodic_stop(hires_periodic_t *job)
+{
+    return esp_timer_stop(job->timer);
+}
+
+void hires_periodic_get_stats(hires_periodic_t *job, hires_periodic_stats_t *out, bool reset)
+{
+    portENTER_CRITICAL(&job->lock);
+    out->activations = job->activations;
+    out->overruns = job->overruns;
+    out->latency_mean_us = job->activations ? (uint32_t)(job->latency_sum_us / job->activations) : 0;
+    out->latency_max_us = job->latency_max_us;
+    if (reset) {
+        job->activations = 0;
+        job->overruns = 0;
+        job->latency_sum_us = 0;
+        job->latency_max_us = 0;
+    }
+    portEXIT_CRITICAL(&job->lock);
+}
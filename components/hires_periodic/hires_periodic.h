@@ -0,0 +1,123 @@
+/**
+ * @file hires_periodic.h
+ * @brief Sub-tick periodic jobs: esp_timer fires, a dedicated worker task runs the job.
+ *
+ * vTaskDelayUntil() can only express periods that are whole RTOS ticks
+ * (1 ms at CONFIG_FREERTOS_HZ=1000, 10 ms by default). A hires_periodic_t
+ * instead arms a periodic esp_timer with a period in microseconds. The
+ * timer callback does no work. It records the fire time and sends a
+ * direct-to-task notification to a worker task created for the job. The
+ * worker runs the callback at its own priority on its own core, so the job
+ * runs as a normal task. It can block, be preempted and use FPU registers,
+ * none of which is allowed in the timer ISR.
+ *
+ * Every activation is marked in an embedded period_stats_t registered
+ * under the job name, so period_stats_report_all() prints the same jitter
+ * report as for tick-based tasks. The module also counts:
+ *   - handoff latency: timer fire -> worker running (mean/max)
+ *   - overruns: fires that were still pending when the worker woke (the
+ *     callback took longer than one period); those activations are merged
+ *
+ * For the lowest jitter enable CONFIG_ESP_TIMER_SUPPORTS_ISR_DISPATCH_METHOD.
+ * The notification is then sent straight from the timer ISR instead of from
+ * the esp_timer task. Without it the job is still correct but inherits the
+ * esp_timer task's scheduling latency.
+ *
+ * Usage:
+ *   static hires_periodic_t s_ctrl;
+ *   const hires_periodic_config_t cfg = {
+ *       .name = "ctrl", .period_us = 250, .callback = control_step,
+ *       .priority = 10, .core = 1, .stack_size = 3072,
+ *   };
+ *   hires_periodic_create(&s_ctrl, &cfg);
+ *   hires_periodic_start(&s_ctrl);
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_timer.h"
+#include "period_stats.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HIRES_PERIODIC_MIN_PERIOD_US 50     //!< esp_timer's practical lower bound
+
+/** @brief Job body, called once per period from the worker task. */
+typedef void (*hires_periodic_cb_t)(void *arg);
+
+/**
+ * @brief Job configuration.
+ */
+typedef struct {
+    const char *name;               //!< Worker task and statistics name
+    uint32_t period_us;             //!< Period, >= HIRES_PERIODIC_MIN_PERIOD_US
+    hires_periodic_cb_t callback;
+    void *arg;                      //!< Passed to callback
+    UBaseType_t priority;           //!< Worker task priority
+    BaseType_t core;                //!< Worker core, or tskNO_AFFINITY
+    uint32_t stack_size;            //!< Worker stack in bytes
+} hires_periodic_config_t;
+
+/**
+ * @brief Handoff counters of one job.
+ */
+typedef struct {
+    uint32_t activations;           //!< Times the callback ran
+    uint32_t overruns;              //!< Periods merged because the worker was late
+    uint32_t latency_mean_us;       //!< Mean timer-fire -> worker-running latency
+    uint32_t latency_max_us;
+} hires_periodic_stats_t;
+
+/**
+ * @brief Job object; all fields are private.
+ */
+typedef struct {
+    hires_periodic_config_t cfg;
+    esp_timer_handle_t timer;
+    TaskHandle_t worker;
+    int64_t fire_us;                //!< Written by the timer callback, under lock
+    uint32_t activations;
+    uint32_t overruns;
+    uint64_t latency_sum_us;
+    uint32_t latency_max_us;
+    portMUX_TYPE lock;
+    period_stats_t stats;
+} hires_periodic_t;
+
+/**
+ * @brief Create the worker task and the (stopped) timer of a job.
+ *
+ * Call once per job object: its period_stats_t is added to the registry.
+ *
+ * @param job Job object (static storage).
+ * @param cfg Configuration, copied.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM, or an esp_timer error.
+ */
+esp_err_t hires_periodic_create(hires_periodic_t *job, const hires_periodic_config_t *cfg);
+
+/**
+ * @brief Start firing every cfg.period_us.
+ */
+esp_err_t hires_periodic_start(hires_periodic_t *job);
+
+/**
+ * @brief Stop the timer; the worker stays blocked until the next start.
+ */
+esp_err_t hires_periodic_stop(hires_periodic_t *job);
+
+/**
+ * @brief Read the handoff counters.
+ *
+ * @param reset Clear the counters after reading.
+ */
+void hires_periodic_get_stats(hires_periodic_t *job, hires_periodic_stats_t *out, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
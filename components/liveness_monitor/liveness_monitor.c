@@ -0,0 +1,428 @@
+/**
+ * @file liveness_monitor.c
+ * @brief Check-in deadline and starvation monitor (see liveness_monitor.h).
+ *
+ * Every check takes a uxTaskGetSystemState() snapshot into one of two
+ * static buffers, as cpu_load does, and works on the run-time deltas
+ * against the previous one. Only overdue tasks are looked up, so a quiet
+ * check costs one snapshot and a comparison per registered task.
+ *
+ * A task is flagged once per episode: the monitor only moves OK to
+ * LATE/STARVED, and only if no check-in happened since it read the
+ * record. liveness_checkin() moves it back to OK.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include "sdkconfig.h"
+#include "esp_timer.h"
+#include "liveness_monitor.h"
+
+#if !configUSE_TRACE_FACILITY || !configGENERATE_RUN_TIME_STATS
+#error "liveness_monitor needs CONFIG_FREERTOS_USE_TRACE_FACILITY and CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS"
+#endif
+
+#if !configTASKLIST_INCLUDE_COREID
+#error "liveness_monitor needs CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID"
+#endif
+
+#ifdef configRUN_TIME_COUNTER_TYPE
+typedef configRUN_TIME_COUNTER_TYPE counter_t;
+#else
+typedef uint32_t counter_t;
+#endif
+
+#ifdef CONFIG_ESP_TASK_WDT_TIMEOUT_S
+#define TWDT_TIMEOUT_MS     (CONFIG_ESP_TASK_WDT_TIMEOUT_S * 1000)
+#else
+#define TWDT_TIMEOUT_MS     0
+#endif
+
+typedef struct {
+    int64_t last_run_us;            //!< End of the last window in which the idle task ran
+    bool flagged;
+    uint32_t episodes;
+    uint32_t worst_gap_us;
+    liveness_culprit_t culprit;
+} idle_watch_t;
+
+static liveness_monitor_config_t s_cfg;
+static TaskHandle_t s_monitor;
+static liveness_task_t *s_tasks[LIVENESS_MAX_TASKS];
+static int s_ntasks;
+static idle_watch_t s_idle[portNUM_PROCESSORS];
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// Double-buffered snapshots: s_snap[s_cur] is the newest (monitor task only)
+static TaskStatus_t s_snap[2][LIVENESS_MAX_SNAPSHOT];
+static UBaseType_t s_count[2];
+static counter_t s_total[2];
+static int s_cur;
+
+// ------------------------ Snapshots ------------------------
+
+static const TaskStatus_t *find(int snap, TaskHandle_t handle)
+{
+    for (UBaseType_t i = 0; i < s_count[snap]; i++) {
+        if (s_snap[snap][i].xHandle == handle) {
+            return &s_snap[snap][i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run time of a task of the newest snapshot over the last window.
+ */
+static counter_t ran_in_window(const TaskStatus_t *now)
+{
+    const TaskStatus_t *before = find(s_cur ^ 1, now->xHandle);
+    // A task created during the window ran at most since its creation
+    return (counter_t)now->ulRunTimeCounter - (before ? (counter_t)before->ulRunTimeCounter : 0);
+}
+
+static bool is_idle(TaskHandle_t handle)
+{
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        if (handle == xTaskGetIdleTaskHandleForCore(c)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Take a snapshot; false while there is no previous one or the window is empty.
+ */
+static bool snapshot(counter_t *window)
+{
+    int cur = s_cur ^ 1;
+    counter_t total;
+
+    s_count[cur] = uxTaskGetSystemState(s_snap[cur], LIVENESS_MAX_SNAPSHOT, &total);
+    s_total[cur] = total;
+    s_cur = cur;
+    *window = s_total[cur] - s_total[cur ^ 1];
+    return s_count[cur ^ 1] != 0 && s_count[cur] != 0 && *window != 0;
+}
+
+/**
+ * @brief Busiest task above @p priority that may run on @p core in the last window.
+ *
+ * Unpinned tasks count for every core: their counter does not say where they ran.
+ *
+ * @return false if no such task ran at all.
+ */
+static bool find_culprit(BaseType_t core, UBaseType_t priority, counter_t window, liveness_culprit_t *out)
+{
+    const TaskStatus_t *best = NULL;
+    counter_t best_ran = 0;
+
+    for (UBaseType_t i = 0; i < s_count[s_cur]; i++) {
+        const TaskStatus_t *ts = &s_snap[s_cur][i];
+        if (ts->xHandle == s_monitor || ts->uxCurrentPriority <= priority || is_idle(ts->xHandle)) {
+            continue;
+        }
+        if (core != tskNO_AFFINITY && ts->xCoreID != core && ts->xCoreID != tskNO_AFFINITY) {
+            continue;
+        }
+        counter_t ran = ran_in_window(ts);
+        if (ran > best_ran) {
+            best = ts;
+            best_ran = ran;
+        }
+    }
+
+    memset(out, 0, sizeof(*out));
+    if (best == NULL) {
+        return false;
+    }
+    snprintf(out->name, sizeof(out->name), "%s", best->pcTaskName);
+    out->priority = best->uxCurrentPriority;
+    out->permille = (uint32_t)((uint64_t)best_ran * 1000 / window);
+    return true;
+}
+
+static void print_culprit(BaseType_t core, const liveness_culprit_t *c)
+{
+    if (core == tskNO_AFFINITY) {
+        printf(" | busiest higher task ");
+    } else {
+        printf(" | core%d held by ", (int)core);
+    }
+    if (c->name[0] == '\0') {
+        printf("none (interrupts or critical sections?)\n");
+    } else {
+        printf("%s p%u %" PRIu32 ".%" PRIu32 "%%\n", c->name, (unsigned)c->priority,
+               c->permille / 10, c->permille % 10);
+    }
+}
+
+// ------------------------ Monitor ------------------------
+
+/**
+ * @brief Classify one overdue task and open its episode.
+ */
+static void check_task(liveness_task_t *t, int64_t now, counter_t window)
+{
+    portENTER_CRITICAL(&s_lock);
+    int64_t last = t->last_us;
+    liveness_state_t state = t->state;
+    portEXIT_CRITICAL(&s_lock);
+
+    int64_t gap = now - last;
+    if (state != LIVENESS_OK || gap <= (int64_t)t->cfg.interval_ms * 10 * t->cfg.late_pct) {
+        return;
+    }
+    const TaskStatus_t *ts = find(s_cur, t->handle);
+    if (ts == NULL) {
+        return;                     // Deleted, or beyond LIVENESS_MAX_SNAPSHOT
+    }
+
+    counter_t ran = ran_in_window(ts);
+    bool starved = ts->eCurrentState == eReady && (uint64_t)ran * 100 < window;
+    liveness_culprit_t culprit = { 0 };
+    if (starved) {
+        find_culprit(ts->xCoreID, ts->uxCurrentPriority, window, &culprit);
+    }
+
+    bool opened = false;
+    portENTER_CRITICAL(&s_lock);
+    if (t->last_us == last && t->state == LIVENESS_OK) {
+        opened = true;
+        if (starved) {
+            t->state = LIVENESS_STARVED;
+            t->starved++;
+            t->culprit = culprit;
+        } else {
+            t->state = LIVENESS_LATE;
+            t->late++;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    if (!opened || s_cfg.quiet) {
+        return;
+    }
+
+    char where[8];
+    if (ts->xCoreID == tskNO_AFFINITY) {
+        snprintf(where, sizeof(where), "*");
+    } else {
+        snprintf(where, sizeof(where), "%d", (int)ts->xCoreID);
+    }
+    printf("[LIVE] %s %s p%u@%s: no check-in for %" PRIu32 " ms (interval %" PRIu32 ")",
+           starved ? "STARVED" : "LATE", t->cfg.name, (unsigned)ts->uxCurrentPriority, where,
+           (uint32_t)(gap / 1000), t->cfg.interval_ms);
+    if (starved) {
+        print_culprit(ts->xCoreID, &culprit);
+    } else if (ts->eCurrentState == eBlocked || ts->eCurrentState == eSuspended) {
+        printf(" | %s, not starved\n", ts->eCurrentState == eBlocked ? "blocked" : "suspended");
+    } else {
+        printf(" | ran %" PRIu32 "%% of the window\n", (uint32_t)((uint64_t)ran * 100 / window));
+    }
+}
+
+static void check_idle(int core, int64_t now, counter_t window)
+{
+    const TaskStatus_t *ts = find(s_cur, xTaskGetIdleTaskHandleForCore(core));
+    idle_watch_t *w = &s_idle[core];
+
+    if (ts == NULL) {
+        return;
+    }
+    if (ran_in_window(ts) > 0) {
+        portENTER_CRITICAL(&s_lock);
+        w->last_run_us = now;
+        w->flagged = false;
+        portEXIT_CRITICAL(&s_lock);
+        return;
+    }
+
+    uint32_t gap = (uint32_t)(now - w->last_run_us);
+    bool opened = !w->flagged && gap > s_cfg.idle_warn_ms * 1000;
+    liveness_culprit_t culprit;
+    if (opened) {
+        find_culprit(core, 0, window, &culprit);
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    if (gap > w->worst_gap_us) {
+        w->worst_gap_us = gap;
+    }
+    if (opened) {
+        w->flagged = true;
+        w->episodes++;
+        w->culprit = culprit;
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    if (opened && !s_cfg.quiet) {
+        printf("[LIVE] core%d IDLE starved %" PRIu32 " ms (TWDT %d)", core, gap / 1000, TWDT_TIMEOUT_MS);
+        print_culprit(core, &culprit);
+    }
+}
+
+/**
+ * @brief One snapshot per check_ms; overdue tasks and silent idle tasks are classified.
+ *
+ * @param arg Unused.
+ */
+static void liveness_monitor_task(void *arg)
+{
+    TickType_t period = pdMS_TO_TICKS(s_cfg.check_ms) ? pdMS_TO_TICKS(s_cfg.check_ms) : 1;
+    TickType_t last_wake = xTaskGetTickCount();
+    counter_t window;
+
+    snapshot(&window);              // Baseline snapshot
+    while (1) {
+        vTaskDelayUntil(&last_wake, period);
+        if (!snapshot(&window)) {
+            continue;
+        }
+        int64_t now = esp_timer_get_time();
+
+        portENTER_CRITICAL(&s_lock);
+        int n = s_ntasks;
+        portEXIT_CRITICAL(&s_lock);
+        for (int i = 0; i < n; i++) {
+            check_task(s_tasks[i], now, window);
+        }
+        for (int c = 0; c < portNUM_PROCESSORS; c++) {
+            check_idle(c, now, window);
+        }
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t liveness_monitor_start(const liveness_monitor_config_t *cfg)
+{
+    if (s_monitor != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (cfg != NULL) {
+        s_cfg = *cfg;
+    } else {
+        s_cfg.core = tskNO_AFFINITY;
+    }
+    s_cfg.check_ms = s_cfg.check_ms ? s_cfg.check_ms : 50;
+    s_cfg.idle_warn_ms = s_cfg.idle_warn_ms ? s_cfg.idle_warn_ms : (TWDT_TIMEOUT_MS ? TWDT_TIMEOUT_MS / 4 : 1000);
+    s_cfg.priority = s_cfg.priority ? s_cfg.priority : configMAX_PRIORITIES - 1;
+
+    int64_t now = esp_timer_get_time();
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        s_idle[c].last_run_us = now;
+    }
+    if (xTaskCreatePinnedToCore(liveness_monitor_task, "liveness", 3072, NULL,
+                                s_cfg.priority, &s_monitor, s_cfg.core) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t liveness_register(liveness_task_t *t, TaskHandle_t task, const liveness_task_config_t *cfg)
+{
+    if (t == NULL || cfg == NULL || cfg->interval_ms == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *t = (liveness_task_t) {
+        .cfg = *cfg,
+        .handle = task ? task : xTaskGetCurrentTaskHandle(),
+        .last_us = esp_timer_get_time(),
+    };
+    t->cfg.name = t->cfg.name ? t->cfg.name : pcTaskGetName(t->handle);
+    t->cfg.late_pct = t->cfg.late_pct ? t->cfg.late_pct : 150;
+
+    if (t->cfg.twdt) {
+        esp_err_t err = esp_task_wdt_add_user(t->cfg.name, &t->twdt_user);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_ntasks == LIVENESS_MAX_TASKS) {
+        portEXIT_CRITICAL(&s_lock);
+        if (t->twdt_user != NULL) {
+            esp_task_wdt_delete_user(t->twdt_user);
+        }
+        return ESP_ERR_NO_MEM;
+    }
+    s_tasks[s_ntasks++] = t;
+    portEXIT_CRITICAL(&s_lock);
+    return ESP_OK;
+}
+
+void liveness_checkin(liveness_task_t *t)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    uint32_t gap = (uint32_t)(now - t->last_us);
+    if (gap > t->worst_gap_us) {
+        t->worst_gap_us = gap;
+    }
+    t->last_us = now;
+    t->state = LIVENESS_OK;
+    t->checkins++;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (t->twdt_user != NULL) {
+        esp_task_wdt_reset_user(t->twdt_user);
+    }
+}
+
+void liveness_get_stats(liveness_task_t *t, liveness_stats_t *out, bool reset)
+{
+    portENTER_CRITICAL(&s_lock);
+    out->state = t->state;
+    out->checkins = t->checkins;
+    out->late = t->late;
+    out->starved = t->starved;
+    out->worst_gap_ms = t->worst_gap_us / 1000;
+    out->culprit = t->culprit;
+    if (reset) {
+        t->checkins = 0;
+        t->late = 0;
+        t->starved = 0;
+        t->worst_gap_us = 0;
+        memset(&t->culprit, 0, sizeof(t->culprit));
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void liveness_monitor_report(void)
+{
+    static const char *const state_name[] = { "ok", "LATE", "STARVED" };
+
+    for (int i = 0; i < s_ntasks; i++) {
+        liveness_task_t *t = s_tasks[i];
+        liveness_stats_t st;
+        liveness_get_stats(t, &st, false);
+
+        printf("[LIVE] %-12s %-7s checkins=%" PRIu32 " late=%" PRIu32 " starved=%" PRIu32
+               " worst gap %" PRIu32 " ms (interval %" PRIu32 ")",
+               t->cfg.name, state_name[st.state], st.checkins, st.late, st.starved,
+               st.worst_gap_ms, t->cfg.interval_ms);
+        if (st.culprit.name[0] != '\0') {
+            printf(" | last culprit %s p%u %" PRIu32 ".%" PRIu32 "%%", st.culprit.name,
+                   (unsigned)st.culprit.priority, st.culprit.permille / 10, st.culprit.permille % 10);
+        }
+        printf("\n");
+    }
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        portENTER_CRITICAL(&s_lock);
+        idle_watch_t w = s_idle[c];
+        portEXIT_CRITICAL(&s_lock);
+
+        printf("[LIVE] core%d idle: starved %" PRIu32 "x, longest gap %" PRIu32 " ms (warn %" PRIu32 ", TWDT %d)",
+               c, w.episodes, w.worst_gap_us / 1000, s_cfg.idle_warn_ms, TWDT_TIMEOUT_MS);
+        if (w.culprit.name[0] != '\0') {
+            printf(" | last culprit %s p%u", w.culprit.name, (unsigned)w.culprit.priority);
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,160 @@
+/**
+ * @file liveness_monitor.h
+ * @brief Check-in deadlines per task with starvation detection and culprit attribution.
+ *
+ * When a high-priority task spins, every lower task on that core and the
+ * idle task stop running. Nothing reports it until the task watchdog
+ * resets the board, and the TWDT panic only names the idle task. A task
+ * that registers here declares how often it checks in (liveness_checkin()
+ * in its loop). A monitor task at the top priority checks every check_ms.
+ * A task whose check-in is older than interval_ms * late_pct / 100 is
+ * classified from the run-time counters of the last check window:
+ *   STARVED  ready to run, but got less than 1% of a core
+ *   LATE     blocked, or running but too slow
+ * For a starved task the busiest higher-priority task that can run on the
+ * task's core is blamed (the one holding the core *now*, in the last
+ * window). The idle task of each core is watched the same way against
+ * idle_warn_ms, which defaults to a quarter of the TWDT timeout.
+ *
+ * Each episode (first detection until the next check-in) prints one line
+ * when detected, so the cause is on the console before a reset:
+ *   [LIVE] STARVED LowPriority p3@0: no check-in for 612 ms (interval 200) | core0 held by HighPriority p8 99.7%
+ *   [LIVE] core0 IDLE starved 1250 ms (TWDT 5000) | core0 held by HighPriority p8 99.7%
+ * liveness_monitor_report() prints the totals per task and core:
+ *   [LIVE] LowPriority  ok      checkins=40 late=0 starved=2 worst gap 1840 ms (interval 200) | last culprit HighPriority p8 99.7%
+ *   [LIVE] core0 idle: starved 1x, longest gap 1840 ms (warn 1250, TWDT 5000) | last culprit HighPriority p8
+ *   (illustrative)
+ *
+ * With twdt set, each check-in also feeds a TWDT user of that name
+ * (esp_task_wdt_add_user()). The board then resets for a task that stays
+ * silent past the TWDT timeout, not just for a starved idle task, and the
+ * panic names it. The monitor's warning comes much earlier.
+ *
+ * Requires CONFIG_FREERTOS_USE_TRACE_FACILITY=y,
+ * CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS=y and
+ * CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID=y (TaskStatus_t.xCoreID).
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+#include "esp_task_wdt.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef LIVENESS_MAX_TASKS
+#define LIVENESS_MAX_TASKS 8        //!< Registered tasks
+#endif
+
+#ifndef LIVENESS_MAX_SNAPSHOT
+#define LIVENESS_MAX_SNAPSHOT 32    //!< Tasks in the system the monitor can see
+#endif
+
+typedef enum {
+    LIVENESS_OK,
+    LIVENESS_LATE,
+    LIVENESS_STARVED,
+} liveness_state_t;
+
+/**
+ * @brief Check-in contract of one task; zero fields take the defaults in brackets.
+ */
+typedef struct {
+    const char *name;               //!< Report name [task name]
+    uint32_t interval_ms;           //!< Expected time between check-ins (required)
+    uint32_t late_pct;              //!< Overdue after this share of interval_ms [150]
+    bool twdt;                      //!< Also feed a TWDT user on every check-in
+} liveness_task_config_t;
+
+/** @brief The task blamed for an episode. */
+typedef struct {
+    char name[configMAX_TASK_NAME_LEN];
+    UBaseType_t priority;
+    uint32_t permille;              //!< Share of one core in the window, 0..1000
+} liveness_culprit_t;
+
+/**
+ * @brief Task record; all fields are private.
+ */
+typedef struct {
+    liveness_task_config_t cfg;
+    TaskHandle_t handle;
+    esp_task_wdt_user_handle_t twdt_user;
+    int64_t last_us;                //!< Last check-in
+    liveness_state_t state;         //!< Current episode, OK after each check-in
+    uint32_t checkins;
+    uint32_t late;
+    uint32_t starved;
+    uint32_t worst_gap_us;
+    liveness_culprit_t culprit;     //!< Of the last starved episode
+} liveness_task_t;
+
+/**
+ * @brief Monitor settings; zero fields take the defaults in brackets.
+ */
+typedef struct {
+    uint32_t check_ms;              //!< Check period and counter window [50]
+    uint32_t idle_warn_ms;          //!< Idle task silent this long is reported [TWDT timeout / 4, or 1000]
+    UBaseType_t priority;           //!< Monitor priority [configMAX_PRIORITIES - 1]
+    BaseType_t core;                //!< Monitor core [tskNO_AFFINITY]
+    bool quiet;                     //!< Do not print episodes as they are detected
+} liveness_monitor_config_t;
+
+/** @brief Snapshot of one task's counters. */
+typedef struct {
+    liveness_state_t state;
+    uint32_t checkins;
+    uint32_t late;
+    uint32_t starved;
+    uint32_t worst_gap_ms;          //!< Longest time without a check-in
+    liveness_culprit_t culprit;     //!< Empty name if never starved
+} liveness_stats_t;
+
+/**
+ * @brief Start the monitor task.
+ *
+ * Keep it at the top priority and unpinned: it must run while a spinning
+ * task owns a core, and it sees both cores from either one.
+ *
+ * @param cfg Settings, or NULL for all defaults.
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already running, ESP_ERR_NO_MEM.
+ */
+esp_err_t liveness_monitor_start(const liveness_monitor_config_t *cfg);
+
+/**
+ * @brief Register a task; its first interval starts now.
+ *
+ * @param t    Record, owned by the caller for the lifetime of the task.
+ * @param task Task to watch, or NULL for the calling task.
+ * @param cfg  Contract.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM when LIVENESS_MAX_TASKS
+ *         are registered, or the error of esp_task_wdt_add_user() (TWDT not
+ *         initialised); the task is not registered then.
+ */
+esp_err_t liveness_register(liveness_task_t *t, TaskHandle_t task, const liveness_task_config_t *cfg);
+
+/**
+ * @brief Report progress; call once per loop of the watched task.
+ */
+void liveness_checkin(liveness_task_t *t);
+
+/**
+ * @brief Copy a task's counters.
+ *
+ * @param reset Clear the counters and the culprit afterwards.
+ */
+void liveness_get_stats(liveness_task_t *t, liveness_stats_t *out, bool reset);
+
+/**
+ * @brief Print the totals of every registered task and every core's idle task.
+ */
+void liveness_monitor_report(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,200 @@
+/**
+ * @file period_stats.c
+ * @brief Jitter and drift statistics for periodic tasks (see period_stats.h).
+ *
+ * Welford's update runs on the period *error* in single precision. The
+ * ESP32 FPU is single-precision, and the error stays small next to the
+ * nominal period, so float keeps the mark cost at a few cycles without
+ * losing accuracy.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "period_stats.h"
+
+static period_stats_t *s_registry;
+static portMUX_TYPE s_registry_lock = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t s_reporter;
+
+// ------------------------ Helpers ------------------------
+
+/**
+ * @brief Clear run state (caller holds ps->lock or owns ps exclusively).
+ */
+static void clear_locked(period_stats_t *ps)
+{
+    ps->first_us = 0;
+    ps->last_us = 0;
+    ps->count = 0;
+    ps->mean_err_us = 0.0f;
+    ps->m2 = 0.0f;
+    ps->min_err_us = INT32_MAX;
+    ps->max_err_us = INT32_MIN;
+    ps->missed = 0;
+    memset(ps->hist, 0, sizeof(ps->hist));
+}
+
+/**
+ * @brief Histogram bucket for an error value; bucket 8 holds [0, w).
+ */
+static inline unsigned error_bucket(int32_t err_us, int32_t width)
+{
+    int32_t b = err_us / width;
+    if (err_us < 0 && err_us % width != 0) {
+        b--;                        // floor division
+    }
+    b += PERIOD_STATS_BUCKETS / 2;
+    if (b < 0) {
+        b = 0;
+    }
+    if (b >= PERIOD_STATS_BUCKETS) {
+        b = PERIOD_STATS_BUCKETS - 1;
+    }
+    return (unsigned)b;
+}
+
+// ------------------------ API ------------------------
+
+void period_stats_init(period_stats_t *ps, const char *name, int64_t nominal_us,
+                       int32_t bucket_us, int32_t slack_us)
+{
+    ps->name = name;
+    ps->nominal_us = nominal_us;
+    ps->bucket_us = bucket_us > 0 ? bucket_us : (int32_t)(nominal_us / 100);
+    if (ps->bucket_us < 1) {
+        ps->bucket_us = 1;
+    }
+    ps->slack_us = slack_us > 0 ? slack_us : (int32_t)(nominal_us / 10);
+    portMUX_INITIALIZE(&ps->lock);
+    clear_locked(ps);
+
+    portENTER_CRITICAL(&s_registry_lock);
+    ps->next = s_registry;
+    s_registry = ps;
+    portEXIT_CRITICAL(&s_registry_lock);
+}
+
+void period_stats_mark(period_stats_t *ps)
+{
+    period_stats_mark_at(ps, esp_timer_get_time());
+}
+
+void period_stats_mark_at(period_stats_t *ps, int64_t now_us)
+{
+    portENTER_CRITICAL_SAFE(&ps->lock);
+    if (ps->first_us == 0) {
+        ps->first_us = now_us;
+        ps->last_us = now_us;
+        portEXIT_CRITICAL_SAFE(&ps->lock);
+        return;
+    }
+
+    int64_t e = (now_us - ps->last_us) - ps->nominal_us;
+    int32_t err = e > INT32_MAX ? INT32_MAX : (e < INT32_MIN ? INT32_MIN : (int32_t)e);
+    ps->last_us = now_us;
+    ps->count++;
+
+    float delta = (float)err - ps->mean_err_us;
+    ps->mean_err_us += delta / (float)ps->count;
+    ps->m2 += delta * ((float)err - ps->mean_err_us);
+
+    if (err < ps->min_err_us) {
+        ps->min_err_us = err;
+    }
+    if (err > ps->max_err_us) {
+        ps->max_err_us = err;
+    }
+    if (err > ps->slack_us) {
+        ps->missed++;
+    }
+    ps->hist[error_bucket(err, ps->bucket_us)]++;
+    portEXIT_CRITICAL_SAFE(&ps->lock);
+}
+
+void period_stats_snapshot(period_stats_t *ps, period_stats_summary_t *out)
+{
+    portENTER_CRITICAL(&ps->lock);
+    out->name = ps->name;
+    out->nominal_us = ps->nominal_us;
+    out->bucket_us = ps->bucket_us;
+    out->count = ps->count;
+    out->mean_err_us = ps->mean_err_us;
+    out->stddev_us = ps->count > 1 ? ps->m2 / (float)(ps->count - 1) : 0.0f;
+    out->min_err_us = ps->count ? ps->min_err_us : 0;
+    out->max_err_us = ps->count ? ps->max_err_us : 0;
+    out->drift_us = ps->count ? (ps->last_us - ps->first_us) - (int64_t)ps->count * ps->nominal_us : 0;
+    out->missed = ps->missed;
+    memcpy(out->hist, ps->hist, sizeof(out->hist));
+    portEXIT_CRITICAL(&ps->lock);
+
+    out->stddev_us = sqrtf(out->stddev_us);     // variance -> stddev outside the lock
+}
+
+void period_stats_reset(period_stats_t *ps)
+{
+    portENTER_CRITICAL(&ps->lock);
+    clear_locked(ps);
+    portEXIT_CRITICAL(&ps->lock);
+}
+
+void period_stats_report_all(void)
+{
+    period_stats_summary_t s;
+    char hist[PERIOD_STATS_BUCKETS * 7];
+
+    // Entries are only ever added at the head, so walking without the
+    // lock is safe once we have read the head pointer.
+    portENTER_CRITICAL(&s_registry_lock);
+    period_stats_t *ps = s_registry;
+    portEXIT_CRITICAL(&s_registry_lock);
+
+    for (; ps != NULL; ps = ps->next) {
+        period_stats_snapshot(ps, &s);
+
+        size_t pos = 0;
+        for (unsigned b = 0; b < PERIOD_STATS_BUCKETS && pos < sizeof(hist); b++) {
+            pos += (size_t)snprintf(hist + pos, sizeof(hist) - pos, "%s%" PRIu32,
+                                    b ? " " : "", s.hist[b]);
+        }
+
+        printf("[PSTAT] %-12s n=%" PRIu32 " nominal=%" PRId64 "us err mean=%+.1f sd=%.1f min=%+" PRId32
+               " max=%+" PRId32 " us drift=%+" PRId64 "us missed=%" PRIu32 "\n",
+               s.name, s.count, s.nominal_us, (double)s.mean_err_us, (double)s.stddev_us,
+               s.min_err_us, s.max_err_us, s.drift_us, s.missed);
+        printf("[PSTAT] %-12s hist(%" PRId32 "us/bin, <-%d..>=+%d): %s\n",
+               s.name, s.bucket_us, PERIOD_STATS_BUCKETS / 2 - 1, PERIOD_STATS_BUCKETS / 2 - 1, hist);
+    }
+}
+
+/**
+ * @brief Low-priority task that prints every registered digest periodically.
+ *
+ * @param arg Report interval in ms (cast from uintptr_t).
+ */
+static void period_stats_reporter_task(void *arg)
+{
+    const TickType_t period = pdMS_TO_TICKS((uint32_t)(uintptr_t)arg);
+    TickType_t last_wake = xTaskGetTickCount();
+
+    while (1) {
+        vTaskDelayUntil(&last_wake, period);
+        period_stats_report_all();
+    }
+}
+
+esp_err_t period_stats_start_reporter(uint32_t period_ms, UBaseType_t priority)
+{
+    if (s_reporter != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (xTaskCreate(period_stats_reporter_task, "pstat_report", 3072,
+                    (void *)(uintptr_t)period_ms, priority, &s_reporter) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
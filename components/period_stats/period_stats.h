@@ -0,0 +1,134 @@
+/**
+ * @file period_stats.h
+ * @brief Jitter and drift statistics for periodic tasks (vTaskDelay, vTaskDelayUntil, timers).
+ *
+ * A periodic task calls period_stats_mark() once per activation. The module
+ * measures the actual period with esp_timer_get_time() and keeps, per task:
+ *   - online mean and variance of the period error (Welford), plus min/max
+ *   - a fixed-bucket histogram of the period error against the nominal period
+ *   - accumulated drift: elapsed time minus activations * nominal period
+ *   - missed deadlines: activations later than nominal + deadline slack
+ *
+ * Every instance is put on a registry list when it is initialized.
+ * period_stats_report_all() (or the reporter task from
+ * period_stats_start_reporter()) prints one compact block per task. The
+ * periodic task itself never formats or prints anything.
+ *
+ * Usage:
+ *   static period_stats_t s_stats;
+ *   period_stats_init(&s_stats, "sensor", PERIOD_STATS_TICKS_TO_US(period_ticks), 0, 0);
+ *   period_stats_start_reporter(5000, 1);
+ *   while (1) {
+ *       vTaskDelayUntil(&last_wake, period_ticks);
+ *       period_stats_mark(&s_stats);
+ *       ...
+ *   }
+ */
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PERIOD_STATS_BUCKETS 16     //!< Histogram buckets (error < -7w ... error >= 7w)
+
+/** @brief Nominal period in microseconds for a period given in RTOS ticks. */
+#define PERIOD_STATS_TICKS_TO_US(ticks) ((int64_t)(ticks) * portTICK_PERIOD_MS * 1000)
+
+/**
+ * @brief Per-task statistics; initialize with period_stats_init().
+ *
+ * All fields are private; read them through period_stats_snapshot().
+ */
+typedef struct period_stats {
+    const char *name;
+    int64_t nominal_us;             //!< Expected period
+    int32_t bucket_us;              //!< Histogram bucket width
+    int32_t slack_us;               //!< Lateness tolerated before a deadline miss
+    int64_t first_us;               //!< Time of the first mark
+    int64_t last_us;                //!< Time of the previous mark
+    uint32_t count;                 //!< Periods measured
+    float mean_err_us;              //!< Welford running mean of (period - nominal)
+    float m2;                       //!< Welford sum of squared deviations
+    int32_t min_err_us;
+    int32_t max_err_us;
+    uint32_t missed;
+    uint32_t hist[PERIOD_STATS_BUCKETS];
+    portMUX_TYPE lock;
+    struct period_stats *next;      //!< Registry link
+} period_stats_t;
+
+/**
+ * @brief Digest of one task's statistics.
+ */
+typedef struct {
+    const char *name;
+    int64_t nominal_us;
+    int32_t bucket_us;
+    uint32_t count;
+    float mean_err_us;              //!< Mean period error (positive = late)
+    float stddev_us;                //!< Standard deviation of the period (jitter)
+    int32_t min_err_us;
+    int32_t max_err_us;
+    int64_t drift_us;               //!< Elapsed - count * nominal since first mark
+    uint32_t missed;
+    uint32_t hist[PERIOD_STATS_BUCKETS];
+} period_stats_summary_t;
+
+/**
+ * @brief Initialize and register one task's statistics.
+ *
+ * @param ps         Statistics object (static storage).
+ * @param name       Label used in reports (string literal).
+ * @param nominal_us Nominal period in microseconds.
+ * @param bucket_us  Histogram bucket width, 0 for nominal/100 (min 1 us).
+ * @param slack_us   Lateness allowed before counting a missed deadline,
+ *                   0 for nominal/10.
+ */
+void period_stats_init(period_stats_t *ps, const char *name, int64_t nominal_us,
+                       int32_t bucket_us, int32_t slack_us);
+
+/**
+ * @brief Record one activation at the current time.
+ *
+ * The first call only sets the reference point.
+ */
+void period_stats_mark(period_stats_t *ps);
+
+/**
+ * @brief Record one activation at time @p now_us (for callers that already
+ *        read esp_timer_get_time(), or from an ISR).
+ */
+void period_stats_mark_at(period_stats_t *ps, int64_t now_us);
+
+/**
+ * @brief Read a consistent digest of @p ps.
+ */
+void period_stats_snapshot(period_stats_t *ps, period_stats_summary_t *out);
+
+/**
+ * @brief Clear the accumulated statistics; the next mark starts a new run.
+ */
+void period_stats_reset(period_stats_t *ps);
+
+/**
+ * @brief Print the digest of every registered task.
+ */
+void period_stats_report_all(void);
+
+/**
+ * @brief Start a task that calls period_stats_report_all() every @p period_ms.
+ *
+ * @param period_ms Report interval.
+ * @param priority  Reporter priority (keep it below the measured tasks).
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already running, or ESP_ERR_NO_MEM.
+ */
+esp_err_t period_stats_start_reporter(uint32_t period_ms, UBaseType_t priority);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,162 @@
+/**
+ * @file periodic_jobs.c
+ * @brief Periodic callbacks on static software timers (see periodic_jobs.h).
+ *
+ * All callbacks run in the timer service task, one at a time. The
+ * trampoline is therefore the only writer of the per-job counters and of
+ * s_last_tick. s_lock only keeps the counters consistent for readers on
+ * other tasks. A service-task wakeup is counted when a callback runs on a
+ * tick later than the previous one, so jobs sharing a tick count once.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_timer.h"
+#include "periodic_jobs.h"
+
+static periodic_job_t *s_jobs[PERIODIC_JOBS_MAX];
+static int s_njobs;
+static TickType_t s_last_tick;
+static uint32_t s_wakeups;
+static int64_t s_since_us;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ------------------------ Timer callback ------------------------
+
+/**
+ * @brief Times one run of the job's callback; runs in the timer service task.
+ */
+static void job_trampoline(TimerHandle_t timer)
+{
+    periodic_job_t *job = (periodic_job_t *)pvTimerGetTimerID(timer);
+    TickType_t now = xTaskGetTickCount();
+
+    int64_t t0 = esp_timer_get_time();
+    job->cfg.cb(job->cfg.arg);
+    uint32_t us = (uint32_t)(esp_timer_get_time() - t0);
+
+    portENTER_CRITICAL(&s_lock);
+    if (now != s_last_tick) {
+        s_last_tick = now;
+        s_wakeups++;
+    }
+    job->runs++;
+    job->busy_us += us;
+    if (us > job->max_us) {
+        job->max_us = us;
+    }
+    if (us > job->cfg.budget_us) {
+        job->over_budget++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t periodic_job_start(periodic_job_t *job, const periodic_job_config_t *cfg, TickType_t wait)
+{
+    if (job == NULL || cfg == NULL || cfg->cb == NULL || cfg->period_ms == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *job = (periodic_job_t) { .cfg = *cfg };
+    job->cfg.name = cfg->name ? cfg->name : "job";
+    job->cfg.budget_us = cfg->budget_us ? cfg->budget_us : 200;
+    TickType_t period = pdMS_TO_TICKS(cfg->period_ms) ? pdMS_TO_TICKS(cfg->period_ms) : 1;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_njobs == PERIODIC_JOBS_MAX) {
+        portEXIT_CRITICAL(&s_lock);
+        return ESP_ERR_NO_MEM;
+    }
+    if (s_njobs == 0) {
+        s_since_us = esp_timer_get_time();
+    }
+    s_jobs[s_njobs++] = job;
+    portEXIT_CRITICAL(&s_lock);
+
+    job->timer = xTimerCreateStatic(job->cfg.name, period, pdTRUE, job, job_trampoline, &job->timer_buf);
+    if (job->timer == NULL || xTimerStart(job->timer, wait) != pdPASS) {
+        job->timer = NULL;          // Never active: the kernel holds no reference to timer_buf
+        periodic_job_stop(job, 0);
+        return ESP_ERR_TIMEOUT;
+    }
+    return ESP_OK;
+}
+
+esp_err_t periodic_job_stop(periodic_job_t *job, TickType_t wait)
+{
+    if (job->timer != NULL) {
+        if (xTimerStop(job->timer, wait) != pdPASS || xTimerDelete(job->timer, wait) != pdPASS) {
+            return ESP_ERR_TIMEOUT;
+        }
+        job->timer = NULL;
+    }
+
+    esp_err_t err = ESP_ERR_INVALID_STATE;
+    portENTER_CRITICAL(&s_lock);
+    for (int i = 0; i < s_njobs; i++) {
+        if (s_jobs[i] == job) {
+            s_jobs[i] = s_jobs[--s_njobs];
+            err = ESP_OK;
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return err;
+}
+
+void periodic_jobs_get_stats(periodic_jobs_stats_t *out, bool reset)
+{
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s_lock);
+    *out = (periodic_jobs_stats_t) {
+        .jobs = (uint32_t)s_njobs,
+        .wakeups = s_wakeups,
+        .elapsed_us = (uint64_t)(now - s_since_us),
+    };
+    for (int i = 0; i < s_njobs; i++) {
+        out->runs += s_jobs[i]->runs;
+        out->over_budget += s_jobs[i]->over_budget;
+        if (reset) {
+            s_jobs[i]->runs = 0;
+            s_jobs[i]->over_budget = 0;
+            s_jobs[i]->max_us = 0;
+            s_jobs[i]->busy_us = 0;
+        }
+    }
+    if (reset) {
+        s_wakeups = 0;
+        s_since_us = now;
+    }
+    portEXIT_CRITICAL(&s_lock);
+}
+
+void periodic_jobs_report(void)
+{
+    periodic_job_t copy[PERIODIC_JOBS_MAX];
+    periodic_jobs_stats_t st;
+
+    portENTER_CRITICAL(&s_lock);
+    int n = s_njobs;
+    for (int i = 0; i < n; i++) {
+        copy[i] = *s_jobs[i];
+    }
+    portEXIT_CRITICAL(&s_lock);
+    periodic_jobs_get_stats(&st, true);
+
+    printf("[PJOB] %" PRIu32 " jobs, %" PRIu32 " s: %" PRIu32 " runs in %" PRIu32 " service wakeups (%" PRIu32 " shared)\n",
+           st.jobs, (uint32_t)(st.elapsed_us / 1000000), st.runs, st.wakeups,
+           st.runs > st.wakeups ? st.runs - st.wakeups : 0);
+    for (int i = 0; i < n; i++) {
+        const periodic_job_t *j = &copy[i];
+        printf("[PJOB]   %-8s period %" PRIu32 " ms runs=%" PRIu32 " avg %" PRIu32 " max %" PRIu32 " us",
+               j->cfg.name, j->cfg.period_ms, j->runs,
+               j->runs ? (uint32_t)(j->busy_us / j->runs) : 0, j->max_us);
+        if (j->over_budget) {
+            printf(" over=%" PRIu32 " -> move to a task", j->over_budget);
+        }
+        printf("\n");
+    }
+}
@@ -0,0 +1,113 @@
+/**
+ * @file periodic_jobs.h
+ * @brief Lightweight periodic callbacks on static FreeRTOS software timers instead of tasks.
+ *
+ * Many examples spend a task with a 2048-byte stack on a loop that wakes up,
+ * toggles a pin or bumps a counter, and goes back to vTaskDelay(). A
+ * periodic_job_t runs that body as a callback of an auto-reload timer
+ * created with xTimerCreateStatic(). All jobs share the timer service task
+ * and its stack (CONFIG_FREERTOS_TIMER_TASK_STACK_DEPTH). Each job needs
+ * only the periodic_job_t, with its StaticTimer_t inside, and no heap.
+ * Jobs that expire on the same tick run in one service-task wakeup, so
+ * they also cost fewer context switches.
+ *
+ * A job must stay a task when it:
+ *   - blocks: callbacks must never wait on queues, semaphores, delays or
+ *     a contended printf/UART lock, because that stalls every other timer
+ *     and every xTimer*() command
+ *   - runs longer than a few hundred microseconds, since it delays the
+ *     other jobs due on the same tick (see budget_us below)
+ *   - needs a priority other than CONFIG_FREERTOS_TIMER_TASK_PRIORITY, or
+ *     a core other than the timer task's, or a stack deeper than the
+ *     shared one
+ *   - needs sub-tick periods (use hires_periodic) or can run late within
+ *     a window (use wake_coalescer, one shared task that batches wakeups)
+ *
+ * Each callback is timed. Runs longer than budget_us are counted, and
+ * periodic_jobs_report() names the jobs that should go back to a task:
+ *   [PJOB] 5 jobs, 10 s: 31 runs in 19 service wakeups (12 shared)
+ *   [PJOB]   blink1   period 500 ms runs=20 avg 6 max 11 us
+ *   [PJOB]   slowlog  period 1000 ms runs=10 avg 850 max 1310 us over=10 -> move to a task
+ *   (illustrative)
+ */
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/timers.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef PERIODIC_JOBS_MAX
+#define PERIODIC_JOBS_MAX 16
+#endif
+
+typedef void (*periodic_job_cb_t)(void *arg);
+
+/**
+ * @brief Job description; zero fields take the defaults in brackets.
+ */
+typedef struct {
+    const char *name;
+    uint32_t period_ms;
+    periodic_job_cb_t cb;           //!< Runs in the timer service task; must not block
+    void *arg;
+    uint32_t budget_us;             //!< Longer runs are counted as over budget [200]
+} periodic_job_config_t;
+
+/**
+ * @brief Job object; all fields are private.
+ */
+typedef struct {
+    periodic_job_config_t cfg;
+    StaticTimer_t timer_buf;
+    TimerHandle_t timer;
+    uint32_t runs;
+    uint32_t over_budget;
+    uint32_t max_us;
+    uint64_t busy_us;
+} periodic_job_t;
+
+/** @brief Totals over all registered jobs. */
+typedef struct {
+    uint32_t jobs;
+    uint32_t runs;
+    uint32_t wakeups;               //!< Service-task wakeups that ran at least one job
+    uint32_t over_budget;
+    uint64_t elapsed_us;            //!< Since the first job was started or the last reset
+} periodic_jobs_stats_t;
+
+/**
+ * @brief Create the job's static timer and start it; the first run is one period from now.
+ *
+ * @param wait Ticks to wait for room in the timer command queue.
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM (all job slots used),
+ *         ESP_ERR_TIMEOUT (command queue full).
+ */
+esp_err_t periodic_job_start(periodic_job_t *job, const periodic_job_config_t *cfg, TickType_t wait);
+
+/**
+ * @brief Stop and delete the job's timer and unregister it.
+ *
+ * The callback may still be running once when this returns from another task.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if not started, ESP_ERR_TIMEOUT.
+ */
+esp_err_t periodic_job_stop(periodic_job_t *job, TickType_t wait);
+
+/**
+ * @brief Copy the totals; optionally reset them and every job's counters.
+ */
+void periodic_jobs_get_stats(periodic_jobs_stats_t *out, bool reset);
+
+/**
+ * @brief Print the totals and one [PJOB] line per job, then reset the counters.
+ */
+void periodic_jobs_report(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,224 @@
+/**
+ * @file queue_batch.c
+ * @brief Batched fixed-size item queue (see queue_batch.h).
+ *
+ * All ring state is guarded by one spinlock. A waiting task records itself
+ * in rx_waiter/tx_waiter while holding the lock, and the other side clears
+ * the field and notifies it after releasing the lock. Because a notification
+ * stays pending until taken, a wakeup that lands between the unlock and the
+ * ulTaskNotifyTake() call is never lost.
+ */
+
+#include <string.h>
+#include "queue_batch.h"
+
+// ------------------------ Helpers ------------------------
+
+/**
+ * @brief Copy @p n items into the ring at head (caller holds the lock).
+ */
+static void ring_put(queue_batch_t *q, const uint8_t *src, UBaseType_t n)
+{
+    UBaseType_t first = q->capacity - q->head;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(q->storage + q->head * q->item_size, src, first * q->item_size);
+    memcpy(q->storage, src + first * q->item_size, (n - first) * q->item_size);
+
+    q->head = (q->head + n) % q->capacity;
+    q->count += n;
+}
+
+/**
+ * @brief Copy @p n items out of the ring at tail (caller holds the lock).
+ */
+static void ring_get(queue_batch_t *q, uint8_t *dst, UBaseType_t n)
+{
+    UBaseType_t first = q->capacity - q->tail;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(dst, q->storage + q->tail * q->item_size, first * q->item_size);
+    memcpy(dst + first * q->item_size, q->storage, (n - first) * q->item_size);
+
+    q->tail = (q->tail + n) % q->capacity;
+    q->count -= n;
+}
+
+/**
+ * @brief Forget a waiter registration after a timeout (caller holds the lock).
+ */
+static inline void drop_waiter(TaskHandle_t *slot)
+{
+    if (*slot == xTaskGetCurrentTaskHandle()) {
+        *slot = NULL;
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t queue_batch_init(queue_batch_t *queue)
+{
+    if (queue == NULL || queue->storage == NULL || queue->capacity == 0 || queue->item_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    portENTER_CRITICAL(&queue->lock);
+    queue->head = 0;
+    queue->tail = 0;
+    queue->count = 0;
+    if (queue->trigger_level == 0) {
+        queue->trigger_level = 1;
+    }
+    queue->rx_waiter = NULL;
+    queue->tx_waiter = NULL;
+    memset(&queue->stats, 0, sizeof(queue->stats));
+    portEXIT_CRITICAL(&queue->lock);
+    return ESP_OK;
+}
+
+void queue_batch_set_trigger_level(queue_batch_t *queue, UBaseType_t items)
+{
+    if (items == 0) {
+        items = 1;
+    }
+    if (items > queue->capacity) {
+        items = queue->capacity;
+    }
+    portENTER_CRITICAL(&queue->lock);
+    queue->trigger_level = items;
+    portEXIT_CRITICAL(&queue->lock);
+}
+
+UBaseType_t queue_send_batch(queue_batch_t *queue, const void *items, UBaseType_t count, TickType_t max_wait)
+{
+    const uint8_t *src = (const uint8_t *)items;
+    UBaseType_t sent = 0;
+    TimeOut_t timeout;
+    TickType_t remaining = max_wait;
+
+    vTaskSetTimeOutState(&timeout);
+
+    for (;;) {
+        TaskHandle_t wake = NULL;
+        bool parked = false;
+
+        portENTER_CRITICAL(&queue->lock);
+        UBaseType_t n = queue->capacity - queue->count;
+        if (n > count - sent) {
+            n = count - sent;
+        }
+        if (n > 0) {
+            ring_put(queue, src + sent * queue->item_size, n);
+            sent += n;
+            queue->stats.items_sent += n;
+            if (queue->count > queue->stats.high_watermark) {
+                queue->stats.high_watermark = queue->count;
+            }
+            if (queue->rx_waiter != NULL && queue->count >= queue->rx_wanted) {
+                wake = queue->rx_waiter;
+                queue->rx_waiter = NULL;
+            }
+        }
+        if (sent < count && remaining > 0 &&
+            (queue->tx_waiter == NULL || queue->tx_waiter == xTaskGetCurrentTaskHandle())) {
+            queue->tx_waiter = xTaskGetCurrentTaskHandle();
+            queue->stats.tx_blocks++;
+            parked = true;
+        }
+        portEXIT_CRITICAL(&queue->lock);
+
+        if (wake != NULL) {
+            xTaskNotifyGiveIndexed(wake, QUEUE_BATCH_NOTIFY_INDEX);
+        }
+        if (sent == count || remaining == 0) {
+            return sent;
+        }
+
+        if (parked) {
+            ulTaskNotifyTakeIndexed(QUEUE_BATCH_NOTIFY_INDEX, pdTRUE, remaining);
+        } else {
+            vTaskDelay(1);      // Another sender owns the wait slot; poll
+        }
+
+        if (xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            remaining = 0;      // One last non-blocking attempt
+            portENTER_CRITICAL(&queue->lock);
+            drop_waiter(&queue->tx_waiter);
+            portEXIT_CRITICAL(&queue->lock);
+        }
+    }
+}
+
+UBaseType_t queue_receive_batch(queue_batch_t *queue, void *items, UBaseType_t max_items, TickType_t max_wait)
+{
+    uint8_t *dst = (uint8_t *)items;
+    TimeOut_t timeout;
+    TickType_t remaining = max_wait;
+    bool woken = false;
+
+    if (max_items == 0) {
+        return 0;
+    }
+    vTaskSetTimeOutState(&timeout);
+
+    for (;;) {
+        TaskHandle_t wake = NULL;
+        UBaseType_t n = 0;
+        UBaseType_t wanted = queue->trigger_level < max_items ? queue->trigger_level : max_items;
+
+        portENTER_CRITICAL(&queue->lock);
+        if (woken) {
+            queue->stats.rx_wakeups++;
+            woken = false;
+        }
+        if (queue->count >= wanted || (remaining == 0 && queue->count > 0)) {
+            n = queue->count < max_items ? queue->count : max_items;
+            ring_get(queue, dst, n);
+            queue->stats.items_received += n;
+            queue->stats.rx_batches++;
+            wake = queue->tx_waiter;
+            queue->tx_waiter = NULL;
+        } else if (remaining > 0) {
+            queue->rx_waiter = xTaskGetCurrentTaskHandle();
+            queue->rx_wanted = wanted;
+        }
+        portEXIT_CRITICAL(&queue->lock);
+
+        if (wake != NULL) {
+            xTaskNotifyGiveIndexed(wake, QUEUE_BATCH_NOTIFY_INDEX);
+        }
+        if (n > 0 || remaining == 0) {
+            return n;
+        }
+
+        woken = ulTaskNotifyTakeIndexed(QUEUE_BATCH_NOTIFY_INDEX, pdTRUE, remaining) != 0;
+
+        if (xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            remaining = 0;      // Return whatever is waiting now
+            portENTER_CRITICAL(&queue->lock);
+            drop_waiter(&queue->rx_waiter);
+            portEXIT_CRITICAL(&queue->lock);
+        }
+    }
+}
+
+UBaseType_t queue_batch_waiting(queue_batch_t *queue)
+{
+    portENTER_CRITICAL(&queue->lock);
+    UBaseType_t n = queue->count;
+    portEXIT_CRITICAL(&queue->lock);
+    return n;
+}
+
+void queue_batch_get_stats(queue_batch_t *queue, queue_batch_stats_t *out, bool reset)
+{
+    portENTER_CRITICAL(&queue->lock);
+    *out = queue->stats;
+    if (reset) {
+        memset(&queue->stats, 0, sizeof(queue->stats));
+        queue->stats.high_watermark = queue->count;
+    }
+    portEXIT_CRITICAL(&queue->lock);
+}
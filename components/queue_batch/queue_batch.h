@@ -0,0 +1,150 @@
+/**
+ * @file queue_batch.h
+ * @brief Fixed-size item queue with batched send/receive and a drain budget.
+ *
+ * A FreeRTOS queue takes its critical section, and may wake the receiver,
+ * for every single item. Under a 10 kHz event load that means 10 000
+ * wakeups per second for the consumer. queue_batch_t moves up to N items
+ * per call with one critical section per batch. It also has a trigger level
+ * (like xStreamBufferSetTriggerLevel()): a blocked receiver is only woken
+ * once that many items are waiting or its max_wait expires, so one wakeup
+ * drains a whole batch.
+ *
+ * Rules:
+ *   - Any number of tasks may send; one task at a time may receive.
+ *   - Only one sender at a time is parked waiting for space. Other senders
+ *     that find the queue full poll once per tick until their wait expires.
+ *   - Items are copied inside the critical section, so keep them small
+ *     (events, indices, or pool_buf_t pointers from buffer_pool.h).
+ *   - Blocking uses direct-to-task notification index
+ *     QUEUE_BATCH_NOTIFY_INDEX. Do not use that index for anything else in
+ *     tasks that block on the queue.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef QUEUE_BATCH_NOTIFY_INDEX
+#define QUEUE_BATCH_NOTIFY_INDEX 0
+#endif
+
+/**
+ * @brief Counters kept by the queue (read with queue_batch_get_stats()).
+ */
+typedef struct {
+    uint32_t items_sent;        //!< Items accepted by queue_send_batch()
+    uint32_t items_received;    //!< Items returned by queue_receive_batch()
+    uint32_t rx_batches;        //!< Non-empty queue_receive_batch() returns
+    uint32_t rx_wakeups;        //!< Times the receiver blocked and was woken
+    uint32_t tx_blocks;         //!< Times a sender blocked on a full queue
+    UBaseType_t high_watermark; //!< Largest item count ever seen
+} queue_batch_stats_t;
+
+/**
+ * @brief Batched queue; declare instances with QUEUE_BATCH_DEFINE().
+ */
+typedef struct {
+    uint8_t *storage;           //!< Ring storage (capacity * item_size bytes)
+    size_t item_size;           //!< Bytes per item
+    UBaseType_t capacity;       //!< Maximum number of items
+    UBaseType_t head;           //!< Next slot to write
+    UBaseType_t tail;           //!< Next slot to read
+    UBaseType_t count;          //!< Items currently stored
+    UBaseType_t trigger_level;  //!< Items needed to wake a blocked receiver
+    TaskHandle_t rx_waiter;     //!< Receiver blocked on empty/below-trigger
+    UBaseType_t rx_wanted;      //!< Items that wake rx_waiter
+    TaskHandle_t tx_waiter;     //!< Sender blocked on full
+    portMUX_TYPE lock;
+    queue_batch_stats_t stats;
+} queue_batch_t;
+
+/**
+ * @brief Define a statically allocated batched queue named @p name.
+ *
+ * @param name   Identifier of the queue_batch_t object.
+ * @param length Maximum number of items.
+ * @param size   Bytes per item.
+ */
+#define QUEUE_BATCH_DEFINE(name, length, size)                                          \
+    static uint8_t name##_storage[(length) * (size)] __attribute__((aligned(4)));       \
+    static queue_batch_t name = {                                                       \
+        .storage = name##_storage,                                                      \
+        .item_size = (size),                                                            \
+        .capacity = (length),                                                           \
+        .trigger_level = 1,                                                             \
+        .lock = portMUX_INITIALIZER_UNLOCKED,                                           \
+    }
+
+/**
+ * @brief Reset the queue to empty and clear its statistics.
+ *
+ * @param queue Queue declared with QUEUE_BATCH_DEFINE().
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG on a malformed queue.
+ */
+esp_err_t queue_batch_init(queue_batch_t *queue);
+
+/**
+ * @brief Set how many items must be waiting before a blocked receiver is woken.
+ *
+ * A receiver asking for fewer items than the trigger level is woken as soon
+ * as its own max_items are available.
+ *
+ * @param queue Queue to configure.
+ * @param items Trigger level, clamped to [1, capacity].
+ */
+void queue_batch_set_trigger_level(queue_batch_t *queue, UBaseType_t items);
+
+/**
+ * @brief Copy up to @p count items into the queue.
+ *
+ * Copies as many items as fit in one critical section, then blocks for
+ * space until all items are sent or @p max_wait expires.
+ *
+ * @param queue    Destination queue.
+ * @param items    Array of @p count items of queue->item_size bytes.
+ * @param count    Number of items to send.
+ * @param max_wait Ticks to wait for space in total.
+ * @return Number of items actually sent (0..count).
+ */
+UBaseType_t queue_send_batch(queue_batch_t *queue, const void *items, UBaseType_t count, TickType_t max_wait);
+
+/**
+ * @brief Drain up to @p max_items items with one critical section.
+ *
+ * Returns immediately if at least min(trigger_level, max_items) items are
+ * waiting. Otherwise it blocks until that many arrive or @p max_wait
+ * expires. On timeout it returns whatever is waiting, which may be zero.
+ *
+ * @param queue     Source queue.
+ * @param items     Output array with room for @p max_items items.
+ * @param max_items Drain budget for this call.
+ * @param max_wait  Ticks to wait for a batch.
+ * @return Number of items received (0..max_items).
+ */
+UBaseType_t queue_receive_batch(queue_batch_t *queue, void *items, UBaseType_t max_items, TickType_t max_wait);
+
+/**
+ * @brief Number of items currently waiting.
+ */
+UBaseType_t queue_batch_waiting(queue_batch_t *queue);
+
+/**
+ * @brief Take a consistent snapshot of the queue counters.
+ *
+ * @param queue Queue to read.
+ * @param out   Destination for the snapshot.
+ * @param reset Clear the counters after reading when true.
+ */
+void queue_batch_get_stats(queue_batch_t *queue, queue_batch_stats_t *out, bool reset);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file queue_telemetry.c
+ * @brief Instrumented FreeRTOS queue (see queue_telemetry.h).
+ */
+
+#include <string.h>
+#include "esp_timer.h"
+#include "queue_telemetry.h"
+
+/**
+ * @brief Envelope stored in the underlying queue: timestamp, then the user item.
+ *
+ * Only QUEUE_TELEMETRY_SLOT_SIZE(item_size) bytes of it are copied by the queue.
+ */
+typedef struct {
+    int64_t t_enqueue_us;
+    uint8_t payload[QUEUE_TELEMETRY_MAX_ITEM_SIZE];
+} envelope_t;
+
+// ------------------------ Helpers ------------------------
+
+/**
+ * @brief log2 bucket for a latency: 0 for 0 us, b for [2^(b-1), 2^b) us.
+ */
+static inline unsigned latency_bucket(uint32_t us)
+{
+    unsigned b = (us == 0) ? 0 : 32u - (unsigned)__builtin_clz(us);
+    return b < QUEUE_TELEMETRY_BUCKETS ? b : QUEUE_TELEMETRY_BUCKETS - 1;
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t queue_telemetry_init(queue_telemetry_t *q)
+{
+    if (q == NULL || q->storage == NULL || q->length == 0 ||
+        q->item_size == 0 || q->item_size > QUEUE_TELEMETRY_MAX_ITEM_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (q->handle != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    memset(&q->counters, 0, sizeof(q->counters));
+    q->handle = xQueueCreateStatic(q->length, QUEUE_TELEMETRY_SLOT_SIZE(q->item_size),
+                                   q->storage, &q->queue_buf);
+    return ESP_OK;
+}
+
+BaseType_t queue_telemetry_send(queue_telemetry_t *q, const void *item, TickType_t wait)
+{
+    envelope_t env;
+
+    memcpy(env.payload, item, q->item_size);
+    env.t_enqueue_us = esp_timer_get_time();
+
+    if (xQueueSend(q->handle, &env, wait) != pdPASS) {
+        portENTER_CRITICAL(&q->lock);
+        q->counters.full_timeouts++;
+        portEXIT_CRITICAL(&q->lock);
+        return errQUEUE_FULL;
+    }
+
+    UBaseType_t waiting = uxQueueMessagesWaiting(q->handle);
+    portENTER_CRITICAL(&q->lock);
+    q->counters.sent++;
+    if (waiting > q->counters.high_watermark) {
+        q->counters.high_watermark = waiting;
+    }
+    portEXIT_CRITICAL(&q->lock);
+    return pdPASS;
+}
+
+BaseType_t queue_telemetry_receive(queue_telemetry_t *q, void *item, TickType_t wait)
+{
+    envelope_t env;
+
+    if (xQueueReceive(q->handle, &env, wait) != pdPASS) {
+        portENTER_CRITICAL(&q->lock);
+        q->counters.empty_timeouts++;
+        portEXIT_CRITICAL(&q->lock);
+        return pdFAIL;
+    }
+
+    int64_t latency = esp_timer_get_time() - env.t_enqueue_us;
+    uint32_t us = latency > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)latency;
+    memcpy(item, env.payload, q->item_size);
+
+    portENTER_CRITICAL(&q->lock);
+    q->counters.received++;
+    q->counters.latency_sum_us += us;
+    if (us > q->counters.latency_max_us) {
+        q->counters.latency_max_us = us;
+    }
+    q->counters.latency_hist[latency_bucket(us)]++;
+    portEXIT_CRITICAL(&q->lock);
+    return pdPASS;
+}
+
+uint32_t queue_telemetry_percentile(const uint32_t *hist, uint32_t total, uint32_t pct)
+{
+    if (total == 0) {
+        return 0;
+    }
+    // Rank of the sample at the requested percentile (1-based, rounded up).
+    uint64_t rank = ((uint64_t)total * pct + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (unsigned b = 0; b < QUEUE_TELEMETRY_BUCKETS; b++) {
+        seen += hist[b];
+        if (seen >= rank) {
+            return (uint32_t)((1ull << b) - 1);     // Top of [2^(b-1), 2^b)
+        }
+    }
+    return UINT32_MAX;
+}
+
+void queue_telemetry_snapshot(queue_telemetry_t *q, queue_telemetry_report_t *out, bool reset)
+{
+    queue_telemetry_counters_t c;
+    UBaseType_t waiting = uxQueueMessagesWaiting(q->handle);
+
+    portENTER_CRITICAL(&q->lock);
+    c = q->counters;
+    if (reset) {
+        memset(&q->counters, 0, sizeof(q->counters));
+        q->counters.high_watermark = waiting;
+    }
+    portEXIT_CRITICAL(&q->lock);
+
+    out->sent = c.sent;
+    out->received = c.received;
+    out->full_timeouts = c.full_timeouts;
+    out->empty_timeouts = c.empty_timeouts;
+    out->waiting = waiting;
+    out->high_watermark = c.high_watermark;
+    out->length = q->length;
+    out->p50_us = queue_telemetry_percentile(c.latency_hist, c.received, 50);
+    out->p99_us = queue_telemetry_percentile(c.latency_hist, c.received, 99);
+    out->max_us = c.latency_max_us;
+    out->mean_us = c.received ? (uint32_t)(c.latency_sum_us / c.received) : 0;
+}
@@ -0,0 +1,150 @@
+/**
+ * @file queue_telemetry.h
+ * @brief Instrumented FreeRTOS queue: occupancy, timeouts and enqueue-to-dequeue latency.
+ *
+ * Polling uxQueueMessagesWaiting() once a second misses every burst between
+ * polls. queue_telemetry_t wraps a static FreeRTOS queue and measures on
+ * every operation instead:
+ *   - high watermark of waiting items (sampled after every send)
+ *   - number of sends that timed out on a full queue
+ *   - number of receives that timed out on an empty queue
+ *   - per-item enqueue-to-dequeue latency from esp_timer_get_time(), binned
+ *     into a log2 histogram (bucket b counts latencies in [2^(b-1), 2^b) us)
+ *
+ * The counters are running aggregates, so a monitor task can print
+ * p50/p99/max once a second without any per-sample output.
+ *
+ * Each queued item carries an extra 8-byte timestamp, so the items are
+ * limited to QUEUE_TELEMETRY_MAX_ITEM_SIZE bytes. The envelope is built on
+ * the caller's stack.
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef QUEUE_TELEMETRY_MAX_ITEM_SIZE
+#define QUEUE_TELEMETRY_MAX_ITEM_SIZE 64
+#endif
+
+#define QUEUE_TELEMETRY_BUCKETS 32      //!< Covers latencies up to 2^31 us
+
+/**
+ * @brief Running counters; snapshot them with queue_telemetry_snapshot().
+ */
+typedef struct {
+    uint32_t sent;                  //!< Successful sends
+    uint32_t received;              //!< Successful receives
+    uint32_t full_timeouts;         //!< Sends that gave up on a full queue
+    uint32_t empty_timeouts;        //!< Receives that gave up on an empty queue
+    UBaseType_t high_watermark;     //!< Most items ever waiting at once
+    uint32_t latency_max_us;        //!< Longest enqueue-to-dequeue latency
+    uint64_t latency_sum_us;        //!< Sum of latencies (for the mean)
+    uint32_t latency_hist[QUEUE_TELEMETRY_BUCKETS]; //!< log2(us) histogram
+} queue_telemetry_counters_t;
+
+/**
+ * @brief Digest of the counters for printing.
+ */
+typedef struct {
+    uint32_t sent;
+    uint32_t received;
+    uint32_t full_timeouts;
+    uint32_t empty_timeouts;
+    UBaseType_t waiting;            //!< Items waiting at snapshot time
+    UBaseType_t high_watermark;
+    UBaseType_t length;             //!< Queue depth
+    uint32_t p50_us;                //!< Upper bound of the bucket holding p50
+    uint32_t p99_us;                //!< Upper bound of the bucket holding p99
+    uint32_t max_us;
+    uint32_t mean_us;
+} queue_telemetry_report_t;
+
+/**
+ * @brief Instrumented queue; declare instances with QUEUE_TELEMETRY_DEFINE().
+ */
+typedef struct {
+    uint8_t *storage;
+    UBaseType_t length;
+    size_t item_size;               //!< User item size (without the envelope)
+    StaticQueue_t queue_buf;
+    QueueHandle_t handle;
+    portMUX_TYPE lock;
+    queue_telemetry_counters_t counters;
+} queue_telemetry_t;
+
+/** @brief Bytes per queue slot for a user item of @p size bytes. */
+#define QUEUE_TELEMETRY_SLOT_SIZE(size) (sizeof(int64_t) + (size))
+
+/**
+ * @brief Define a statically allocated instrumented queue named @p name.
+ *
+ * @param name   Identifier of the queue_telemetry_t object.
+ * @param depth  Queue length in items.
+ * @param size   Bytes per user item (<= QUEUE_TELEMETRY_MAX_ITEM_SIZE).
+ */
+#define QUEUE_TELEMETRY_DEFINE(name, depth, size)                                       \
+    _Static_assert((size) <= QUEUE_TELEMETRY_MAX_ITEM_SIZE,                             \
+                   #name ": item larger than QUEUE_TELEMETRY_MAX_ITEM_SIZE");           \
+    static uint8_t name##_storage[(depth) * QUEUE_TELEMETRY_SLOT_SIZE(size)]            \
+        __attribute__((aligned(8)));                                                    \
+    static queue_telemetry_t name = {                                                   \
+        .storage = name##_storage,                                                      \
+        .length = (depth),                                                              \
+        .item_size = (size),                                                            \
+        .lock = portMUX_INITIALIZER_UNLOCKED,                                           \
+    }
+
+/**
+ * @brief Create the underlying queue and clear the counters.
+ *
+ * @param q Queue declared with QUEUE_TELEMETRY_DEFINE().
+ * @return ESP_OK, ESP_ERR_INVALID_ARG on a malformed queue, or
+ *         ESP_ERR_INVALID_STATE if it is already initialized.
+ */
+esp_err_t queue_telemetry_init(queue_telemetry_t *q);
+
+/**
+ * @brief Timestamp and enqueue one item (same semantics as xQueueSend()).
+ *
+ * @return pdPASS, or errQUEUE_FULL after @p wait ticks (counted as a full timeout).
+ */
+BaseType_t queue_telemetry_send(queue_telemetry_t *q, const void *item, TickType_t wait);
+
+/**
+ * @brief Dequeue one item and record its latency (same semantics as xQueueReceive()).
+ *
+ * @return pdPASS, or pdFAIL after @p wait ticks (counted as an empty timeout).
+ */
+BaseType_t queue_telemetry_receive(queue_telemetry_t *q, void *item, TickType_t wait);
+
+/**
+ * @brief Summarize the counters; optionally start a new measurement window.
+ *
+ * @param q      Queue to read.
+ * @param out    Destination digest.
+ * @param reset  Clear all counters after reading when true. The high
+ *               watermark restarts from the current occupancy.
+ */
+void queue_telemetry_snapshot(queue_telemetry_t *q, queue_telemetry_report_t *out, bool reset);
+
+/**
+ * @brief Upper bound (us) of the histogram bucket containing percentile @p pct.
+ *
+ * @param hist  log2 latency histogram with QUEUE_TELEMETRY_BUCKETS entries.
+ * @param total Number of samples in the histogram.
+ * @param pct   Percentile, 0..100.
+ * @return Latency bound in microseconds, 0 if there are no samples.
+ */
+uint32_t queue_telemetry_percentile(const uint32_t *hist, uint32_t total, uint32_t pct);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file spsc_ring.c
+ * @brief Lock-free SPSC ring buffer (see spsc_ring.h).
+ *
+ * Wakeup protocol (no lost wakeups, no lock):
+ *   producer: store head (release); seq_cst fence; load tail
+ *             -> if tail equals the slot just written, the ring was empty
+ *                and the consumer may be asleep: notify it.
+ *   consumer: store tail (release); seq_cst fence; load head
+ *             -> only block if the ring is still empty.
+ * With both fences, at least one side always sees the other's store, so
+ * either the producer notifies or the consumer sees the new item and does
+ * not block. A spare notification only costs one extra empty loop.
+ */
+
+#include <string.h>
+#include "spsc_ring.h"
+
+esp_err_t spsc_ring_init(spsc_ring_t *ring, TaskHandle_t consumer)
+{
+    if (ring == NULL || ring->storage == NULL || ring->item_size == 0 ||
+        ring->mask == 0 || (ring->mask & (ring->mask + 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    atomic_store_explicit(&ring->head, 0, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, 0, memory_order_relaxed);
+    ring->notifications = 0;
+    ring->full_rejects = 0;
+    ring->wakeups = 0;
+    ring->consumer = consumer;
+    atomic_thread_fence(memory_order_seq_cst);
+    return ESP_OK;
+}
+
+bool spsc_ring_push(spsc_ring_t *ring, const void *item)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t next = (head + 1) & ring->mask;
+
+    if (next == atomic_load_explicit(&ring->tail, memory_order_acquire)) {
+        ring->full_rejects++;
+        return false;
+    }
+
+    memcpy(ring->storage + head * ring->item_size, item, ring->item_size);
+    atomic_store_explicit(&ring->head, next, memory_order_release);
+
+    if (ring->consumer != NULL) {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&ring->tail, memory_order_relaxed) == head) {
+            ring->notifications++;
+            xTaskNotifyGiveIndexed(ring->consumer, SPSC_RING_NOTIFY_INDEX);
+        }
+    }
+    return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t *ring, void *item)
+{
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+
+    if (tail == atomic_load_explicit(&ring->head, memory_order_acquire)) {
+        return false;
+    }
+
+    memcpy(item, ring->storage + tail * ring->item_size, ring->item_size);
+    atomic_store_explicit(&ring->tail, (tail + 1) & ring->mask, memory_order_release);
+    return true;
+}
+
+bool spsc_ring_receive(spsc_ring_t *ring, void *item, TickType_t wait)
+{
+    TimeOut_t timeout;
+    TickType_t remaining = wait;
+
+    vTaskSetTimeOutState(&timeout);
+
+    for (;;) {
+        if (spsc_ring_pop(ring, item)) {
+            return true;
+        }
+        if (remaining == 0) {
+            return false;
+        }
+
+        // Re-check after a full fence so a concurrent push is either seen
+        // here or sees our tail and sends a notification.
+        atomic_thread_fence(memory_order_seq_cst);
+        if (atomic_load_explicit(&ring->head, memory_order_relaxed) !=
+            atomic_load_explicit(&ring->tail, memory_order_relaxed)) {
+            continue;
+        }
+
+        if (ulTaskNotifyTakeIndexed(SPSC_RING_NOTIFY_INDEX, pdTRUE, remaining) != 0) {
+            ring->wakeups++;
+        }
+        if (xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            remaining = 0;      // One last non-blocking attempt
+        }
+    }
+}
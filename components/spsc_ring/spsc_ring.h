@@ -0,0 +1,134 @@
+/**
+ * @file spsc_ring.h
+ * @brief Lock-free single-producer/single-consumer ring buffer for cross-core transfer.
+ *
+ * Every xQueue* call takes the queue's spinlock, and on the dual-core ESP32
+ * that lock is shared by both cores. spsc_ring_t removes it. The producer
+ * is the only writer of head and the consumer is the only writer of tail,
+ * so both sides only need atomic loads and stores of their own index. The
+ * two indices sit on separate cache lines so the cores don't fight over
+ * one line on targets that have a data cache.
+ *
+ * The consumer may block in spsc_ring_receive(). The producer only sends a
+ * direct-to-task notification when it sees the ring go from empty to
+ * non-empty, so a busy stream costs no kernel calls at all.
+ *
+ * Rules:
+ *   - Exactly one producer task and one consumer task (they may be on
+ *     different cores). Neither side may be called from an ISR.
+ *   - The capacity must be a power of two. One slot is never used, so the
+ *     ring holds capacity - 1 items.
+ *   - The consumer blocks on notification index SPSC_RING_NOTIFY_INDEX.
+ */
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SPSC_RING_CACHE_LINE
+#define SPSC_RING_CACHE_LINE 64     // Covers the 32/64-byte lines of ESP32-S3/P4
+#endif
+
+#ifndef SPSC_RING_NOTIFY_INDEX
+#define SPSC_RING_NOTIFY_INDEX 0
+#endif
+
+/**
+ * @brief Ring control block; declare instances with SPSC_RING_DEFINE().
+ */
+typedef struct {
+    // Producer-owned line
+    _Alignas(SPSC_RING_CACHE_LINE) atomic_uint head;    //!< Next slot to write
+    uint32_t notifications;     //!< Empty->non-empty wakeups sent (producer only)
+    uint32_t full_rejects;      //!< Pushes refused because the ring was full
+
+    // Consumer-owned line
+    _Alignas(SPSC_RING_CACHE_LINE) atomic_uint tail;    //!< Next slot to read
+    uint32_t wakeups;           //!< Times the consumer blocked and was woken
+
+    // Read-only after init
+    _Alignas(SPSC_RING_CACHE_LINE) uint8_t *storage;
+    size_t item_size;
+    uint32_t mask;              //!< capacity - 1
+    TaskHandle_t consumer;      //!< Task woken on empty->non-empty
+} spsc_ring_t;
+
+/**
+ * @brief Define a statically allocated ring named @p name.
+ *
+ * @param name     Identifier of the spsc_ring_t object.
+ * @param capacity Number of slots, a power of two (holds capacity - 1 items).
+ * @param size     Bytes per item.
+ */
+#define SPSC_RING_DEFINE(name, capacity, size)                                          \
+    _Static_assert(((capacity) & ((capacity) - 1)) == 0 && (capacity) >= 2,             \
+                   #name ": capacity must be a power of two");                          \
+    static uint8_t name##_storage[(capacity) * (size)]                                  \
+        __attribute__((aligned(SPSC_RING_CACHE_LINE)));                                 \
+    static spsc_ring_t name = {                                                         \
+        .storage = name##_storage,                                                      \
+        .item_size = (size),                                                            \
+        .mask = (capacity) - 1,                                                         \
+    }
+
+/**
+ * @brief Reset the ring and bind the consumer task.
+ *
+ * Call before either side starts using the ring.
+ *
+ * @param ring     Ring declared with SPSC_RING_DEFINE().
+ * @param consumer Task that calls spsc_ring_receive(), or NULL if the
+ *                 consumer only polls with spsc_ring_pop().
+ * @return ESP_OK, or ESP_ERR_INVALID_ARG on a malformed ring.
+ */
+esp_err_t spsc_ring_init(spsc_ring_t *ring, TaskHandle_t consumer);
+
+/**
+ * @brief Producer: copy one item into the ring without blocking.
+ *
+ * @param ring Ring to write.
+ * @param item Item of ring->item_size bytes.
+ * @return true if stored, false if the ring is full.
+ */
+bool spsc_ring_push(spsc_ring_t *ring, const void *item);
+
+/**
+ * @brief Consumer: copy one item out of the ring without blocking.
+ *
+ * @param ring Ring to read.
+ * @param item Destination of ring->item_size bytes.
+ * @return true if an item was read, false if the ring is empty.
+ */
+bool spsc_ring_pop(spsc_ring_t *ring, void *item);
+
+/**
+ * @brief Consumer: read one item, blocking on a task notification while empty.
+ *
+ * @param ring Ring to read (bound to the calling task by spsc_ring_init()).
+ * @param item Destination of ring->item_size bytes.
+ * @param wait Ticks to wait for an item.
+ * @return true if an item was read, false on timeout.
+ */
+bool spsc_ring_receive(spsc_ring_t *ring, void *item, TickType_t wait);
+
+/**
+ * @brief Approximate number of items in the ring (exact from either owner task).
+ */
+static inline uint32_t spsc_ring_count(spsc_ring_t *ring)
+{
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    return (head - tail) & ring->mask;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,260 @@
+/**
+ * @file stack_profiler.c
+ * @brief Soak-run stack profiler (see stack_profiler.h).
+ *
+ * All records are owned by the sampler task. Other tasks only register
+ * tables (under s_lock) and send report requests as notifications, so
+ * sampling and reporting never race.
+ */
+
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "stack_profiler.h"
+
+#if !configUSE_TRACE_FACILITY
+#error "stack_profiler needs CONFIG_FREERTOS_USE_TRACE_FACILITY=y (uxTaskGetSystemState)"
+#endif
+
+#define MAX_TABLES 4
+#define ROUND_TO   16
+
+/** @brief Worst case seen for one task. */
+typedef struct {
+    TaskHandle_t handle;
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t size;                  //!< Configured stack bytes, 0 if unknown
+    uint32_t min_free;              //!< Lowest high-water mark seen (bytes)
+    bool alive;                     //!< Present in the latest sample
+} profile_rec_t;
+
+typedef struct {
+    const task_factory_entry_t *table;
+    size_t count;
+} table_ref_t;
+
+static stack_profiler_config_t s_cfg;
+static TaskHandle_t s_sampler;
+static profile_rec_t s_recs[STACK_PROFILER_MAX_TASKS];
+static size_t s_nrecs;
+static TaskStatus_t s_status[STACK_PROFILER_MAX_TASKS];
+static table_ref_t s_tables[MAX_TABLES];
+static size_t s_ntables;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+static int64_t s_start_us;
+static uint32_t s_samples;
+static uint32_t s_overflowed;       //!< Tasks not tracked because s_recs was full
+
+// ------------------------ Helpers ------------------------
+
+/**
+ * @brief Configured stack size of a task, 0 if it cannot be determined.
+ */
+static uint32_t lookup_size(const TaskStatus_t *st)
+{
+    portENTER_CRITICAL(&s_lock);
+    for (size_t t = 0; t < s_ntables; t++) {
+        for (size_t i = 0; i < s_tables[t].count; i++) {
+            const task_factory_entry_t *e = &s_tables[t].table[i];
+            if (e->handle != NULL && *e->handle == st->xHandle) {
+                portEXIT_CRITICAL(&s_lock);
+                return e->stack_size;
+            }
+        }
+    }
+    portEXIT_CRITICAL(&s_lock);
+
+    // xTaskCreate*() stacks are one heap block starting at the stack base.
+    // The integrity check doubles as "is this address inside a heap at all".
+    if (st->pxStackBase != NULL &&
+        heap_caps_check_integrity_addr((intptr_t)st->pxStackBase, false)) {
+        return (uint32_t)heap_caps_get_allocated_size(st->pxStackBase);
+    }
+    return 0;
+}
+
+/**
+ * @brief Find or create the record for a sampled task.
+ */
+static profile_rec_t *record_for(const TaskStatus_t *st)
+{
+    for (size_t i = 0; i < s_nrecs; i++) {
+        // A handle can be reused by a later task, so match the name too
+        if (s_recs[i].handle == st->xHandle && strncmp(s_recs[i].name, st->pcTaskName, sizeof(s_recs[i].name)) == 0) {
+            return &s_recs[i];
+        }
+    }
+    if (s_nrecs == STACK_PROFILER_MAX_TASKS) {
+        return NULL;
+    }
+
+    profile_rec_t *r = &s_recs[s_nrecs++];
+    r->handle = st->xHandle;
+    snprintf(r->name, sizeof(r->name), "%s", st->pcTaskName);
+    r->size = lookup_size(st);
+    r->min_free = UINT32_MAX;
+    return r;
+}
+
+/**
+ * @brief Take one uxTaskGetSystemState() sample and update the worst cases.
+ */
+static void sample_once(void)
+{
+    UBaseType_t n = uxTaskGetSystemState(s_status, STACK_PROFILER_MAX_TASKS, NULL);
+    if (n == 0) {
+        s_overflowed = 1;           // More tasks than STACK_PROFILER_MAX_TASKS
+        return;
+    }
+
+    for (size_t i = 0; i < s_nrecs; i++) {
+        s_recs[i].alive = false;
+    }
+    for (UBaseType_t i = 0; i < n; i++) {
+        profile_rec_t *r = record_for(&s_status[i]);
+        if (r == NULL) {
+            s_overflowed = 1;
+            continue;
+        }
+        if (r->size == 0) {
+            r->size = lookup_size(&s_status[i]);    // Table may have been added late
+        }
+        r->alive = true;
+        // usStackHighWaterMark is in bytes in ESP-IDF
+        if (s_status[i].usStackHighWaterMark < r->min_free) {
+            r->min_free = s_status[i].usStackHighWaterMark;
+        }
+    }
+    s_samples++;
+}
+
+/**
+ * @brief Recommended depth for a peak usage of @p peak bytes.
+ */
+static uint32_t recommend(uint32_t peak)
+{
+    uint32_t margin = peak * s_cfg.margin_pct / 100;
+    if (margin < s_cfg.min_margin) {
+        margin = s_cfg.min_margin;
+    }
+    uint32_t depth = (peak + margin + ROUND_TO - 1) / ROUND_TO * ROUND_TO;
+    return depth < configMINIMAL_STACK_SIZE ? configMINIMAL_STACK_SIZE : depth;
+}
+
+/**
+ * @brief Print the table as a stack_profile.h header.
+ */
+static void print_report(void)
+{
+    char ident[configMAX_TASK_NAME_LEN];
+    uint32_t total_saved = 0;
+
+    printf("\n// ----- BEGIN stack_profile.h -----\n");
+    printf("// Generated by stack_profiler: %" PRIu32 " samples over %" PRIu32 " s, margin %" PRIu32 "%% (min %" PRIu32 " B)\n",
+           s_samples, (uint32_t)((esp_timer_get_time() - s_start_us) / 1000000),
+           s_cfg.margin_pct, s_cfg.min_margin);
+    printf("#pragma once\n");
+
+    for (size_t i = 0; i < s_nrecs; i++) {
+        const profile_rec_t *r = &s_recs[i];
+        size_t k;
+        for (k = 0; r->name[k] != '\0' && k < sizeof(ident) - 1; k++) {
+            ident[k] = isalnum((unsigned char)r->name[k]) ? (char)toupper((unsigned char)r->name[k]) : '_';
+        }
+        ident[k] = '\0';
+
+        if (r->size == 0 || r->min_free > r->size) {
+            printf("// %-24s size unknown, min free %" PRIu32 "%s\n", ident, r->min_free, r->alive ? "" : " (deleted)");
+            continue;
+        }
+        uint32_t peak = r->size - r->min_free;
+        uint32_t rec = recommend(peak);
+        int32_t saved = (int32_t)r->size - (int32_t)rec;
+        printf("#define STACK_PROFILE_%-24s %6" PRIu32 "    // size %" PRIu32 ", peak %" PRIu32 ", %s %" PRId32 "%s\n",
+               ident, rec, r->size, peak, saved >= 0 ? "saves" : "GROW BY", saved >= 0 ? saved : -saved,
+               r->alive ? "" : " (deleted)");
+        if (saved > 0) {
+            total_saved += (uint32_t)saved;
+        }
+    }
+    printf("// Total recoverable: %" PRIu32 " bytes%s\n", total_saved,
+           s_overflowed ? " (some tasks not tracked, raise STACK_PROFILER_MAX_TASKS)" : "");
+    printf("// ----- END stack_profile.h -----\n\n");
+}
+
+// ------------------------ Sampler task ------------------------
+
+/**
+ * @brief Sample on a fixed period; print on schedule or when notified.
+ *
+ * @param arg Unused.
+ */
+static void stack_profiler_task(void *arg)
+{
+    TickType_t last_report = xTaskGetTickCount();
+    const TickType_t report_ticks = (s_cfg.report_period_ms == UINT32_MAX) ? portMAX_DELAY
+                                                                           : pdMS_TO_TICKS(s_cfg.report_period_ms);
+
+    while (1) {
+        bool requested = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(s_cfg.sample_period_ms)) > 0;
+        sample_once();
+
+        if (requested || (report_ticks != portMAX_DELAY && xTaskGetTickCount() - last_report >= report_ticks)) {
+            print_report();
+            last_report = xTaskGetTickCount();
+        }
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t stack_profiler_start(const stack_profiler_config_t *cfg)
+{
+    if (s_sampler != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (cfg != NULL) {
+        s_cfg = *cfg;
+    }
+    s_cfg.sample_period_ms = s_cfg.sample_period_ms ? s_cfg.sample_period_ms : 100;
+    s_cfg.report_period_ms = s_cfg.report_period_ms ? s_cfg.report_period_ms : 60000;
+    s_cfg.margin_pct = s_cfg.margin_pct ? s_cfg.margin_pct : 25;
+    s_cfg.min_margin = s_cfg.min_margin ? s_cfg.min_margin : 256;
+    s_cfg.priority = s_cfg.priority ? s_cfg.priority : 1;
+    s_start_us = esp_timer_get_time();
+
+    // printf with this many columns needs a few KB; the sampler profiles itself too
+    if (xTaskCreate(stack_profiler_task, "stack_prof", 4096, NULL, s_cfg.priority, &s_sampler) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t stack_profiler_add_table(const task_factory_entry_t *table, size_t count)
+{
+    esp_err_t err = ESP_OK;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_ntables == MAX_TABLES) {
+        err = ESP_ERR_NO_MEM;
+    } else {
+        s_tables[s_ntables].table = table;
+        s_tables[s_ntables].count = count;
+        s_ntables++;
+    }
+    portEXIT_CRITICAL(&s_lock);
+    return err;
+}
+
+void stack_profiler_request_report(void)
+{
+    if (s_sampler != NULL) {
+        xTaskNotifyGive(s_sampler);
+    }
+}
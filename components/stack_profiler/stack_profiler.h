@@ -0,0 +1,85 @@
+/**
+ * @file stack_profiler.h
+ * @brief Soak-run stack profiler: worst-case stack use of every task and recommended depths.
+ *
+ * A low-priority task samples uxTaskGetSystemState() every sample_period_ms.
+ * For each task ever seen it keeps the lowest stack high-water mark: the
+ * fewest bytes that were never touched. On request, and every
+ * report_period_ms, it prints a table that is also a valid C header:
+ *
+ *   // ----- BEGIN stack_profile.h -----
+ *   #define STACK_PROFILE_SENSOR 1264      // size 4096, peak 1008, saves 2832
+ *   // ----- END stack_profile.h -----
+ *
+ * The recommended depth is peak + max(peak * margin_pct / 100, min_margin),
+ * rounded up to 16 bytes and never below configMINIMAL_STACK_SIZE. Paste the
+ * block into main/stack_profile.h. The task_factory tables read
+ * STACK_PROFILE_<NAME> when it is defined (see task_factory.h). <NAME> is
+ * the task name upper-cased with non-alphanumerics turned into '_'.
+ *
+ * Computing "peak" needs the configured stack size, which FreeRTOS does not
+ * keep. It is found in one of two ways:
+ *   - tasks from a task_factory table registered with stack_profiler_add_table()
+ *   - tasks created with xTaskCreate*(): the size of the heap block holding
+ *     the stack (heap_caps_get_allocated_size())
+ * Tasks with an unknown size (for example static system tasks) are listed
+ * as comments with their minimum free bytes only.
+ *
+ * The peak is only as good as the soak: run every path of the application,
+ * including error and reconnect paths, before trusting the table.
+ *
+ * Requires CONFIG_FREERTOS_USE_TRACE_FACILITY=y.
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "task_factory.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef STACK_PROFILER_MAX_TASKS
+#define STACK_PROFILER_MAX_TASKS 32
+#endif
+
+/**
+ * @brief Profiler settings; zero fields take the defaults in brackets.
+ */
+typedef struct {
+    uint32_t sample_period_ms;      //!< Sampling interval [100]
+    uint32_t report_period_ms;      //!< Automatic report interval, UINT32_MAX for never [60000]
+    uint32_t margin_pct;            //!< Safety margin in percent of the peak [25]
+    uint32_t min_margin;            //!< Minimum margin in bytes [256]
+    UBaseType_t priority;           //!< Sampler priority [1]
+} stack_profiler_config_t;
+
+/**
+ * @brief Start the sampler task.
+ *
+ * @param cfg Settings, or NULL for all defaults.
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already running, ESP_ERR_NO_MEM.
+ */
+esp_err_t stack_profiler_start(const stack_profiler_config_t *cfg);
+
+/**
+ * @brief Take configured stack sizes from a task_factory table.
+ *
+ * Call after task_factory_start() so the handles are filled in; up to four
+ * tables can be registered.
+ *
+ * @return ESP_OK or ESP_ERR_NO_MEM if the table slots are used up.
+ */
+esp_err_t stack_profiler_add_table(const task_factory_entry_t *table, size_t count);
+
+/**
+ * @brief Ask the sampler to print the table now (returns immediately).
+ */
+void stack_profiler_request_report(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,345 @@
+/**
+ * @file stream_pipeline.c
+ * @brief Stage tasks linked by message buffers (see stream_pipeline.h).
+ *
+ * A message buffer allows one reader and one writer at a time. Drop-oldest
+ * needs the writer to read too, so every reader of a link holds the link's
+ * rd_lock mutex, and reads never block while holding it. The next stage
+ * therefore does not block in xMessageBufferReceive(). It waits on the
+ * link's out_data semaphore, which the writer gives once per batch, and
+ * before it blocks on a full link. Then it drains with non-blocking reads
+ * under the lock. A writer blocked by PIPE_BLOCK is still woken by the
+ * message buffer itself when the reader frees space.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "esp_timer.h"
+#include "stream_pipeline.h"
+
+#ifndef PIPELINE_MAX_BATCH
+#define PIPELINE_MAX_BATCH 16
+#endif
+
+/** @brief Prepended to every frame in a link. */
+typedef struct {
+    int64_t t_origin;               //!< Source stage produced the data
+    int64_t t_enq;                  //!< Offered to this link
+} frame_hdr_t;
+
+#define HDR             sizeof(frame_hdr_t)
+#define MSG_LEN_BYTES   sizeof(size_t)  // Length prefix a message buffer stores per message
+#define SLOT_BYTES(max) ((HDR + (max) + 7) & ~(size_t)7)   // Keeps every batched header 8-byte aligned
+
+// ------------------------ Helpers ------------------------
+
+static void acc_max(uint32_t *max, int64_t v)
+{
+    if (v > (int64_t)*max) {
+        *max = (uint32_t)v;
+    }
+}
+
+/**
+ * @brief Write the frame in s->out_buf (payload @p len) to the output link per policy.
+ *
+ * @return true if the frame is in the link.
+ */
+static bool emit(pipeline_stage_t *s, size_t len, int64_t t_origin)
+{
+    frame_hdr_t *h = (frame_hdr_t *)s->out_buf;
+    size_t total = HDR + len;
+    uint32_t drops = 0;
+    int64_t blocked = 0;
+
+    h->t_origin = t_origin;
+    h->t_enq = esp_timer_get_time();
+    bool ok = xMessageBufferSend(s->out, s->out_buf, total, 0) == total;
+
+    if (!ok) {
+        switch (s->cfg.policy) {
+        case PIPE_BLOCK:
+            xSemaphoreGive(s->out_data);    // The reader must be awake to make room
+            ok = xMessageBufferSend(s->out, s->out_buf, total, portMAX_DELAY) == total;
+            blocked = esp_timer_get_time() - h->t_enq;
+            break;
+        case PIPE_DROP_NEWEST:
+            drops = 1;
+            break;
+        case PIPE_DROP_OLDEST:
+            xSemaphoreTake(s->out_rd_lock, portMAX_DELAY);
+            while (!ok && xMessageBufferReceive(s->out, s->drop_buf, HDR + s->cfg.max_frame, 0) > 0) {
+                drops++;
+                ok = xMessageBufferSend(s->out, s->out_buf, total, 0) == total;
+            }
+            xSemaphoreGive(s->out_rd_lock);
+            break;
+        }
+    }
+
+    size_t free_now = xMessageBufferSpacesAvailable(s->out);
+    portENTER_CRITICAL(&s->lock);
+    s->st.out += ok ? 1 : 0;
+    s->st.drops += drops;
+    s->st.blocked_us += (uint64_t)blocked;
+    if (free_now < s->st.link_min_free) {
+        s->st.link_min_free = free_now;
+    }
+    portEXIT_CRITICAL(&s->lock);
+    return ok;
+}
+
+// ------------------------ Stage tasks ------------------------
+
+/**
+ * @brief First stage: call fn `batch` times per period and emit what it returns.
+ */
+static void source_loop(pipeline_stage_t *s)
+{
+    TickType_t period = pdMS_TO_TICKS(s->cfg.period_ms);
+    TickType_t last = xTaskGetTickCount();
+
+    while (1) {
+        if (s->cfg.period_ms) {
+            vTaskDelayUntil(&last, period ? period : 1);
+        }
+        bool emitted = false;
+        uint64_t busy = 0;
+        for (uint32_t b = 0; b < s->cfg.batch; b++) {
+            int64_t t0 = esp_timer_get_time();
+            size_t len = s->cfg.fn(s->cfg.ctx, NULL, 0, s->out_buf + HDR, s->cfg.max_frame);
+            busy += (uint64_t)(esp_timer_get_time() - t0);
+            if (len > 0) {
+                emitted |= emit(s, len, t0);
+            }
+        }
+        if (emitted) {
+            xSemaphoreGive(s->out_data);
+        }
+
+        portENTER_CRITICAL(&s->lock);
+        s->st.batches++;
+        s->st.busy_us += busy;
+        portEXIT_CRITICAL(&s->lock);
+    }
+}
+
+/**
+ * @brief Runs one stage.
+ *
+ * @param arg The pipeline_stage_t.
+ */
+static void stage_task(void *arg)
+{
+    pipeline_stage_t *s = (pipeline_stage_t *)arg;
+    if (s->index == 0) {
+        source_loop(s);
+    }
+
+    pipeline_stage_t *prev = &s->pipe->stages[s->index - 1];
+    bool sink = s->out == NULL;
+    size_t lens[PIPELINE_MAX_BATCH];
+
+    while (1) {
+        xSemaphoreTake(prev->out_data, portMAX_DELAY);
+
+        while (1) {
+            uint32_t n = 0;
+            xSemaphoreTake(prev->out_rd_lock, portMAX_DELAY);
+            while (n < s->cfg.batch) {
+                lens[n] = xMessageBufferReceive(prev->out, s->in_buf + n * s->in_slot, s->in_slot, 0);
+                if (lens[n] == 0) {
+                    break;
+                }
+                n++;
+            }
+            xSemaphoreGive(prev->out_rd_lock);
+            if (n == 0) {
+                break;                      // Drained: wait for the next batch
+            }
+
+            bool emitted = false;
+            uint64_t busy = 0, qsum = 0, esum = 0;
+            uint32_t qmax = 0, emax = 0;
+            for (uint32_t i = 0; i < n; i++) {
+                const frame_hdr_t *h = (const frame_hdr_t *)(s->in_buf + i * s->in_slot);
+                const uint8_t *payload = (const uint8_t *)(h + 1);
+                int64_t t0 = esp_timer_get_time();
+                int64_t q = t0 - h->t_enq;
+                qsum += (uint64_t)q;
+                acc_max(&qmax, q);
+
+                size_t len = s->cfg.fn(s->cfg.ctx, payload, lens[i] - HDR,
+                                       sink ? NULL : s->out_buf + HDR, sink ? 0 : s->cfg.max_frame);
+                int64_t t1 = esp_timer_get_time();
+                busy += (uint64_t)(t1 - t0);
+                esum += (uint64_t)(t1 - h->t_origin);
+                acc_max(&emax, t1 - h->t_origin);
+                if (!sink && len > 0) {
+                    emitted |= emit(s, len, h->t_origin);
+                }
+            }
+            if (emitted) {
+                xSemaphoreGive(s->out_data);
+            }
+
+            portENTER_CRITICAL(&s->lock);
+            s->st.in += n;
+            s->st.batches++;
+            s->st.busy_us += busy;
+            s->st.qdelay_sum_us += qsum;
+            if (qmax > s->st.qdelay_max_us) {
+                s->st.qdelay_max_us = qmax;
+            }
+            s->st.e2e_sum_us += esum;
+            if (emax > s->st.e2e_max_us) {
+                s->st.e2e_max_us = emax;
+            }
+            portEXIT_CRITICAL(&s->lock);
+        }
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t pipeline_add_stage(pipeline_t *pipe, const pipeline_stage_config_t *cfg)
+{
+    if (pipe == NULL || cfg == NULL || cfg->fn == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (pipe->started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    if (pipe->nstages == PIPELINE_MAX_STAGES) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    pipeline_stage_t *s = &pipe->stages[pipe->nstages];
+    *s = (pipeline_stage_t) {
+        .cfg = *cfg,
+        .pipe = pipe,
+        .index = pipe->nstages,
+    };
+    portMUX_INITIALIZE(&s->lock);
+    s->cfg.name = cfg->name ? cfg->name : "stage";
+    s->cfg.priority = cfg->priority ? cfg->priority : 5;
+    s->cfg.stack_size = cfg->stack_size ? cfg->stack_size : 3072;
+    s->cfg.batch = cfg->batch ? cfg->batch : 1;
+    if (s->cfg.batch > PIPELINE_MAX_BATCH) {
+        s->cfg.batch = PIPELINE_MAX_BATCH;
+    }
+    pipe->nstages++;
+    return ESP_OK;
+}
+
+esp_err_t pipeline_start(pipeline_t *pipe)
+{
+    if (pipe == NULL || pipe->nstages < 2) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (pipe->started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int64_t now = esp_timer_get_time();
+    for (int i = 0; i < pipe->nstages; i++) {
+        pipeline_stage_t *s = &pipe->stages[i];
+        bool sink = i == pipe->nstages - 1;
+
+        if (!sink) {
+            if (s->cfg.max_frame == 0 || s->cfg.link_bytes < HDR + s->cfg.max_frame + MSG_LEN_BYTES) {
+                return ESP_ERR_INVALID_ARG;
+            }
+            s->out = xMessageBufferCreate(s->cfg.link_bytes);
+            s->out_data = xSemaphoreCreateBinary();
+            s->out_rd_lock = xSemaphoreCreateMutex();
+            s->out_buf = malloc(SLOT_BYTES(s->cfg.max_frame));
+            if (s->cfg.policy == PIPE_DROP_OLDEST) {
+                s->drop_buf = malloc(SLOT_BYTES(s->cfg.max_frame));
+            }
+            if (s->out == NULL || s->out_data == NULL || s->out_rd_lock == NULL || s->out_buf == NULL ||
+                (s->cfg.policy == PIPE_DROP_OLDEST && s->drop_buf == NULL)) {
+                return ESP_ERR_NO_MEM;
+            }
+        }
+        if (i > 0) {
+            s->in_slot = SLOT_BYTES(pipe->stages[i - 1].cfg.max_frame);
+            s->in_buf = malloc(s->cfg.batch * s->in_slot);
+            if (s->in_buf == NULL) {
+                return ESP_ERR_NO_MEM;
+            }
+        }
+        s->st.since_us = now;
+        s->st.link_min_free = s->cfg.link_bytes;
+    }
+
+    for (int i = 0; i < pipe->nstages; i++) {
+        pipeline_stage_t *s = &pipe->stages[i];
+        if (xTaskCreatePinnedToCore(stage_task, s->cfg.name, s->cfg.stack_size, s,
+                                    s->cfg.priority, &s->task, s->cfg.core) != pdPASS) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    pipe->started = true;
+    return ESP_OK;
+}
+
+void pipeline_get_stats(pipeline_t *pipe, int index, pipeline_stage_stats_t *out, bool reset)
+{
+    pipeline_stage_t *s = &pipe->stages[index];
+    int64_t now = esp_timer_get_time();
+
+    portENTER_CRITICAL(&s->lock);
+    *out = s->st;
+    if (reset) {
+        s->st = (pipeline_stage_stats_t) {
+            .since_us = now,
+            .link_min_free = s->cfg.link_bytes,
+        };
+    }
+    portEXIT_CRITICAL(&s->lock);
+}
+
+void pipeline_report(pipeline_t *pipe)
+{
+    int64_t now = esp_timer_get_time();
+    int worst = -1;
+    uint32_t worst_busy = 0;
+
+    for (int i = 0; i < pipe->nstages; i++) {
+        pipeline_stage_t *s = &pipe->stages[i];
+        pipeline_stage_stats_t st;
+        pipeline_get_stats(pipe, i, &st, true);
+
+        uint64_t win = (uint64_t)(now - st.since_us);
+        win = win ? win : 1;
+        uint32_t busy_pm = (uint32_t)(st.busy_us * 1000 / win);     // Per mille
+        uint32_t blocked_pm = (uint32_t)(st.blocked_us * 1000 / win);
+        uint32_t frames = s->out ? st.out : st.in;
+        uint32_t rate_x10 = (uint32_t)((uint64_t)frames * 10000000 / win);
+
+        printf("[PIPE] %-8s in=%" PRIu32 " out=%" PRIu32 " (%" PRIu32 ".%" PRIu32 "/s) busy %" PRIu32 ".%" PRIu32
+               "%% blocked %" PRIu32 ".%" PRIu32 "%% drop=%" PRIu32,
+               s->cfg.name, st.in, st.out, rate_x10 / 10, rate_x10 % 10,
+               busy_pm / 10, busy_pm % 10, blocked_pm / 10, blocked_pm % 10, st.drops);
+        if (i > 0) {
+            printf(" | qdelay avg %" PRIu32 " max %" PRIu32 " us | e2e avg %" PRIu32 " max %" PRIu32 " us",
+                   st.in ? (uint32_t)(st.qdelay_sum_us / st.in) : 0, st.qdelay_max_us,
+                   st.in ? (uint32_t)(st.e2e_sum_us / st.in) : 0, st.e2e_max_us);
+        }
+        if (s->out) {
+            printf(" | link min free %u/%u", (unsigned)st.link_min_free, (unsigned)s->cfg.link_bytes);
+        }
+        printf("\n");
+
+        if (busy_pm >= worst_busy) {
+            worst_busy = busy_pm;
+            worst = i;
+        }
+    }
+    if (worst >= 0) {
+        printf("[PIPE] bottleneck: %s (busy %" PRIu32 ".%" PRIu32 "%%)\n",
+               pipe->stages[worst].cfg.name, worst_busy / 10, worst_busy % 10);
+    }
+}
@@ -0,0 +1,164 @@
+/**
+ * @file stream_pipeline.h
+ * @brief Multi-stage frame pipeline over FreeRTOS message buffers, with drop policies and per-stage stats.
+ *
+ * Each stage is a task. It is pinned to a configurable core and calls a
+ * user function per frame. Consecutive stages are linked by a message
+ * buffer, so frames can have any length up to the producing stage's
+ * max_frame. A stage that runs slower than its input shows up in the
+ * report instead of as "Queue full!" prints. What happens at a full link
+ * is the producing stage's policy:
+ *   - PIPE_BLOCK       : the producer waits. It stops reading its own input,
+ *                        so backpressure travels upstream stage by stage up
+ *                        to the source.
+ *   - PIPE_DROP_NEWEST : the frame that does not fit is dropped.
+ *   - PIPE_DROP_OLDEST : queued frames are discarded until the new one fits
+ *                        (latest data wins, e.g. for a display or telemetry).
+ *
+ * Batching. A stage takes up to `batch` frames out of its input link in
+ * one go. It processes them, writes their outputs, and wakes the next
+ * stage once per batch, not once per frame.
+ *
+ * Every frame carries a 16-byte header with its source time and the time
+ * it was queued. Per stage the report shows:
+ *   frames in/out and output frames/s, busy % (time in the stage function),
+ *   blocked % (waiting on a full output link), drops, queueing delay
+ *   avg/max at its input, and end-to-end latency from the source.
+ * The stage with the highest busy % is printed as the bottleneck.
+ *
+ * Usage:
+ *   static pipeline_t pipe;
+ *   pipeline_add_stage(&pipe, &(pipeline_stage_config_t){ .name = "acq", .fn = acquire,
+ *                      .period_ms = 2, .max_frame = 128, .link_bytes = 2048 });
+ *   pipeline_add_stage(&pipe, &(pipeline_stage_config_t){ .name = "filt", .fn = filter,
+ *                      .core = 1, .batch = 4, .max_frame = 128, .link_bytes = 2048 });
+ *   pipeline_add_stage(&pipe, &(pipeline_stage_config_t){ .name = "tx", .fn = transmit });
+ *   pipeline_start(&pipe);
+ *   ...
+ *   pipeline_report(&pipe);
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/message_buffer.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef PIPELINE_MAX_STAGES
+#define PIPELINE_MAX_STAGES 6
+#endif
+
+/** @brief What a stage does when its output link is full. */
+typedef enum {
+    PIPE_BLOCK,
+    PIPE_DROP_NEWEST,
+    PIPE_DROP_OLDEST,
+} pipeline_policy_t;
+
+/**
+ * @brief Stage function.
+ *
+ * Source stages get in == NULL. Sink stages get out == NULL and their
+ * return value is ignored.
+ *
+ * @return Bytes written to @p out (<= out_max); 0 emits nothing for this input.
+ */
+typedef size_t (*pipeline_stage_fn_t)(void *ctx, const uint8_t *in, size_t in_len,
+                                      uint8_t *out, size_t out_max);
+
+/**
+ * @brief Stage settings; zero fields take the defaults in brackets.
+ */
+typedef struct {
+    const char *name;
+    pipeline_stage_fn_t fn;
+    void *ctx;
+    BaseType_t core;                //!< Core to pin to [0]; tskNO_AFFINITY allowed
+    UBaseType_t priority;           //!< [5]
+    uint32_t stack_size;            //!< Bytes [3072]
+    uint32_t batch;                 //!< Frames per wakeup [1]; source: calls per period
+    uint32_t period_ms;             //!< Source only: call period [0 = back to back, fn paces itself]
+    size_t max_frame;               //!< Largest output frame (not for the sink)
+    size_t link_bytes;              //!< Output link capacity in bytes (not for the sink)
+    pipeline_policy_t policy;       //!< Output link policy [PIPE_BLOCK]
+} pipeline_stage_config_t;
+
+/** @brief Per-stage counters since the last reset. */
+typedef struct {
+    uint32_t in;                    //!< Frames taken from the input link
+    uint32_t out;                   //!< Frames written to the output link
+    uint32_t drops;                 //!< Frames lost at the output link (either drop policy)
+    uint32_t batches;               //!< Wakeups that processed at least one frame
+    uint64_t busy_us;               //!< Time in the stage function
+    uint64_t blocked_us;            //!< Time waiting for space on the output link
+    uint64_t qdelay_sum_us;         //!< Input queueing delay (enqueue to dequeue)
+    uint32_t qdelay_max_us;
+    uint64_t e2e_sum_us;            //!< Source time to the end of this stage
+    uint32_t e2e_max_us;
+    size_t link_min_free;           //!< Lowest free space seen on the output link
+    int64_t since_us;               //!< Window start
+} pipeline_stage_stats_t;
+
+/**
+ * @brief Stage object; all fields are private.
+ */
+typedef struct {
+    pipeline_stage_config_t cfg;
+    struct pipeline *pipe;
+    int index;
+    TaskHandle_t task;
+    MessageBufferHandle_t out;      //!< Link to the next stage (NULL for the sink)
+    SemaphoreHandle_t out_data;     //!< Given after each batch written to out
+    SemaphoreHandle_t out_rd_lock;  //!< Serialises readers of out (next stage, drop-oldest)
+    uint8_t *in_buf;                //!< batch input slots
+    uint8_t *out_buf;               //!< One output slot
+    uint8_t *drop_buf;              //!< Drop-oldest discard slot
+    size_t in_slot;                 //!< Header + previous stage's max_frame
+    pipeline_stage_stats_t st;
+    portMUX_TYPE lock;
+} pipeline_stage_t;
+
+/**
+ * @brief Pipeline object; zero-initialise, then add stages in flow order.
+ */
+typedef struct pipeline {
+    pipeline_stage_t stages[PIPELINE_MAX_STAGES];
+    int nstages;
+    bool started;
+} pipeline_t;
+
+/**
+ * @brief Append a stage; the first one is the source, the last one the sink.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_INVALID_STATE after start, ESP_ERR_NO_MEM.
+ */
+esp_err_t pipeline_add_stage(pipeline_t *pipe, const pipeline_stage_config_t *cfg);
+
+/**
+ * @brief Create the links, buffers and stage tasks.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG (fewer than 2 stages, link smaller
+ *         than one frame), ESP_ERR_INVALID_STATE, ESP_ERR_NO_MEM.
+ */
+esp_err_t pipeline_start(pipeline_t *pipe);
+
+/**
+ * @brief Copy the counters of stage @p index, optionally starting a new window.
+ */
+void pipeline_get_stats(pipeline_t *pipe, int index, pipeline_stage_stats_t *out, bool reset);
+
+/**
+ * @brief Print one "[PIPE]" line per stage plus the bottleneck, and start a new window.
+ */
+void pipeline_report(pipeline_t *pipe);
+
+#ifdef __cplusplus
+}
+#endif
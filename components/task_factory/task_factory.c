@@ -0,0 +1,75 @@
+/**
+ * @file task_factory.c
+ * @brief Table-driven static task creation (see task_factory.h).
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "esp_log.h"
+#include "esp_memory_utils.h"
+#include "task_factory.h"
+
+#define TAG "TASK_FACTORY"
+
+// ------------------------ API ------------------------
+
+esp_err_t task_factory_start(const task_factory_entry_t *table, size_t count)
+{
+    if (table == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const task_factory_entry_t *e = &table[i];
+        if (e->fn == NULL || e->stack == NULL || e->tcb == NULL || e->stack_size == 0) {
+            ESP_LOGE(TAG, "entry %u (%s) is incomplete", (unsigned)i, e->name ? e->name : "?");
+            return ESP_ERR_INVALID_ARG;
+        }
+
+        TaskHandle_t h = xTaskCreateStaticPinnedToCore(e->fn, e->name, e->stack_size, e->arg,
+                                                       e->priority, e->stack, e->tcb, e->core);
+        if (h == NULL) {
+            ESP_LOGE(TAG, "failed to create %s (stack %s)", e->name,
+                     esp_ptr_external_ram(e->stack) ? "PSRAM" : "internal");
+            return ESP_ERR_INVALID_STATE;
+        }
+        if (e->handle != NULL) {
+            *e->handle = h;
+        }
+    }
+    return ESP_OK;
+}
+
+uint32_t task_factory_headroom(const task_factory_entry_t *entry)
+{
+    if (entry->handle == NULL || *entry->handle == NULL) {
+        return 0;
+    }
+    // In ESP-IDF the high-water mark is already in bytes
+    return (uint32_t)uxTaskGetStackHighWaterMark(*entry->handle);
+}
+
+void task_factory_report(const task_factory_entry_t *table, size_t count)
+{
+    uint32_t total = 0;
+    uint32_t total_free = 0;
+
+    printf("\n%-16s %-5s %8s %8s %8s %6s\n", "Task", "Mem", "Stack", "Used", "Free", "Free%");
+    for (size_t i = 0; i < count; i++) {
+        const task_factory_entry_t *e = &table[i];
+        if (e->handle == NULL || *e->handle == NULL) {
+            printf("%-16s %-5s %8" PRIu32 " %8s %8s %6s\n", e->name,
+                   esp_ptr_external_ram(e->stack) ? "PSRAM" : "DRAM", e->stack_size, "-", "-", "-");
+            continue;
+        }
+
+        uint32_t free_bytes = task_factory_headroom(e);
+        uint32_t used = e->stack_size - free_bytes;
+        printf("%-16s %-5s %8" PRIu32 " %8" PRIu32 " %8" PRIu32 " %5" PRIu32 "%%\n", e->name,
+               esp_ptr_external_ram(e->stack) ? "PSRAM" : "DRAM",
+               e->stack_size, used, free_bytes, free_bytes * 100 / e->stack_size);
+        total += e->stack_size;
+        total_free += free_bytes;
+    }
+    printf("Total static stack: %" PRIu32 " bytes, %" PRIu32 " never touched\n\n", total, total_free);
+}
@@ -0,0 +1,143 @@
+/**
+ * @file task_factory.h
+ * @brief Table-driven static task creation (xTaskCreateStaticPinnedToCore) with a stack headroom report.
+ *
+ * xTaskCreate() allocates the TCB and the stack from the heap at boot. On a
+ * long-running device those blocks are carved out of the same heap that
+ * Wi-Fi, drivers and the application use later. A task that is deleted and
+ * re-created can leave holes. And the heap's minimum-free level is reached
+ * during boot, before the application has done anything.
+ *
+ * task_factory moves every stack and TCB into .bss, which the linker sizes
+ * at build time:
+ *   - TASK_FACTORY_STACK(var, bytes)     : stack + TCB in internal DRAM
+ *   - TASK_FACTORY_STACK_EXT(var, bytes) : stack in PSRAM, TCB in DRAM
+ *   - TASK_FACTORY_ENTRY(var, ...)       : one row of the task table
+ *
+ * task_factory_start() creates the whole table and task_factory_report()
+ * prints each task's stack high-water mark, so oversized stacks can be
+ * shrunk from measured data.
+ *
+ * Stack sizes measured by components/stack_profiler come out as
+ * STACK_PROFILE_<NAME> defines in a generated stack_profile.h. Use them as
+ * the TASK_FACTORY_STACK() sizes, with a fallback when there is no profile yet:
+ *   #if __has_include("stack_profile.h")
+ *   #include "stack_profile.h"
+ *   #endif
+ *   #ifndef STACK_PROFILE_SENSOR
+ *   #define STACK_PROFILE_SENSOR 3072
+ *   #endif
+ *   TASK_FACTORY_STACK(sensor, STACK_PROFILE_SENSOR);
+ *
+ * PSRAM stacks need CONFIG_SPIRAM_ALLOW_STACK_EXTERNAL_MEMORY and
+ * CONFIG_SPIRAM_ALLOW_BSS_SEG_EXTERNAL_MEMORY. Without them
+ * TASK_FACTORY_STACK_EXT() falls back to internal RAM. A task with a PSRAM
+ * stack must not run while the flash cache is disabled: no SPI flash
+ * writes or NVS commits from it, and no IRAM-only ISR work.
+ *
+ * Usage:
+ *   TASK_FACTORY_STACK(sensor, 3072);
+ *   TASK_FACTORY_STACK_EXT(logger, 4096);
+ *   static TaskHandle_t s_sensor, s_logger;
+ *   static const task_factory_entry_t s_tasks[] = {
+ *       TASK_FACTORY_ENTRY(sensor, sensor_task, "sensor", NULL, 6, 1, &s_sensor),
+ *       TASK_FACTORY_ENTRY(logger, logger_task, "logger", NULL, 2, 0, &s_logger),
+ *   };
+ *   task_factory_start(s_tasks, TASK_FACTORY_COUNT(s_tasks));
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if CONFIG_SPIRAM_ALLOW_STACK_EXTERNAL_MEMORY && CONFIG_SPIRAM_ALLOW_BSS_SEG_EXTERNAL_MEMORY
+#define TASK_FACTORY_EXT_ATTR EXT_RAM_BSS_ATTR
+#else
+#define TASK_FACTORY_EXT_ATTR               // No PSRAM stacks: stay in internal RAM
+#endif
+
+/**
+ * @brief Declare a static stack and TCB in internal DRAM.
+ *
+ * @param var   Identifier prefix (creates var##_stack and var##_tcb).
+ * @param bytes Stack depth in bytes (ESP-IDF StackType_t is one byte).
+ */
+#define TASK_FACTORY_STACK(var, bytes)                                                  \
+    static StackType_t var##_stack[(bytes) / sizeof(StackType_t)]                       \
+        __attribute__((aligned(16)));                                                   \
+    static StaticTask_t var##_tcb
+
+/**
+ * @brief Declare a static stack in PSRAM (when enabled) and a TCB in DRAM.
+ *
+ * The TCB always stays internal; the kernel touches it with the cache off.
+ */
+#define TASK_FACTORY_STACK_EXT(var, bytes)                                              \
+    static TASK_FACTORY_EXT_ATTR StackType_t var##_stack[(bytes) / sizeof(StackType_t)] \
+        __attribute__((aligned(16)));                                                   \
+    static StaticTask_t var##_tcb
+
+/**
+ * @brief One task description; build with TASK_FACTORY_ENTRY().
+ */
+typedef struct {
+    TaskFunction_t fn;
+    const char *name;
+    void *arg;
+    UBaseType_t priority;
+    BaseType_t core;                //!< 0, 1 or tskNO_AFFINITY
+    StackType_t *stack;
+    uint32_t stack_size;            //!< Bytes
+    StaticTask_t *tcb;
+    TaskHandle_t *handle;           //!< Out: created handle (may be NULL)
+} task_factory_entry_t;
+
+/**
+ * @brief Table row for a task whose storage was declared with TASK_FACTORY_STACK*(var, ...).
+ */
+#define TASK_FACTORY_ENTRY(var, fn_, name_, arg_, prio_, core_, handle_)                \
+    {                                                                                   \
+        .fn = (fn_), .name = (name_), .arg = (arg_),                                    \
+        .priority = (prio_), .core = (core_),                                           \
+        .stack = var##_stack, .stack_size = sizeof(var##_stack),                        \
+        .tcb = &var##_tcb, .handle = (handle_),                                         \
+    }
+
+#define TASK_FACTORY_COUNT(table) (sizeof(table) / sizeof((table)[0]))
+
+/**
+ * @brief Create every task of @p table in order.
+ *
+ * Stops at the first failure; tasks created before it keep running.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for a malformed entry, or
+ *         ESP_ERR_INVALID_STATE if the kernel rejected a buffer (for example
+ *         a PSRAM stack without CONFIG_SPIRAM_ALLOW_STACK_EXTERNAL_MEMORY).
+ */
+esp_err_t task_factory_start(const task_factory_entry_t *table, size_t count);
+
+/**
+ * @brief Print stack size, high-water mark and headroom of every task in @p table.
+ *
+ * The high-water mark only records the deepest use so far, so run this after
+ * the tasks have gone through their worst-case paths.
+ */
+void task_factory_report(const task_factory_entry_t *table, size_t count);
+
+/**
+ * @brief Unused stack bytes of one created entry (0 if not running).
+ */
+uint32_t task_factory_headroom(const task_factory_entry_t *entry);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,212 @@
+/**
+ * @file task_signal.c
+ * @brief Notification-based task signalling (see task_signal.h).
+ *
+ * Every receive drains the whole notification value into sig->pending
+ * (clear-on-exit = all bits). Only the receiver touches pending, so it
+ * needs no lock. Bits the current call did not ask for stay there for the
+ * next call. Counting events live in an atomic counter, and
+ * TASK_SIGNAL_COUNT only wakes the receiver. The counter is re-read before
+ * every block, so a give can never be lost between the read and the wait.
+ */
+
+#include "task_signal.h"
+
+#define CONTROL_WAKE (TASK_SIGNAL_STOP | TASK_SIGNAL_PAUSE)
+
+// ------------------------ Helpers ------------------------
+
+static inline void post(task_signal_t *sig, uint32_t bits)
+{
+    xTaskNotifyIndexed(sig->task, TASK_SIGNAL_NOTIFY_INDEX, bits, eSetBits);
+}
+
+static inline void post_from_isr(task_signal_t *sig, uint32_t bits, BaseType_t *hp_task_woken)
+{
+    xTaskNotifyIndexedFromISR(sig->task, TASK_SIGNAL_NOTIFY_INDEX, bits, eSetBits, hp_task_woken);
+}
+
+/**
+ * @brief Block until any bit of @p want is pending or @p wait expires.
+ *
+ * @return pending & want (nothing is consumed).
+ */
+static uint32_t wait_bits(task_signal_t *sig, uint32_t want, TickType_t wait)
+{
+    TimeOut_t timeout;
+    TickType_t remaining = wait;
+    uint32_t value;
+
+    vTaskSetTimeOutState(&timeout);
+    while ((sig->pending & want) == 0) {
+        if (xTaskNotifyWaitIndexed(TASK_SIGNAL_NOTIFY_INDEX, 0, UINT32_MAX, &value, remaining) != pdTRUE) {
+            break;
+        }
+        sig->pending |= value;
+        if ((sig->pending & want) != 0) {
+            break;
+        }
+        if (xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            break;
+        }
+    }
+    return sig->pending & want;
+}
+
+// ------------------------ Setup / senders ------------------------
+
+esp_err_t task_signal_init(task_signal_t *sig, TaskHandle_t task)
+{
+    if (sig == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    sig->task = (task != NULL) ? task : xTaskGetCurrentTaskHandle();
+    sig->pending = 0;
+    atomic_store(&sig->count, 0);
+    atomic_store(&sig->state, TASK_SIGNAL_STATE_RUNNING);
+    return ESP_OK;
+}
+
+void task_signal_bind(task_signal_t *sig, TaskHandle_t task)
+{
+    sig->task = task;
+}
+
+void task_signal_set(task_signal_t *sig, uint32_t bits)
+{
+    post(sig, bits & TASK_SIGNAL_USER_MASK);
+}
+
+void task_signal_set_from_isr(task_signal_t *sig, uint32_t bits, BaseType_t *hp_task_woken)
+{
+    post_from_isr(sig, bits & TASK_SIGNAL_USER_MASK, hp_task_woken);
+}
+
+void task_signal_give(task_signal_t *sig)
+{
+    atomic_fetch_add(&sig->count, 1);
+    post(sig, TASK_SIGNAL_COUNT);
+}
+
+void task_signal_give_from_isr(task_signal_t *sig, BaseType_t *hp_task_woken)
+{
+    atomic_fetch_add(&sig->count, 1);
+    post_from_isr(sig, TASK_SIGNAL_COUNT, hp_task_woken);
+}
+
+void task_signal_request_stop(task_signal_t *sig)
+{
+    post(sig, TASK_SIGNAL_STOP);
+}
+
+void task_signal_request_pause(task_signal_t *sig)
+{
+    post(sig, TASK_SIGNAL_PAUSE);
+}
+
+void task_signal_request_resume(task_signal_t *sig)
+{
+    post(sig, TASK_SIGNAL_RESUME);
+}
+
+bool task_signal_wait_state(task_signal_t *sig, task_signal_state_t state, TickType_t wait)
+{
+    TimeOut_t timeout;
+    TickType_t remaining = wait;
+
+    vTaskSetTimeOutState(&timeout);
+    while (task_signal_get_state(sig) != state) {
+        if (xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            return false;
+        }
+        vTaskDelay(1);
+    }
+    return true;
+}
+
+// ------------------------ Receiver ------------------------
+
+uint32_t task_signal_wait(task_signal_t *sig, uint32_t mask, TickType_t wait)
+{
+    uint32_t got = wait_bits(sig, (mask & TASK_SIGNAL_USER_MASK) | CONTROL_WAKE, wait);
+
+    sig->pending &= ~(got & TASK_SIGNAL_USER_MASK);    // Control bits stay for the checkpoint
+    return got;
+}
+
+uint32_t task_signal_take(task_signal_t *sig, TickType_t wait)
+{
+    TimeOut_t timeout;
+    TickType_t remaining = wait;
+
+    vTaskSetTimeOutState(&timeout);
+    while (1) {
+        uint32_t n = atomic_exchange(&sig->count, 0);
+        if (n != 0) {
+            sig->pending &= ~TASK_SIGNAL_COUNT;
+            return n;
+        }
+
+        uint32_t got = wait_bits(sig, TASK_SIGNAL_COUNT | CONTROL_WAKE, remaining);
+        if (got == 0 || (got & CONTROL_WAKE) != 0) {
+            return 0;
+        }
+        sig->pending &= ~TASK_SIGNAL_COUNT;
+        if (xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            return atomic_exchange(&sig->count, 0);
+        }
+    }
+}
+
+bool task_signal_checkpoint(task_signal_t *sig)
+{
+    uint32_t value;
+
+    if (xTaskNotifyWaitIndexed(TASK_SIGNAL_NOTIFY_INDEX, 0, UINT32_MAX, &value, 0) == pdTRUE) {
+        sig->pending |= value;
+    }
+    if (sig->pending & TASK_SIGNAL_STOP) {
+        return true;
+    }
+
+    if (sig->pending & TASK_SIGNAL_PAUSE) {
+        sig->pending &= ~TASK_SIGNAL_PAUSE;
+        // A resume that is already pending cancels the pause
+        if ((sig->pending & TASK_SIGNAL_RESUME) == 0) {
+            atomic_store(&sig->state, TASK_SIGNAL_STATE_PAUSED);
+            wait_bits(sig, TASK_SIGNAL_RESUME | TASK_SIGNAL_STOP, portMAX_DELAY);
+            atomic_store(&sig->state, TASK_SIGNAL_STATE_RUNNING);
+        }
+    }
+    sig->pending &= ~TASK_SIGNAL_RESUME;
+    return (sig->pending & TASK_SIGNAL_STOP) != 0;
+}
+
+bool task_signal_sleep(task_signal_t *sig, TickType_t ticks)
+{
+    TimeOut_t timeout;
+    TickType_t remaining = ticks;
+
+    vTaskSetTimeOutState(&timeout);
+    while (1) {
+        if (wait_bits(sig, CONTROL_WAKE, remaining) == 0) {
+            return false;                   // Slept the full time
+        }
+        if (task_signal_checkpoint(sig)) {
+            return true;
+        }
+        // Resumed: sleep whatever is left of the original delay
+        if (xTaskCheckForTimeOut(&timeout, &remaining) == pdTRUE) {
+            return false;
+        }
+    }
+}
+
+void task_signal_exit(task_signal_t *sig)
+{
+    atomic_store(&sig->state, TASK_SIGNAL_STATE_STOPPED);
+    vTaskDelete(NULL);
+    while (1) {
+        // Not reached
+    }
+}
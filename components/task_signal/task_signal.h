@@ -0,0 +1,188 @@
+/**
+ * @file task_signal.h
+ * @brief Lightweight task signalling on direct-to-task notifications: bit events,
+ *        counting events and cooperative stop/pause/resume.
+ *
+ * A task_signal_t belongs to one receiving task. Other tasks and ISRs post
+ * to it:
+ *   - bit events  : task_signal_set() ORs user bits into the task's
+ *                   notification value (eSetBits). task_signal_wait()
+ *                   returns the requested bits and keeps the others pending.
+ *   - count events: task_signal_give() increments a counter. task_signal_take()
+ *                   returns and clears the accumulated count, like a
+ *                   counting semaphore without the queue.
+ *   - control     : task_signal_request_stop/pause/resume() set reserved
+ *                   bits. The receiver acts on them only at points it
+ *                   chooses, with task_signal_checkpoint() or
+ *                   task_signal_sleep(), so it never stops or pauses while
+ *                   holding a buffer, a mutex or a half-written peripheral.
+ *
+ * This replaces two patterns. vTaskSuspend() freezes a task wherever it
+ * happens to be. vTaskDelete() of another task leaks whatever the victim
+ * had allocated. With task_signal the worker releases its resources and
+ * exits through task_signal_exit(). The controller can wait for that with
+ * task_signal_wait_state().
+ *
+ * Rules:
+ *   - Only the receiving task calls wait/take/checkpoint/sleep/exit.
+ *   - The receiver uses notification index TASK_SIGNAL_NOTIFY_INDEX; do not
+ *     use that index for anything else in the same task.
+ *   - User bits are TASK_SIGNAL_USER_MASK (bits 0..27).
+ */
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef TASK_SIGNAL_NOTIFY_INDEX
+#define TASK_SIGNAL_NOTIFY_INDEX 0
+#endif
+
+#define TASK_SIGNAL_STOP        (1UL << 31)     //!< Stop requested (sticky)
+#define TASK_SIGNAL_PAUSE       (1UL << 30)     //!< Pause requested
+#define TASK_SIGNAL_RESUME      (1UL << 29)     //!< Resume requested
+#define TASK_SIGNAL_COUNT       (1UL << 28)     //!< Internal: counter changed
+#define TASK_SIGNAL_USER_MASK   0x0FFFFFFFUL
+
+/** @brief Receiver state as seen by the controller. */
+typedef enum {
+    TASK_SIGNAL_STATE_RUNNING = 0,
+    TASK_SIGNAL_STATE_PAUSED,
+    TASK_SIGNAL_STATE_STOPPED,      //!< Receiver called task_signal_exit()
+} task_signal_state_t;
+
+/**
+ * @brief Signal object of one receiving task; all fields are private.
+ */
+typedef struct {
+    TaskHandle_t task;              //!< Receiver
+    uint32_t pending;               //!< Bits received but not consumed (receiver only)
+    atomic_uint count;              //!< Counting events not yet taken
+    atomic_int state;               //!< task_signal_state_t
+} task_signal_t;
+
+/**
+ * @brief Reset @p sig and bind it to its receiving task.
+ *
+ * Call before the receiver can run, i.e. before its xTaskCreate(): a reset
+ * after the receiver started would discard what it already recorded. When
+ * the handle does not exist yet, bind it with task_signal_bind() once
+ * xTaskCreate() returns.
+ *
+ * @param task Receiver, or NULL for the calling task.
+ * @return ESP_OK or ESP_ERR_INVALID_ARG.
+ */
+esp_err_t task_signal_init(task_signal_t *sig, TaskHandle_t task);
+
+/**
+ * @brief Set the receiver of an initialised @p sig; call before anything posts to it.
+ */
+void task_signal_bind(task_signal_t *sig, TaskHandle_t task);
+
+// ------------------------ Senders ------------------------
+
+/**
+ * @brief Post user bit events (bits outside TASK_SIGNAL_USER_MASK are ignored).
+ */
+void task_signal_set(task_signal_t *sig, uint32_t bits);
+
+/**
+ * @brief ISR version of task_signal_set().
+ */
+void task_signal_set_from_isr(task_signal_t *sig, uint32_t bits, BaseType_t *hp_task_woken);
+
+/**
+ * @brief Post one counting event.
+ */
+void task_signal_give(task_signal_t *sig);
+
+/**
+ * @brief ISR version of task_signal_give().
+ */
+void task_signal_give_from_isr(task_signal_t *sig, BaseType_t *hp_task_woken);
+
+/** @brief Ask the receiver to exit at its next checkpoint. */
+void task_signal_request_stop(task_signal_t *sig);
+
+/** @brief Ask the receiver to pause at its next checkpoint. */
+void task_signal_request_pause(task_signal_t *sig);
+
+/** @brief Let a paused receiver continue. */
+void task_signal_request_resume(task_signal_t *sig);
+
+/**
+ * @brief Current receiver state.
+ */
+static inline task_signal_state_t task_signal_get_state(task_signal_t *sig)
+{
+    return (task_signal_state_t)atomic_load(&sig->state);
+}
+
+/**
+ * @brief Wait until the receiver reaches @p state (polls once per tick).
+ *
+ * Meant for supervisor paths such as "stop and confirm", not for hot paths.
+ *
+ * @return true if the state was reached within @p wait.
+ */
+bool task_signal_wait_state(task_signal_t *sig, task_signal_state_t state, TickType_t wait);
+
+// ------------------------ Receiver ------------------------
+
+/**
+ * @brief Wait for any of the user bits in @p mask.
+ *
+ * Also returns early if a stop or pause request is pending; those bits are
+ * included in the result (and left pending) so the caller can run
+ * task_signal_checkpoint().
+ *
+ * @return The user bits of @p mask that were received (now consumed), plus
+ *         TASK_SIGNAL_STOP / TASK_SIGNAL_PAUSE if pending; 0 on timeout.
+ */
+uint32_t task_signal_wait(task_signal_t *sig, uint32_t mask, TickType_t wait);
+
+/**
+ * @brief Take all accumulated counting events.
+ *
+ * @return Number of events taken; 0 on timeout or when a stop/pause
+ *         request is pending.
+ */
+uint32_t task_signal_take(task_signal_t *sig, TickType_t wait);
+
+/**
+ * @brief Safe point: handle pending control requests without blocking otherwise.
+ *
+ * While a pause is requested this blocks until resume or stop.
+ *
+ * @return true if the receiver should stop (clean up, then task_signal_exit()).
+ */
+bool task_signal_checkpoint(task_signal_t *sig);
+
+/**
+ * @brief Cooperative vTaskDelay(): sleep @p ticks but wake for stop/pause.
+ *
+ * Pauses are honoured inside the sleep. Bit events received meanwhile stay
+ * pending for the next task_signal_wait().
+ *
+ * @return true if the receiver should stop.
+ */
+bool task_signal_sleep(task_signal_t *sig, TickType_t ticks);
+
+/**
+ * @brief Mark the receiver stopped and delete the calling task.
+ *
+ * Release every resource the task owns before calling this.
+ */
+void task_signal_exit(task_signal_t *sig) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+/**
+ * @file trace_hooks.h
+ * @brief FreeRTOS trace macro definitions that feed components/trace_recorder.
+ *
+ * The kernel only picks these up if this header is seen before
+ * FreeRTOS.h in every C file, kernel sources included. Force-include it
+ * for C files only, from the project's top-level CMakeLists.txt after
+ * project():
+ *
+ *   idf_build_set_property(C_COMPILE_OPTIONS
+ *       "-include;${CMAKE_SOURCE_DIR}/main/trace_hooks.h" APPEND)
+ *
+ * Each macro is one load and a branch while recording is off. Queue
+ * macros expand inside queue.c, where pxQueue is known, and also record
+ * the queue depth. Semaphores and mutexes are queues, so they appear as
+ * queue events. Notify macros use the parameter names of FreeRTOS V10.4/10.5
+ * (ESP-IDF v5.x).
+ *
+ * Do not combine with SystemView (CONFIG_APPTRACE_SV_ENABLE), which
+ * defines the same macros.
+ */
+#pragma once
+
+#ifndef __ASSEMBLER__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Event types; shared with trace_recorder.h and trace_convert.py. */
+enum {
+    TRACE_EV_SWITCH_IN = 1,
+    TRACE_EV_SWITCH_OUT,
+    TRACE_EV_TASK_CREATE,
+    TRACE_EV_TASK_DELETE,
+    TRACE_EV_QUEUE_SEND,
+    TRACE_EV_QUEUE_SEND_FAILED,
+    TRACE_EV_QUEUE_SEND_BLOCK,
+    TRACE_EV_QUEUE_SEND_ISR,
+    TRACE_EV_QUEUE_RECEIVE,
+    TRACE_EV_QUEUE_RECEIVE_FAILED,
+    TRACE_EV_QUEUE_RECEIVE_BLOCK,
+    TRACE_EV_QUEUE_RECEIVE_ISR,
+    TRACE_EV_NOTIFY_GIVE,
+    TRACE_EV_NOTIFY_GIVE_ISR,
+    TRACE_EV_NOTIFY_TAKE,
+    TRACE_EV_USER,
+};
+
+extern volatile unsigned trace_rec_on;
+void trace_rec_event(unsigned type, const void *obj, unsigned arg);
+void trace_rec_current(unsigned type);
+void trace_rec_task_created(void *task);
+
+#define TRACE_REC_HOOK(call) do { if (trace_rec_on) { call; } } while (0)
+
+#define traceTASK_SWITCHED_IN()                 TRACE_REC_HOOK(trace_rec_current(TRACE_EV_SWITCH_IN))
+#define traceTASK_SWITCHED_OUT()                TRACE_REC_HOOK(trace_rec_current(TRACE_EV_SWITCH_OUT))
+#define traceTASK_CREATE(pxNewTCB)              trace_rec_task_created(pxNewTCB)
+#define traceTASK_DELETE(pxTCB)                 TRACE_REC_HOOK(trace_rec_event(TRACE_EV_TASK_DELETE, pxTCB, 0))
+
+#define traceQUEUE_SEND(pxQueue)                TRACE_REC_HOOK(trace_rec_event(TRACE_EV_QUEUE_SEND, pxQueue, (pxQueue)->uxMessagesWaiting))
+#define traceQUEUE_SEND_FAILED(pxQueue)         TRACE_REC_HOOK(trace_rec_event(TRACE_EV_QUEUE_SEND_FAILED, pxQueue, (pxQueue)->uxMessagesWaiting))
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)    TRACE_REC_HOOK(trace_rec_event(TRACE_EV_QUEUE_SEND_BLOCK, pxQueue, (pxQueue)->uxMessagesWaiting))
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)       TRACE_REC_HOOK(trace_rec_event(TRACE_EV_QUEUE_SEND_ISR, pxQueue, (pxQueue)->uxMessagesWaiting))
+#define traceQUEUE_RECEIVE(pxQueue)             TRACE_REC_HOOK(trace_rec_event(TRACE_EV_QUEUE_RECEIVE, pxQueue, (pxQueue)->uxMessagesWaiting))
+#define traceQUEUE_SEMAPHORE_RECEIVE(pxQueue)   TRACE_REC_HOOK(trace_rec_event(TRACE_EV_QUEUE_RECEIVE, pxQueue, (pxQueue)->uxMessagesWaiting))
+#define traceQUEUE_RECEIVE_FAILED(pxQueue)      TRACE_REC_HOOK(trace_rec_event(TRACE_EV_QUEUE_RECEIVE_FAILED, pxQueue, (pxQueue)->uxMessagesWaiting))
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) TRACE_REC_HOOK(trace_rec_event(TRACE_EV_QUEUE_RECEIVE_BLOCK, pxQueue, (pxQueue)->uxMessagesWaiting))
+#define traceQUEUE_RECEIVE_FROM_ISR(pxQueue)    TRACE_REC_HOOK(trace_rec_event(TRACE_EV_QUEUE_RECEIVE_ISR, pxQueue, (pxQueue)->uxMessagesWaiting))
+
+#define traceTASK_NOTIFY(uxIndexToNotify)                 TRACE_REC_HOOK(trace_rec_event(TRACE_EV_NOTIFY_GIVE, xTaskToNotify, uxIndexToNotify))
+#define traceTASK_NOTIFY_FROM_ISR(uxIndexToNotify)        TRACE_REC_HOOK(trace_rec_event(TRACE_EV_NOTIFY_GIVE_ISR, xTaskToNotify, uxIndexToNotify))
+#define traceTASK_NOTIFY_GIVE_FROM_ISR(uxIndexToNotify)   TRACE_REC_HOOK(trace_rec_event(TRACE_EV_NOTIFY_GIVE_ISR, xTaskToNotify, uxIndexToNotify))
+#define traceTASK_NOTIFY_TAKE(uxIndexToWait)              TRACE_REC_HOOK(trace_rec_current(TRACE_EV_NOTIFY_TAKE))
+#define traceTASK_NOTIFY_WAIT(uxIndexToWait)              TRACE_REC_HOOK(trace_rec_current(TRACE_EV_NOTIFY_TAKE))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ASSEMBLER__
@@ -0,0 +1,212 @@
+/**
+ * @file trace_recorder.c
+ * @brief Per-core trace rings written from the FreeRTOS trace macros (see trace_recorder.h).
+ *
+ * Hooks run inside the kernel (in the context switch and inside queue
+ * critical sections), so everything they touch is in IRAM/DRAM. The only
+ * kernel call is xTaskGetCurrentTaskHandle(), which just masks interrupts.
+ * The task-name table is the one lock, taken only at task creation and
+ * when an object is named. It is a leaf lock, never held while taking
+ * another.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_attr.h"
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+#include "esp_timer.h"
+#include "trace_recorder.h"
+
+_Static_assert((TRACE_REC_RECORDS_PER_CORE & (TRACE_REC_RECORDS_PER_CORE - 1)) == 0,
+               "TRACE_REC_RECORDS_PER_CORE must be a power of two");
+
+#define RECS_PER_LINE   4
+
+typedef struct {
+    const void *obj;
+    bool task;
+    char name[configMAX_TASK_NAME_LEN];
+} name_entry_t;
+
+volatile unsigned trace_rec_on;
+
+static DRAM_ATTR trace_rec_record_t s_ring[portNUM_PROCESSORS][TRACE_REC_RECORDS_PER_CORE];
+static DRAM_ATTR uint32_t s_head[portNUM_PROCESSORS];  //!< Records written (wraps the ring)
+static DRAM_ATTR uint32_t s_dropped[portNUM_PROCESSORS];
+static name_entry_t s_names[TRACE_REC_MAX_NAMES];
+static int s_nnames;
+static DRAM_ATTR portMUX_TYPE s_names_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ------------------------ Hooks ------------------------
+
+static inline uint32_t trace_now(void)
+{
+#if TRACE_REC_CLOCK_CCOUNT
+    return (uint32_t)esp_cpu_get_cycle_count();
+#else
+    return (uint32_t)esp_timer_get_time();
+#endif
+}
+
+void IRAM_ATTR trace_rec_event(unsigned type, const void *obj, unsigned arg)
+{
+    UBaseType_t irq = portSET_INTERRUPT_MASK_FROM_ISR();
+    int core = xPortGetCoreID();
+    uint32_t h = s_head[core];
+
+#if !TRACE_REC_OVERWRITE
+    if (h >= TRACE_REC_RECORDS_PER_CORE) {
+        s_dropped[core]++;
+        portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+        return;
+    }
+#endif
+    trace_rec_record_t *r = &s_ring[core][h & (TRACE_REC_RECORDS_PER_CORE - 1)];
+    r->ts = trace_now();
+    r->obj = (uint32_t)(uintptr_t)obj;
+    r->arg = arg;
+    r->type = (uint8_t)type;
+    r->core = (uint8_t)core;
+    r->reserved = 0;
+    s_head[core] = h + 1;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(irq);
+}
+
+void IRAM_ATTR trace_rec_current(unsigned type)
+{
+    trace_rec_event(type, xTaskGetCurrentTaskHandle(), 0);
+}
+
+/**
+ * @brief Insert or replace the name of @p obj. Call with s_names_lock held.
+ */
+static bool names_put(const void *obj, const char *name, bool task)
+{
+    int i = 0;
+    while (i < s_nnames && s_names[i].obj != obj) {
+        i++;
+    }
+    if (i == s_nnames) {
+        if (s_nnames == TRACE_REC_MAX_NAMES) {
+            return false;
+        }
+        s_nnames++;
+    }
+    s_names[i].obj = obj;
+    s_names[i].task = task;
+    size_t n = 0;
+    for (; name[n] != '\0' && n < sizeof(s_names[i].name) - 1; n++) {
+        s_names[i].name[n] = name[n];
+    }
+    s_names[i].name[n] = '\0';
+    return true;
+}
+
+void trace_rec_task_created(void *task)
+{
+    // Always registered, so tasks created before trace_rec_start() have names too
+    portENTER_CRITICAL_SAFE(&s_names_lock);
+    names_put(task, pcTaskGetName((TaskHandle_t)task), true);
+    portEXIT_CRITICAL_SAFE(&s_names_lock);
+
+    if (trace_rec_on) {
+        trace_rec_event(TRACE_EV_TASK_CREATE, task, 0);
+    }
+}
+
+// ------------------------ API ------------------------
+
+void trace_rec_start(void)
+{
+    trace_rec_on = 0;
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        s_head[i] = 0;
+        s_dropped[i] = 0;
+    }
+    trace_rec_on = 1;
+}
+
+void trace_rec_stop(void)
+{
+    trace_rec_on = 0;
+}
+
+esp_err_t trace_rec_name(const void *obj, const char *name)
+{
+    portENTER_CRITICAL(&s_names_lock);
+    bool ok = names_put(obj, name ? name : "?", false);
+    portEXIT_CRITICAL(&s_names_lock);
+    return ok ? ESP_OK : ESP_ERR_NO_MEM;
+}
+
+void trace_rec_user(uint32_t id, uint32_t value)
+{
+    if (trace_rec_on) {
+        trace_rec_event(TRACE_EV_USER, (const void *)(uintptr_t)id, value);
+    }
+}
+
+void trace_rec_get_stats(trace_rec_stats_t *out)
+{
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        uint32_t h = s_head[i];
+        out->written[i] = h;
+#if TRACE_REC_OVERWRITE
+        out->lost[i] = h > TRACE_REC_RECORDS_PER_CORE ? h - TRACE_REC_RECORDS_PER_CORE : 0;
+#else
+        out->lost[i] = s_dropped[i];
+#endif
+    }
+}
+
+void trace_rec_dump(void)
+{
+    trace_rec_stop();
+    vTaskDelay(pdMS_TO_TICKS(2));   // Let a record in progress on the other core finish
+
+    trace_rec_stats_t st;
+    trace_rec_get_stats(&st);
+#if TRACE_REC_CLOCK_CCOUNT
+    printf("TRACE-BEGIN v1 cores=%d clock=ccount hz=%" PRIu32 " per_core=%d\n",
+           portNUM_PROCESSORS, esp_rom_get_cpu_ticks_per_us() * 1000000, TRACE_REC_RECORDS_PER_CORE);
+#else
+    printf("TRACE-BEGIN v1 cores=%d clock=us hz=1000000 per_core=%d\n",
+           portNUM_PROCESSORS, TRACE_REC_RECORDS_PER_CORE);
+#endif
+
+    for (int i = 0; ; i++) {
+        name_entry_t e;
+        portENTER_CRITICAL(&s_names_lock);
+        bool have = i < s_nnames;
+        if (have) {
+            e = s_names[i];
+        }
+        portEXIT_CRITICAL(&s_names_lock);
+        if (!have) {
+            break;
+        }
+        printf("NAME %c 0x%08" PRIx32 " %s\n", e.task ? 'T' : 'O', (uint32_t)(uintptr_t)e.obj, e.name);
+    }
+
+    for (int c = 0; c < portNUM_PROCESSORS; c++) {
+        uint32_t head = s_head[c];
+        uint32_t first = head > TRACE_REC_RECORDS_PER_CORE ? head - TRACE_REC_RECORDS_PER_CORE : 0;
+        printf("CORE %d written=%" PRIu32 " lost=%" PRIu32 "\n", c, st.written[c], st.lost[c]);
+
+        for (uint32_t i = first; i < head; i += RECS_PER_LINE) {
+            printf("REC %d ", c);
+            for (uint32_t j = i; j < head && j < i + RECS_PER_LINE; j++) {
+                const uint8_t *b = (const uint8_t *)&s_ring[c][j & (TRACE_REC_RECORDS_PER_CORE - 1)];
+                for (size_t k = 0; k < sizeof(trace_rec_record_t); k++) {
+                    printf("%02x", b[k]);
+                }
+            }
+            printf("\n");
+        }
+    }
+    printf("TRACE-END\n");
+}
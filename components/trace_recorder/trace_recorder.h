@@ -0,0 +1,113 @@
+/**
+ * @file trace_recorder.h
+ * @brief Binary scheduler/queue/notify trace in per-core RAM rings, dumped as text for a host tool.
+ *
+ * ESP_LOGI() timestamps show what a task chose to print, at millisecond
+ * resolution and at the cost of a UART write. They cannot show a storm of
+ * context switches. trace_recorder uses the FreeRTOS trace macros
+ * (trace_hooks.h) to write one 16-byte record per event:
+ *   - task switched in / out, task create / delete
+ *   - queue send / receive, with failure, blocking and FromISR variants
+ *     (semaphores and mutexes are queues)
+ *   - task notify give (task and ISR) and take / wait
+ *   - trace_rec_user() markers from application code
+ *
+ * Each core writes only its own ring, with that core's interrupts masked
+ * for the few instructions a record takes. No lock is shared, and a hook
+ * never blocks. Timestamps are esp_timer microseconds, which both cores
+ * share. TRACE_REC_CLOCK_CCOUNT = 1 switches to the CPU cycle counter:
+ * finer resolution, but per core, so cross-core ordering is approximate.
+ *
+ * trace_rec_dump() stops recording and prints the name table and both
+ * rings as hex lines between TRACE-BEGIN and TRACE-END. The console log
+ * can then be turned into a Chrome/Perfetto timeline with
+ * Day_27_Runtime_Statistics_and_Trace_Tools/trace_convert.py.
+ *
+ * Usage:
+ *   // top-level CMakeLists.txt: force-include trace_hooks.h (see that file)
+ *   trace_rec_name(queue, "sensor_q");
+ *   trace_rec_start();
+ *   ...
+ *   trace_rec_dump();
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "trace_hooks.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef TRACE_REC_RECORDS_PER_CORE
+#define TRACE_REC_RECORDS_PER_CORE  2048    // Power of two; 16 bytes each
+#endif
+
+#ifndef TRACE_REC_OVERWRITE
+#define TRACE_REC_OVERWRITE         1       // 1: keep the newest records, 0: stop when full
+#endif
+
+#ifndef TRACE_REC_CLOCK_CCOUNT
+#define TRACE_REC_CLOCK_CCOUNT      0       // 1: CPU cycle counter instead of esp_timer µs
+#endif
+
+#ifndef TRACE_REC_MAX_NAMES
+#define TRACE_REC_MAX_NAMES         48      // Tasks (registered at creation) plus named objects
+#endif
+
+/** @brief One trace record, dumped as-is (little endian). */
+typedef struct {
+    uint32_t ts;                    //!< µs or cycles, wraps
+    uint32_t obj;                   //!< Task handle, queue handle or user id
+    uint32_t arg;                   //!< Queue depth before the call, notify index or user value
+    uint8_t type;                   //!< TRACE_EV_*
+    uint8_t core;
+    uint16_t reserved;
+} trace_rec_record_t;
+
+_Static_assert(sizeof(trace_rec_record_t) == 16, "trace record must stay 16 bytes");
+
+/** @brief Recorder counters. */
+typedef struct {
+    uint32_t written[portNUM_PROCESSORS];   //!< Records written per core since start
+    uint32_t lost[portNUM_PROCESSORS];      //!< Overwritten (TRACE_REC_OVERWRITE) or dropped
+} trace_rec_stats_t;
+
+/**
+ * @brief Clear the rings and start recording.
+ */
+void trace_rec_start(void);
+
+/**
+ * @brief Stop recording; the rings keep their content.
+ */
+void trace_rec_stop(void);
+
+/**
+ * @brief Name an object (queue, semaphore, timer) for the host tool.
+ *
+ * @return ESP_OK, ESP_ERR_NO_MEM if the name table is full.
+ */
+esp_err_t trace_rec_name(const void *obj, const char *name);
+
+/**
+ * @brief Record an application marker (shown as an instant event).
+ */
+void trace_rec_user(uint32_t id, uint32_t value);
+
+/**
+ * @brief Copy the recorder counters.
+ */
+void trace_rec_get_stats(trace_rec_stats_t *out);
+
+/**
+ * @brief Stop recording and print the trace to the console for trace_convert.py.
+ */
+void trace_rec_dump(void);
+
+#ifdef __cplusplus
+}
+#endif
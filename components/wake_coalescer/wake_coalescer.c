@@ -0,0 +1,195 @@
+/**
+ * @file wake_coalescer.c
+ * @brief Tolerance-window job scheduler for fewer wakeups (see wake_coalescer.h).
+ *
+ * Choosing the wake time as the minimum of (due + tolerance) over all jobs
+ * is the latest moment that still meets every window. Running everything
+ * already due at that moment gives the largest batch the windows allow
+ * without looking ahead. The tick count is the only clock, so the
+ * scheduler itself never keeps the CPU awake.
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+#include "sdkconfig.h"
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "wake_coalescer.h"
+
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#endif
+
+static wake_job_t *s_jobs[WAKE_COALESCER_MAX_JOBS];
+static int s_njobs;
+static TaskHandle_t s_task;
+static int64_t s_start_us;
+static wake_coalescer_stats_t s_stats;
+static portMUX_TYPE s_lock = portMUX_INITIALIZER_UNLOCKED;
+
+// ------------------------ Light-sleep accounting ------------------------
+
+#if CONFIG_PM_ENABLE && CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+/**
+ * @brief Runs in the idle task right after each light sleep; adds the slept time.
+ */
+static IRAM_ATTR esp_err_t on_light_sleep_exit(int64_t sleep_time_us, void *arg)
+{
+    portENTER_CRITICAL_SAFE(&s_lock);
+    s_stats.sleeps++;
+    s_stats.slept_us += (uint64_t)sleep_time_us;
+    portEXIT_CRITICAL_SAFE(&s_lock);
+    return ESP_OK;
+}
+#endif
+
+// ------------------------ Scheduler ------------------------
+
+/**
+ * @brief Wake at the earliest window end, run every due job, repeat.
+ *
+ * @param arg Unused.
+ */
+static void wake_coalescer_task(void *arg)
+{
+    wake_job_t *due[WAKE_COALESCER_MAX_JOBS];
+
+    while (1) {
+        TickType_t now = xTaskGetTickCount();
+        TickType_t wait = portMAX_DELAY;
+        int n = 0;
+
+        portENTER_CRITICAL(&s_lock);
+        for (int i = 0; i < s_njobs; i++) {
+            wake_job_t *job = s_jobs[i];
+            if ((int32_t)(now - job->due) >= 0) {
+                due[n++] = job;
+                job->runs++;
+                job->due += job->period;
+                // Starved past whole windows: skip them instead of bursting
+                while ((int32_t)(now - (job->due + job->tolerance)) > 0) {
+                    job->due += job->period;
+                    job->missed++;
+                }
+            }
+            TickType_t left = job->due + job->tolerance - now;
+            if ((int32_t)left < 0) {
+                left = 0;
+            }
+            if (left < wait) {
+                wait = left;
+            }
+        }
+        if (n > 0) {
+            s_stats.wakeups++;
+            s_stats.runs += (uint32_t)n;
+        }
+        portEXIT_CRITICAL(&s_lock);
+
+        for (int i = 0; i < n; i++) {
+            if (due[i]->cfg.callback != NULL) {
+                due[i]->cfg.callback(due[i]->cfg.arg);
+            } else {
+                xTaskNotifyGive(due[i]->cfg.notify_task);
+            }
+        }
+
+        // New jobs notify the scheduler so their first window is not missed
+        ulTaskNotifyTake(pdTRUE, wait);
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t wake_coalescer_start(UBaseType_t priority, BaseType_t core)
+{
+    if (s_task != NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_start_us = esp_timer_get_time();
+    if (xTaskCreatePinnedToCore(wake_coalescer_task, "wake_coal", 3072, NULL,
+                                priority, &s_task, core) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t wake_coalescer_add(wake_job_t *job, const wake_job_config_t *cfg)
+{
+    if (job == NULL || cfg == NULL || cfg->period_ms == 0 ||
+        (cfg->callback == NULL) == (cfg->notify_task == NULL)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    job->cfg = *cfg;
+    job->period = pdMS_TO_TICKS(cfg->period_ms) ? pdMS_TO_TICKS(cfg->period_ms) : 1;
+    job->tolerance = pdMS_TO_TICKS(cfg->tolerance_ms);
+    job->runs = 0;
+    job->missed = 0;
+
+    portENTER_CRITICAL(&s_lock);
+    if (s_njobs == WAKE_COALESCER_MAX_JOBS) {
+        portEXIT_CRITICAL(&s_lock);
+        return ESP_ERR_NO_MEM;
+    }
+    job->due = xTaskGetTickCount() + (cfg->first_ms ? pdMS_TO_TICKS(cfg->first_ms) : job->period);
+    s_jobs[s_njobs++] = job;
+    portEXIT_CRITICAL(&s_lock);
+
+    if (s_task != NULL) {
+        xTaskNotifyGive(s_task);
+    }
+    return ESP_OK;
+}
+
+esp_err_t wake_coalescer_enable_light_sleep(int max_freq_mhz, int min_freq_mhz)
+{
+#if CONFIG_PM_ENABLE
+    esp_pm_config_t pm = {
+        .max_freq_mhz = max_freq_mhz,
+        .min_freq_mhz = min_freq_mhz,
+        .light_sleep_enable = true,
+    };
+    esp_err_t err = esp_pm_configure(&pm);
+    if (err != ESP_OK) {
+        return err;
+    }
+#if CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+    esp_pm_sleep_cbs_register_config_t cbs = {
+        .exit_cb = on_light_sleep_exit,
+    };
+    err = esp_pm_light_sleep_register_cbs(&cbs);
+#endif
+    return err;
+#else
+    (void)max_freq_mhz;
+    (void)min_freq_mhz;
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+void wake_coalescer_get_stats(wake_coalescer_stats_t *out)
+{
+    portENTER_CRITICAL(&s_lock);
+    *out = s_stats;
+    portEXIT_CRITICAL(&s_lock);
+    out->saved = out->runs - out->wakeups;
+    out->elapsed_us = (uint64_t)(esp_timer_get_time() - s_start_us);
+}
+
+void wake_coalescer_report(void)
+{
+    wake_coalescer_stats_t st;
+    wake_coalescer_get_stats(&st);
+
+    uint32_t saved_pct = st.runs ? st.saved * 100 / st.runs : 0;
+    printf("[WAKE] %" PRIu32 " s: %" PRIu32 " wakeups for %" PRIu32 " job runs, %" PRIu32 " saved (%" PRIu32 "%%)",
+           (uint32_t)(st.elapsed_us / 1000000), st.wakeups, st.runs, st.saved, saved_pct);
+#if CONFIG_PM_ENABLE && CONFIG_PM_LIGHT_SLEEP_CALLBACKS
+    printf(" | slept %" PRIu32 " ms (%.1f%%) in %" PRIu32 " sleeps\n",
+           (uint32_t)(st.slept_us / 1000),
+           st.elapsed_us ? (double)st.slept_us * 100.0 / (double)st.elapsed_us : 0.0, st.sleeps);
+#else
+    printf(" | sleep time n/a (needs CONFIG_PM_LIGHT_SLEEP_CALLBACKS)\n");
+#endif
+}
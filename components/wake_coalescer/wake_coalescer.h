@@ -0,0 +1,114 @@
+/**
+ * @file wake_coalescer.h
+ * @brief Periodic jobs with tolerance windows, batched so the CPU wakes less often.
+ *
+ * Tasks that each run their own vTaskDelay()/vTaskDelayUntil() loop wake
+ * the CPU at every one of their deadlines. With tickless idle, every wakeup
+ * ends a light-sleep window. wake_coalescer replaces those loops with
+ * registered jobs. Each job has a period and a tolerance: it may run up to
+ * tolerance_ms after its nominal time, never before it.
+ *
+ * One scheduler task sleeps until the earliest *latest* time of any job.
+ * It then runs every job that is already due, so jobs whose windows overlap
+ * share one wakeup. Nominal times advance by whole periods, so a delayed run
+ * does not shift the schedule (no drift, jitter bounded by tolerance_ms).
+ *
+ * A job either runs a short callback in the scheduler task, or notifies its
+ * own task (xTaskNotifyGive()). That task blocks in ulTaskNotifyTake() in
+ * place of its old delay call.
+ *
+ * wake_coalescer_enable_light_sleep() configures esp_pm for automatic light
+ * sleep. It needs CONFIG_PM_ENABLE and CONFIG_FREERTOS_USE_TICKLESS_IDLE.
+ * With CONFIG_PM_LIGHT_SLEEP_CALLBACKS the time actually spent in light
+ * sleep is measured as well. wake_coalescer_report() prints, for the job
+ * set of wake_coalescing_demo.c with COALESCE=1:
+ *   [WAKE] 60 s: 360 wakeups for 509 job runs, 149 saved (29%) | slept ...
+ * The counts follow from the periods, tolerances and phases. The sleep
+ * column depends on the board and on what else wakes the CPU.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef WAKE_COALESCER_MAX_JOBS
+#define WAKE_COALESCER_MAX_JOBS 16
+#endif
+
+typedef void (*wake_job_cb_t)(void *arg);
+
+/**
+ * @brief Job description; set either callback or notify_task.
+ */
+typedef struct {
+    const char *name;
+    uint32_t period_ms;
+    uint32_t tolerance_ms;          //!< Allowed lateness; 0 = run exactly on time
+    uint32_t first_ms;              //!< Delay of the first run [period_ms]
+    wake_job_cb_t callback;         //!< Runs in the scheduler task; keep it short
+    void *arg;
+    TaskHandle_t notify_task;       //!< Or: task woken with xTaskNotifyGive()
+} wake_job_config_t;
+
+/**
+ * @brief Job object; all fields are private.
+ */
+typedef struct {
+    wake_job_config_t cfg;
+    TickType_t period;
+    TickType_t tolerance;
+    TickType_t due;                 //!< Nominal time of the next run
+    uint32_t runs;
+    uint32_t missed;                //!< Windows missed entirely (scheduler starved)
+} wake_job_t;
+
+/** @brief Counters since wake_coalescer_start(). */
+typedef struct {
+    uint32_t wakeups;               //!< Scheduler wakeups that ran at least one job
+    uint32_t runs;                  //!< Job runs
+    uint32_t saved;                 //!< runs - wakeups: runs that shared a wakeup
+    uint32_t sleeps;                //!< Light-sleep entries (callbacks enabled)
+    uint64_t slept_us;              //!< Time in light sleep (callbacks enabled)
+    uint64_t elapsed_us;            //!< Since wake_coalescer_start()
+} wake_coalescer_stats_t;
+
+/**
+ * @brief Start the scheduler task.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already running, ESP_ERR_NO_MEM.
+ */
+esp_err_t wake_coalescer_start(UBaseType_t priority, BaseType_t core);
+
+/**
+ * @brief Register a job; may be called before or after wake_coalescer_start().
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM (all job slots used).
+ */
+esp_err_t wake_coalescer_add(wake_job_t *job, const wake_job_config_t *cfg);
+
+/**
+ * @brief Enable automatic light sleep between wakeups (DFS between the two frequencies).
+ *
+ * @return ESP_OK, ESP_ERR_NOT_SUPPORTED without CONFIG_PM_ENABLE, or the esp_pm error.
+ */
+esp_err_t wake_coalescer_enable_light_sleep(int max_freq_mhz, int min_freq_mhz);
+
+/**
+ * @brief Copy the counters.
+ */
+void wake_coalescer_get_stats(wake_coalescer_stats_t *out);
+
+/**
+ * @brief Print the counters as one [WAKE] line.
+ */
+void wake_coalescer_report(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,314 @@
+/**
+ * @file work_steal.c
+ * @brief Per-core deques with range splitting and stealing (see work_steal.h).
+ *
+ * A parallel-for counts down an element counter. Every leaf range
+ * subtracts its length when it finishes, and the one that reaches zero
+ * wakes the caller. Ranges are never split further once they sit in a
+ * deque, so the count stays exact however often a range was stolen.
+ *
+ * Sleep and wake protocol. Before blocking, a worker sets its idle flag
+ * and then checks the deques once more. A pusher writes the range and then
+ * reads the flag. With seq_cst atomics on both sides, at least one of them
+ * sees the other. Task notifications are counted, so a notification sent
+ * just before ulTaskNotifyTake() is not lost.
+ */
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include <inttypes.h>
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "work_steal.h"
+
+_Static_assert((WORK_STEAL_DEQUE_SIZE & (WORK_STEAL_DEQUE_SIZE - 1)) == 0,
+               "WORK_STEAL_DEQUE_SIZE must be a power of two");
+
+typedef struct {
+    work_steal_range_fn_t fn;
+    void *arg;
+    uint32_t grain;
+    atomic_uint remaining;          //!< Elements not yet processed
+    SemaphoreHandle_t done;
+    StaticSemaphore_t done_buf;
+} group_t;
+
+typedef struct {
+    group_t *g;
+    uint32_t begin;
+    uint32_t end;
+} range_t;
+
+typedef struct {
+    range_t items[WORK_STEAL_DEQUE_SIZE];
+    uint32_t top;                   //!< Thieves take here (oldest)
+    uint32_t bottom;                //!< Owner pushes and pops here (newest)
+    portMUX_TYPE lock;
+} deque_t;
+
+typedef struct {
+    deque_t dq;
+    TaskHandle_t task;
+    atomic_bool idle;
+    work_steal_stats_t st;
+    portMUX_TYPE st_lock;
+} worker_t;
+
+static worker_t s_w[portNUM_PROCESSORS];
+static atomic_int s_active = portNUM_PROCESSORS;
+static bool s_started;
+
+// ------------------------ Deque ------------------------
+
+static bool push_bottom(deque_t *d, const range_t *r)
+{
+    bool ok = false;
+    portENTER_CRITICAL(&d->lock);
+    if (d->bottom - d->top < WORK_STEAL_DEQUE_SIZE) {
+        d->items[d->bottom & (WORK_STEAL_DEQUE_SIZE - 1)] = *r;
+        d->bottom++;
+        ok = true;
+    }
+    portEXIT_CRITICAL(&d->lock);
+    return ok;
+}
+
+static bool pop_bottom(deque_t *d, range_t *r)
+{
+    bool ok = false;
+    portENTER_CRITICAL(&d->lock);
+    if (d->bottom != d->top) {
+        d->bottom--;
+        *r = d->items[d->bottom & (WORK_STEAL_DEQUE_SIZE - 1)];
+        ok = true;
+    }
+    portEXIT_CRITICAL(&d->lock);
+    return ok;
+}
+
+static bool steal_top(deque_t *d, range_t *r)
+{
+    bool ok = false;
+    portENTER_CRITICAL(&d->lock);
+    if (d->bottom != d->top) {
+        *r = d->items[d->top & (WORK_STEAL_DEQUE_SIZE - 1)];
+        d->top++;
+        ok = true;
+    }
+    portEXIT_CRITICAL(&d->lock);
+    return ok;
+}
+
+// ------------------------ Worker ------------------------
+
+/**
+ * @brief Wake every other active worker that is blocked waiting for work.
+ */
+static void wake_idle(int self)
+{
+    int active = atomic_load(&s_active);
+    for (int i = 0; i < active; i++) {
+        if (i != self && atomic_load(&s_w[i].idle)) {
+            xTaskNotifyGive(s_w[i].task);
+        }
+    }
+}
+
+/**
+ * @brief Own deque first, then steal from the others.
+ */
+static bool find_work(int self, range_t *r, bool *stolen)
+{
+    *stolen = false;
+    if (pop_bottom(&s_w[self].dq, r)) {
+        return true;
+    }
+    int active = atomic_load(&s_active);
+    for (int i = 1; i < active; i++) {
+        int victim = (self + i) % active;
+        if (steal_top(&s_w[victim].dq, r)) {
+            *stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Halve @p r down to the grain, pushing upper halves, then run the rest.
+ */
+static void run_range(int self, range_t r, bool stolen)
+{
+    worker_t *w = &s_w[self];
+    group_t *g = r.g;
+    uint32_t splits = 0;
+
+    while (r.end - r.begin > g->grain) {
+        range_t hi = { .g = g, .begin = r.begin + (r.end - r.begin) / 2, .end = r.end };
+        if (!push_bottom(&w->dq, &hi)) {
+            break;                  // Deque full: run the whole remainder here
+        }
+        r.end = hi.begin;
+        splits++;
+        wake_idle(self);
+    }
+
+    uint32_t n = r.end - r.begin;
+    int64_t t0 = esp_timer_get_time();
+    g->fn(g->arg, r.begin, r.end);
+    int64_t busy = esp_timer_get_time() - t0;
+
+    portENTER_CRITICAL(&w->st_lock);
+    w->st.ranges++;
+    w->st.elements += n;
+    w->st.splits += splits;
+    w->st.steals += stolen ? 1 : 0;
+    w->st.busy_us += (uint64_t)busy;
+    portEXIT_CRITICAL(&w->st_lock);
+
+    if (atomic_fetch_sub(&g->remaining, n) == n) {
+        xSemaphoreGive(g->done);    // Last range of this parallel-for
+    }
+}
+
+/**
+ * @brief Run ranges while any can be found; block otherwise.
+ *
+ * @param arg Worker index (= core).
+ */
+static void work_steal_task(void *arg)
+{
+    int self = (int)(intptr_t)arg;
+    worker_t *w = &s_w[self];
+    range_t r;
+    bool stolen;
+
+    while (1) {
+        if (self < atomic_load(&s_active) && find_work(self, &r, &stolen)) {
+            run_range(self, r, stolen);
+            continue;
+        }
+
+        atomic_store(&w->idle, true);
+        if (self < atomic_load(&s_active) && find_work(self, &r, &stolen)) {
+            atomic_store(&w->idle, false);
+            run_range(self, r, stolen);
+            continue;
+        }
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        atomic_store(&w->idle, false);
+
+        portENTER_CRITICAL(&w->st_lock);
+        w->st.sleeps++;
+        portEXIT_CRITICAL(&w->st_lock);
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t work_steal_init(UBaseType_t priority, uint32_t stack_size)
+{
+    if (s_started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        memset(&s_w[i], 0, sizeof(s_w[i]));
+        portMUX_INITIALIZE(&s_w[i].dq.lock);
+        portMUX_INITIALIZE(&s_w[i].st_lock);
+        atomic_init(&s_w[i].idle, false);
+    }
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "ws%d", i);
+        if (xTaskCreatePinnedToCore(work_steal_task, name, stack_size ? stack_size : 4096,
+                                    (void *)(intptr_t)i, priority, &s_w[i].task, i) != pdPASS) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    s_started = true;
+    return ESP_OK;
+}
+
+void work_steal_set_workers(int n)
+{
+    if (n < 1) {
+        n = 1;
+    }
+    if (n > portNUM_PROCESSORS) {
+        n = portNUM_PROCESSORS;
+    }
+    atomic_store(&s_active, n);
+}
+
+esp_err_t work_steal_parallel_for(uint32_t begin, uint32_t end, uint32_t grain,
+                                  work_steal_range_fn_t fn, void *arg)
+{
+    if (fn == NULL || end < begin) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!s_started) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        if (s_w[i].task == self) {
+            return ESP_ERR_INVALID_STATE;   // Would wait on work only it can run
+        }
+    }
+    if (begin == end) {
+        return ESP_OK;
+    }
+
+    group_t g = {
+        .fn = fn,
+        .arg = arg,
+        .grain = grain ? grain : 1,
+    };
+    atomic_init(&g.remaining, end - begin);
+    g.done = xSemaphoreCreateBinaryStatic(&g.done_buf);
+
+    // Start on the caller's core so the data is warm there; the other core steals it
+    int core = xPortGetCoreID();
+    if (core >= atomic_load(&s_active)) {
+        core = 0;
+    }
+    range_t root = { .g = &g, .begin = begin, .end = end };
+    if (!push_bottom(&s_w[core].dq, &root)) {
+        fn(arg, begin, end);        // Both deques busy with other callers: run inline
+        vSemaphoreDelete(g.done);
+        return ESP_OK;
+    }
+    if (atomic_load(&s_w[core].idle)) {
+        xTaskNotifyGive(s_w[core].task);
+    }
+    wake_idle(core);
+
+    xSemaphoreTake(g.done, portMAX_DELAY);
+    vSemaphoreDelete(g.done);
+    return ESP_OK;
+}
+
+void work_steal_get_stats(int core, work_steal_stats_t *out, bool reset)
+{
+    worker_t *w = &s_w[core];
+    portENTER_CRITICAL(&w->st_lock);
+    *out = w->st;
+    if (reset) {
+        memset(&w->st, 0, sizeof(w->st));
+    }
+    portEXIT_CRITICAL(&w->st_lock);
+}
+
+void work_steal_report(void)
+{
+    for (int i = 0; i < portNUM_PROCESSORS; i++) {
+        work_steal_stats_t st;
+        work_steal_get_stats(i, &st, true);
+        printf("[WS] core%d ranges=%" PRIu32 " elems=%" PRIu32 " splits=%" PRIu32 " steals=%" PRIu32
+               " sleeps=%" PRIu32 " busy=%" PRIu32 " ms\n",
+               i, st.ranges, st.elements, st.splits, st.steals, st.sleeps, (uint32_t)(st.busy_us / 1000));
+    }
+}
@@ -0,0 +1,90 @@
+/**
+ * @file work_steal.h
+ * @brief One worker per core with a local deque; idle workers steal from the other core.
+ *
+ * Pinning a task fixes where its work runs, and unpinning leaves placement
+ * to the scheduler. work_steal sits between the two. A parallel-for range
+ * starts on the deque of the caller's core. The worker that runs a range
+ * halves it until it reaches the grain size, keeps the lower half and
+ * pushes the upper half to the bottom of its own deque. A worker with an
+ * empty deque takes from the top of the other core's deque, which holds
+ * the oldest and largest pieces. Each core therefore ends up with work in
+ * proportion to how fast it finishes, with no pinning decision made in
+ * advance.
+ *
+ * Each deque is a fixed ring guarded by its own spinlock. Its owner pushes
+ * and pops at the bottom, and thieves take from the top. Nothing is
+ * allocated after work_steal_init().
+ *
+ * Usage:
+ *   static void fir_range(void *arg, uint32_t begin, uint32_t end) { ... }
+ *   work_steal_init(5, 4096);
+ *   work_steal_parallel_for(0, N, 256, fir_range, &ctx);   // blocks until done
+ *   work_steal_report();
+ *
+ * Do not call work_steal_parallel_for() from inside a range function.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef WORK_STEAL_DEQUE_SIZE
+#define WORK_STEAL_DEQUE_SIZE 64    // Ranges per deque (power of two); a full deque stops splitting
+#endif
+
+/** @brief Range body: process elements [begin, end). */
+typedef void (*work_steal_range_fn_t)(void *arg, uint32_t begin, uint32_t end);
+
+/** @brief Per-worker counters. */
+typedef struct {
+    uint32_t ranges;                //!< Leaf ranges executed
+    uint32_t elements;              //!< Elements in those ranges
+    uint32_t splits;                //!< Ranges halved and pushed
+    uint32_t steals;                //!< Ranges taken from the other deque
+    uint32_t sleeps;                //!< Times the worker found no work and blocked
+    uint64_t busy_us;               //!< Time spent in range functions
+} work_steal_stats_t;
+
+/**
+ * @brief Create one worker per core, pinned, at @p priority with @p stack_size bytes.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if already running, ESP_ERR_NO_MEM.
+ */
+esp_err_t work_steal_init(UBaseType_t priority, uint32_t stack_size);
+
+/**
+ * @brief Limit how many workers take part (1..portNUM_PROCESSORS); for one-core vs two-core runs.
+ *
+ * Worker 0 (core 0) stays active. Call it between parallel-for runs, not during one.
+ */
+void work_steal_set_workers(int n);
+
+/**
+ * @brief Run @p fn over [begin, end) in ranges of at most @p grain elements and wait for all of them.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_INVALID_STATE if not initialised
+ *         or called from a worker.
+ */
+esp_err_t work_steal_parallel_for(uint32_t begin, uint32_t end, uint32_t grain,
+                                  work_steal_range_fn_t fn, void *arg);
+
+/**
+ * @brief Copy the counters of worker @p core, optionally resetting them.
+ */
+void work_steal_get_stats(int core, work_steal_stats_t *out, bool reset);
+
+/**
+ * @brief Print one "[WS]" line per worker and reset the counters.
+ */
+void work_steal_report(void);
+
+#ifdef __cplusplus
+}
+#endif
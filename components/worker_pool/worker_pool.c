@@ -0,0 +1,196 @@
+/**
+ * @file worker_pool.c
+ * @brief Pre-created worker tasks fed by a queue of job descriptors (see worker_pool.h).
+ *
+ * Cancellation protocol (seq_cst atomics on both sides):
+ *   cancel : set the token, then read the status
+ *   worker : CAS QUEUED -> RUNNING, then read the token
+ * If the canceller read QUEUED, the worker's later token read sees the
+ * request and the function is skipped. If it read RUNNING, the function
+ * may already be running and must poll worker_job_cancelled().
+ * A cancelled job stays in the queue until a worker dequeues it, so a
+ * descriptor is never in the queue twice. A job that ran ends CANCELLED
+ * only if its function saw the token; a late cancel leaves it DONE.
+ *
+ * Each run ends with exactly one give of job->done, the worker's last
+ * access to the descriptor. worker_job_wait() trusts only that give and
+ * puts it back. Before a finished job is reused, worker_job_init() or
+ * worker_pool_submit() takes it, waiting for the worker if it has set the
+ * final status but not given yet. So no give of an old run can wake a
+ * waiter of the next one.
+ */
+
+#include <stdio.h>
+#include "worker_pool.h"
+
+// ------------------------ Worker ------------------------
+
+/**
+ * @brief Takes jobs from the pool queue forever.
+ *
+ * @param arg The worker_pool_t.
+ */
+static void worker_task(void *arg)
+{
+    worker_pool_t *pool = (worker_pool_t *)arg;
+    worker_job_t *job;
+
+    while (1) {
+        if (xQueueReceive(pool->queue, &job, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        int expected = WORKER_JOB_QUEUED;
+        bool started = atomic_compare_exchange_strong(&job->status, &expected, WORKER_JOB_RUNNING);
+        bool skip = !started || atomic_load(&job->cancel);
+
+        if (!skip) {
+            portENTER_CRITICAL(&pool->lock);
+            pool->st.busy++;
+            portEXIT_CRITICAL(&pool->lock);
+
+            job->result = job->fn(job, job->arg);
+
+            portENTER_CRITICAL(&pool->lock);
+            pool->st.busy--;
+            portEXIT_CRITICAL(&pool->lock);
+        }
+
+        bool cancelled = skip || atomic_load(&job->cancel_seen);
+        portENTER_CRITICAL(&pool->lock);
+        if (cancelled) {
+            pool->st.cancelled++;
+        } else {
+            pool->st.completed++;
+        }
+        portEXIT_CRITICAL(&pool->lock);
+
+        atomic_store(&job->status, cancelled ? WORKER_JOB_CANCELLED : WORKER_JOB_DONE);
+        // Last access to the descriptor: the owner may reuse it after the give
+        xSemaphoreGive(job->done);
+    }
+}
+
+// ------------------------ API ------------------------
+
+esp_err_t worker_pool_init(worker_pool_t *pool, const worker_pool_config_t *cfg)
+{
+    if (pool == NULL || cfg == NULL || cfg->workers == 0 || cfg->workers > WORKER_POOL_MAX_WORKERS ||
+        cfg->queue_len == 0 || cfg->stack_size == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    *pool = (worker_pool_t) { 0 };
+    portMUX_INITIALIZE(&pool->lock);
+    pool->queue = xQueueCreate(cfg->queue_len, sizeof(worker_job_t *));
+    if (pool->queue == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+
+    for (uint32_t i = 0; i < cfg->workers; i++) {
+        char name[configMAX_TASK_NAME_LEN];
+        snprintf(name, sizeof(name), "%s%u", cfg->name ? cfg->name : "wp", (unsigned)i);
+        BaseType_t core = cfg->spread ? (BaseType_t)(i % portNUM_PROCESSORS) : cfg->core;
+        if (xTaskCreatePinnedToCore(worker_task, name, cfg->stack_size, pool, cfg->priority,
+                                    &pool->workers[i], core) != pdPASS) {
+            return ESP_ERR_NO_MEM;  // Workers created so far keep serving the queue
+        }
+        pool->nworkers++;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Take the final give of a finished run; it may still be on its way from the worker.
+ *
+ * @return false if the job is queued or running.
+ */
+static bool claim_finished(worker_job_t *job)
+{
+    int state = atomic_load(&job->status);
+    if (state == WORKER_JOB_QUEUED || state == WORKER_JOB_RUNNING) {
+        return false;
+    }
+    if (state == WORKER_JOB_DONE || state == WORKER_JOB_CANCELLED) {
+        xSemaphoreTake(job->done, portMAX_DELAY);
+    }
+    return true;
+}
+
+esp_err_t worker_job_init(worker_job_t *job, worker_job_fn_t fn, void *arg)
+{
+    if (job->done == NULL) {
+        job->done = xSemaphoreCreateBinaryStatic(&job->done_buf);
+        atomic_store(&job->status, WORKER_JOB_IDLE);
+    } else if (!claim_finished(job)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    job->fn = fn;
+    job->arg = arg;
+    job->result = ESP_OK;
+    atomic_store(&job->cancel, false);
+    atomic_store(&job->cancel_seen, false);
+    atomic_store(&job->status, WORKER_JOB_IDLE);
+    return ESP_OK;
+}
+
+esp_err_t worker_pool_submit(worker_pool_t *pool, worker_job_t *job, TickType_t wait)
+{
+    if (job->done == NULL || job->fn == NULL) {
+        return ESP_ERR_INVALID_STATE;   // worker_job_init() not called
+    }
+
+    if (!claim_finished(job)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    int state = atomic_load(&job->status);
+    if (state == WORKER_JOB_QUEUED || state == WORKER_JOB_RUNNING ||
+        !atomic_compare_exchange_strong(&job->status, &state, WORKER_JOB_QUEUED)) {
+        return ESP_ERR_INVALID_STATE;   // Submitted concurrently by another task
+    }
+    atomic_store(&job->cancel, false);
+    atomic_store(&job->cancel_seen, false);
+
+    if (xQueueSend(pool->queue, &job, wait) != pdTRUE) {
+        atomic_store(&job->status, WORKER_JOB_IDLE);
+        portENTER_CRITICAL(&pool->lock);
+        pool->st.rejected++;
+        portEXIT_CRITICAL(&pool->lock);
+        return ESP_ERR_TIMEOUT;
+    }
+
+    uint32_t depth = (uint32_t)uxQueueMessagesWaiting(pool->queue);
+    portENTER_CRITICAL(&pool->lock);
+    pool->st.submitted++;
+    if (depth > pool->st.max_depth) {
+        pool->st.max_depth = depth;
+    }
+    portEXIT_CRITICAL(&pool->lock);
+    return ESP_OK;
+}
+
+bool worker_job_cancel(worker_job_t *job)
+{
+    atomic_store(&job->cancel, true);
+    return atomic_load(&job->status) == WORKER_JOB_QUEUED;
+}
+
+worker_job_status_t worker_job_wait(worker_job_t *job, TickType_t wait)
+{
+    if (worker_job_status(job) == WORKER_JOB_IDLE) {
+        return WORKER_JOB_IDLE;         // Never submitted: no give will come
+    }
+    // The status alone may be final before the worker's give; only the give ends the run
+    if (xSemaphoreTake(job->done, wait) != pdTRUE) {
+        return worker_job_status(job);
+    }
+    xSemaphoreGive(job->done);          // Keep later waits on a finished job immediate
+    return worker_job_status(job);
+}
+
+void worker_pool_get_stats(worker_pool_t *pool, worker_pool_stats_t *out)
+{
+    portENTER_CRITICAL(&pool->lock);
+    *out = pool->st;
+    portEXIT_CRITICAL(&pool->lock);
+}
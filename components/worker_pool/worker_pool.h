@@ -0,0 +1,188 @@
+/**
+ * @file worker_pool.h
+ * @brief Fixed pool of pre-created, pinned worker tasks that run job descriptors from a queue.
+ *
+ * Creating a task for every short job costs a TCB and stack allocation,
+ * and a deferred free by the idle task after vTaskDelete(). Thousands of
+ * those an hour fragment the heap. worker_pool creates its workers once.
+ * After that, running a job costs one queue send and one queue receive,
+ * and the heap is not touched at all.
+ *
+ * A job is a caller-owned worker_job_t: function, argument, status, and a
+ * static binary semaphore for worker_job_wait(). Only the descriptor's
+ * address travels through the queue.
+ *
+ * Cancellation without vTaskDelete():
+ *   - a queued job that is cancelled is skipped by the worker, and its
+ *     function never runs
+ *   - a running job sees worker_job_cancelled() become true and returns at
+ *     its next safe point, releasing whatever it holds
+ * Either way the job ends in WORKER_JOB_CANCELLED and its waiter is woken.
+ * A cancel that comes after the function returned, or that the function
+ * never checked, leaves the job WORKER_JOB_DONE.
+ *
+ * Usage:
+ *   static worker_pool_t pool;
+ *   static worker_job_t job;
+ *   worker_pool_config_t cfg = { .name = "wp", .workers = 4, .queue_len = 16,
+ *                                .stack_size = 3072, .priority = 5, .spread = true };
+ *   worker_pool_init(&pool, &cfg);
+ *   worker_job_init(&job, my_fn, my_arg);
+ *   worker_pool_submit(&pool, &job, portMAX_DELAY);
+ *   ...
+ *   worker_job_cancel(&job);                    // optional
+ *   worker_job_wait(&job, portMAX_DELAY);
+ */
+#pragma once
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef WORKER_POOL_MAX_WORKERS
+#define WORKER_POOL_MAX_WORKERS 8
+#endif
+
+/** @brief Life cycle of a job. */
+typedef enum {
+    WORKER_JOB_IDLE,                //!< Initialised, not submitted
+    WORKER_JOB_QUEUED,
+    WORKER_JOB_RUNNING,
+    WORKER_JOB_DONE,
+    WORKER_JOB_CANCELLED,
+} worker_job_status_t;
+
+typedef struct worker_job worker_job_t;
+
+/** @brief Job body; return value is stored in job->result. */
+typedef esp_err_t (*worker_job_fn_t)(worker_job_t *job, void *arg);
+
+/**
+ * @brief Job descriptor; fields other than result are private.
+ */
+struct worker_job {
+    worker_job_fn_t fn;
+    void *arg;
+    atomic_int status;              //!< worker_job_status_t
+    atomic_bool cancel;             //!< Cancellation token
+    atomic_bool cancel_seen;        //!< The function saw the token
+    esp_err_t result;
+    SemaphoreHandle_t done;
+    StaticSemaphore_t done_buf;
+};
+
+/**
+ * @brief Pool settings.
+ */
+typedef struct {
+    const char *name;               //!< Worker task name prefix
+    uint32_t workers;               //!< 1..WORKER_POOL_MAX_WORKERS
+    uint32_t queue_len;             //!< Pending jobs before submit blocks
+    uint32_t stack_size;            //!< Bytes per worker
+    UBaseType_t priority;
+    BaseType_t core;                //!< Core for all workers, or tskNO_AFFINITY
+    bool spread;                    //!< true: alternate workers over the cores (overrides core)
+} worker_pool_config_t;
+
+/** @brief Pool counters. */
+typedef struct {
+    uint32_t submitted;
+    uint32_t completed;
+    uint32_t cancelled;             //!< Skipped while queued or stopped while running
+    uint32_t rejected;              //!< Submit timed out on a full queue
+    uint32_t max_depth;             //!< Deepest queue seen at submit
+    uint32_t busy;                  //!< Workers running a job right now
+} worker_pool_stats_t;
+
+/**
+ * @brief Pool object; all fields are private.
+ */
+typedef struct {
+    QueueHandle_t queue;
+    TaskHandle_t workers[WORKER_POOL_MAX_WORKERS];
+    uint32_t nworkers;
+    portMUX_TYPE lock;
+    worker_pool_stats_t st;
+} worker_pool_t;
+
+/**
+ * @brief Create the queue and the worker tasks (the only allocations the pool makes).
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_ARG, ESP_ERR_NO_MEM.
+ */
+esp_err_t worker_pool_init(worker_pool_t *pool, const worker_pool_config_t *cfg);
+
+/**
+ * @brief Prepare @p job for (re)submission.
+ *
+ * @p job must be zero-initialised or initialised before. A finished job is
+ * reclaimed first (see worker_job_wait()).
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if the job is queued or running.
+ */
+esp_err_t worker_job_init(worker_job_t *job, worker_job_fn_t fn, void *arg);
+
+/**
+ * @brief Queue @p job.
+ *
+ * @return ESP_OK, ESP_ERR_INVALID_STATE if the job is queued or running,
+ *         ESP_ERR_TIMEOUT if the queue stayed full for @p wait.
+ */
+esp_err_t worker_pool_submit(worker_pool_t *pool, worker_job_t *job, TickType_t wait);
+
+/**
+ * @brief Request cancellation.
+ *
+ * @return true if the job had not started yet (its function will not run).
+ */
+bool worker_job_cancel(worker_job_t *job);
+
+/**
+ * @brief For job bodies: true once cancellation was requested; return soon.
+ *
+ * A true result marks the job to end CANCELLED.
+ */
+static inline bool worker_job_cancelled(worker_job_t *job)
+{
+    if (!atomic_load_explicit(&job->cancel, memory_order_relaxed)) {
+        return false;
+    }
+    atomic_store_explicit(&job->cancel_seen, true, memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief Current status of @p job.
+ */
+static inline worker_job_status_t worker_job_status(const worker_job_t *job)
+{
+    return (worker_job_status_t)atomic_load(&job->status);
+}
+
+/**
+ * @brief Block until the worker has handed @p job back (DONE or CANCELLED).
+ *
+ * Returns when the worker's final give arrives, never on the status
+ * alone, so the job may be re-initialised right after.
+ *
+ * @return Final status, IDLE if never submitted, or the current status on timeout.
+ */
+worker_job_status_t worker_job_wait(worker_job_t *job, TickType_t wait);
+
+/**
+ * @brief Copy the pool counters.
+ */
+void worker_pool_get_stats(worker_pool_t *pool, worker_pool_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif